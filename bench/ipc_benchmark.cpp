@@ -0,0 +1,878 @@
+/**
+ * @file ipc_benchmark.cpp
+ * @brief IPC层吞吐与时延基准测试
+ *
+ * 启动一个 LocalSocket（或TCP）IPC服务端和N个模拟插件客户端（线程内或子进程），
+ * 按配置的比例混合驱动 sendMessage / broadcastMessage / publishToTopic / 心跳，
+ * 客户端把收到的每条基准消息立即回显，服务端据此统计：
+ *   - 每秒投递消息数、每秒出站字节数；
+ *   - 往返时延 p50/p99/p999（服务端发送 -> 客户端回显到达主线程）；
+ *   - 每条消息消耗的CPU时间。
+ * 结果以JSON输出，便于在版本之间对比和做部署容量评估。
+ *
+ * 示例：
+ *   ipc_benchmark --clients 100 --operations 200000 --payload 512 \
+ *                 --mix unicast=40,broadcast=5,publish=45,heartbeat=10 --output result.json
+ */
+
+#include "IIpcCommunication.h"
+#include "IpcFrameCodec.h"
+#include "IpcReceiveBuffer.h"
+#include "SharedMemoryChannel.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QLocalSocket>
+#include <QProcess>
+#include <QRandomGenerator>
+#include <QTcpSocket>
+#include <QThread>
+#include <QTimer>
+#include <QUuid>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+const QString kMasterId = QStringLiteral("bench_master");
+const QString kReadyTopic = QStringLiteral("bench_ready");
+
+/**
+ * @brief 基准操作类型
+ */
+enum class Operation {
+    kUnicast = 0,      // sendMessage 到单个客户端
+    kBroadcast,        // broadcastMessage 到全部客户端
+    kPublish,          // publishToTopic 到一个订阅分组
+    kHeartbeat,        // 心跳（小消息，单播）
+    kCount
+};
+
+constexpr int kOperationCount = static_cast<int>(Operation::kCount);
+
+const char* operationName(Operation op)
+{
+    switch (op) {
+        case Operation::kUnicast: return "unicast";
+        case Operation::kBroadcast: return "broadcast";
+        case Operation::kPublish: return "publish";
+        case Operation::kHeartbeat: return "heartbeat";
+        default: return "unknown";
+    }
+}
+
+qint64 nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+QString clientLogicalId(int index)
+{
+    return QStringLiteral("bench_client_%1").arg(index);
+}
+
+QString groupPattern(int group)
+{
+    return QStringLiteral("bench.g%1.*").arg(group);
+}
+
+QString groupTopic(int group)
+{
+    return QStringLiteral("bench.g%1.data").arg(group);
+}
+
+/**
+ * @brief 进程CPU时间（秒）
+ */
+struct CpuTimes {
+    double user_s = 0.0;
+    double system_s = 0.0;
+};
+
+CpuTimes processCpuTimes()
+{
+    CpuTimes times;
+#ifdef Q_OS_WIN
+    FILETIME creation, exit, kernel, user;
+    if (GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        auto toSeconds = [](const FILETIME& ft) {
+            ULARGE_INTEGER value;
+            value.LowPart = ft.dwLowDateTime;
+            value.HighPart = ft.dwHighDateTime;
+            return static_cast<double>(value.QuadPart) / 1e7;  // 100ns单位
+        };
+        times.user_s = toSeconds(user);
+        times.system_s = toSeconds(kernel);
+    }
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        times.user_s = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6;
+        times.system_s = usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+    }
+#endif
+    return times;
+}
+
+/**
+ * @brief 基准测试配置
+ */
+struct BenchConfig {
+    QString transport = QStringLiteral("local");  // local | tcp
+    QString mode = QStringLiteral("thread");      // thread | process
+    QString codec = QStringLiteral("json");       // 客户端在kHello中声明的编码
+    QString server_name;
+    quint16 port = 27600;
+    int clients = 8;
+    int operations = 20000;
+    int warmup = 1000;
+    int payload_bytes = 256;
+    int window = 512;          // 同时在途的投递数上限
+    int topic_groups = 4;      // 发布订阅分组数
+    int timeout_s = 120;
+    quint32 seed = 1;
+    std::array<int, kOperationCount> weights{{40, 10, 40, 10}};
+
+    int groupOf(int client_index) const { return client_index % topic_groups; }
+
+    bool parseMix(const QString& mix, QString* error)
+    {
+        std::array<int, kOperationCount> parsed{{0, 0, 0, 0}};
+        for (const QString& item : mix.split(QLatin1Char(','), Qt::SkipEmptyParts)) {
+            const QStringList kv = item.split(QLatin1Char('='));
+            bool ok = false;
+            const int weight = kv.size() == 2 ? kv.at(1).toInt(&ok) : 0;
+            int index = -1;
+            for (int i = 0; i < kOperationCount; ++i) {
+                if (kv.at(0).trimmed() == QLatin1String(operationName(static_cast<Operation>(i)))) {
+                    index = i;
+                }
+            }
+            if (!ok || weight < 0 || index < 0) {
+                *error = QStringLiteral("无效的mix项: %1").arg(item);
+                return false;
+            }
+            parsed[index] = weight;
+        }
+        if (std::all_of(parsed.begin(), parsed.end(), [](int w) { return w == 0; })) {
+            *error = QStringLiteral("mix中至少需要一个非零权重");
+            return false;
+        }
+        weights = parsed;
+        return true;
+    }
+
+    QJsonObject toJson() const
+    {
+        QJsonObject mix;
+        for (int i = 0; i < kOperationCount; ++i) {
+            mix[operationName(static_cast<Operation>(i))] = weights[i];
+        }
+        QJsonObject json;
+        json["transport"] = transport;
+        json["mode"] = mode;
+        json["codec"] = codec;
+        json["clients"] = clients;
+        json["operations"] = operations;
+        json["warmup"] = warmup;
+        json["payload_bytes"] = payload_bytes;
+        json["window"] = window;
+        json["topic_groups"] = topic_groups;
+        json["seed"] = static_cast<qint64>(seed);
+        json["mix"] = mix;
+        return json;
+    }
+};
+
+/**
+ * @brief 模拟插件客户端
+ *
+ * 完成kHello握手并订阅所在分组的通配Topic后发出 bench_ready，此后把
+ * 收到的每条 bench.* 消息以小消息回显（保留msg_id和sent_ns）。
+ */
+class BenchClient : public QObject {
+public:
+    BenchClient(const BenchConfig& config, int index, std::function<void()> on_finished)
+        : config_(config), index_(index), sender_id_(clientLogicalId(index)),
+          on_finished_(std::move(on_finished))
+    {
+    }
+
+    void start()
+    {
+        if (config_.transport == QLatin1String("tcp")) {
+            auto* socket = new QTcpSocket(this);
+            socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+            connect(socket, &QTcpSocket::connected, this, [this] { onConnected(); });
+            connect(socket, &QTcpSocket::disconnected, this, [this] { finish(); });
+            connect(socket, &QTcpSocket::errorOccurred, this, [this, socket] {
+                if (socket->error() != QAbstractSocket::RemoteHostClosedError) {
+                    fprintf(stderr, "[ipc_benchmark] 客户端%d连接错误: %s\n", index_,
+                            qPrintable(socket->errorString()));
+                }
+                finish();
+            });
+            socket_ = socket;
+            socket->connectToHost(QStringLiteral("127.0.0.1"), config_.port);
+        } else {
+            auto* socket = new QLocalSocket(this);
+            connect(socket, &QLocalSocket::connected, this, [this] { onConnected(); });
+            connect(socket, &QLocalSocket::disconnected, this, [this] { finish(); });
+            connect(socket, &QLocalSocket::errorOccurred, this, [this, socket] {
+                if (socket->error() != QLocalSocket::PeerClosedError) {
+                    fprintf(stderr, "[ipc_benchmark] 客户端%d连接错误: %s\n", index_,
+                            qPrintable(socket->errorString()));
+                }
+                finish();
+            });
+            socket_ = socket;
+            socket->connectToServer(config_.server_name);
+        }
+        connect(socket_, &QIODevice::readyRead, this, [this] { onReadyRead(); });
+    }
+
+private:
+    void onConnected()
+    {
+        IpcMessage hello;
+        hello.type = MessageType::kHello;
+        hello.topic = QStringLiteral("hello");
+        hello.msg_id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        hello.timestamp = QDateTime::currentMSecsSinceEpoch();
+        hello.sender_id = sender_id_;
+        hello.receiver_id = kMasterId;
+        QJsonArray codecs;
+        if (config_.codec == QLatin1String("cbor")) {
+            codecs.append(QStringLiteral("cbor"));
+        }
+        codecs.append(QStringLiteral("json"));
+        hello.body["codecs"] = codecs;
+        send(hello);
+    }
+
+    void onHelloAck(const IpcMessage& ack)
+    {
+        codec_ = IpcFrameCodec::codecFromName(ack.body.value("codec").toString());
+
+        IpcMessage subscribe;
+        subscribe.type = MessageType::kCommand;
+        subscribe.topic = QStringLiteral("subscribe_topic");
+        subscribe.msg_id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        subscribe.sender_id = sender_id_;
+        subscribe.receiver_id = kMasterId;
+        subscribe.body["topic"] = groupPattern(config_.groupOf(index_));
+        send(subscribe);
+
+        // 同一连接上的帧按序处理，服务端收到ready时订阅已经生效
+        IpcMessage ready;
+        ready.type = MessageType::kStatusReport;
+        ready.topic = kReadyTopic;
+        ready.msg_id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        ready.sender_id = sender_id_;
+        ready.receiver_id = kMasterId;
+        send(ready);
+    }
+
+    void onReadyRead()
+    {
+        if (buffer_.readFrom(socket_) <= 0) {
+            return;
+        }
+        const QByteArrayView pending = buffer_.readable();
+        qsizetype offset = 0;
+        while (offset < pending.size()) {
+            if (static_cast<quint8>(pending.at(offset)) == SharedMemoryChannel::kDoorbellByte) {
+                ++offset;
+                continue;
+            }
+            IpcMessage message;
+            qsizetype consumed = 0;
+            const auto status = IpcFrameCodec::decode(pending.sliced(offset), &message, &consumed);
+            if (status == IpcFrameCodec::DecodeStatus::kNeedMoreData) {
+                break;
+            }
+            offset += consumed;
+            if (status == IpcFrameCodec::DecodeStatus::kOk) {
+                handleMessage(message);
+            }
+        }
+        buffer_.consume(offset);
+    }
+
+    void handleMessage(const IpcMessage& message)
+    {
+        if (message.type == MessageType::kHelloAck) {
+            onHelloAck(message);
+            return;
+        }
+        if (!message.topic.startsWith(QLatin1String("bench."))) {
+            return;
+        }
+
+        IpcMessage echo;
+        echo.type = message.type == MessageType::kHeartbeat ? MessageType::kHeartbeatAck
+                                                            : MessageType::kCommandResponse;
+        echo.topic = message.topic;
+        echo.msg_id = message.msg_id;
+        echo.sender_id = sender_id_;
+        echo.receiver_id = kMasterId;
+        echo.body["sent_ns"] = message.body.value("sent_ns");
+        send(echo);
+    }
+
+    void send(const IpcMessage& message)
+    {
+        if (socket_) {
+            socket_->write(IpcFrameCodec::encode(message, codec_));
+        }
+    }
+
+    void finish()
+    {
+        if (finished_) {
+            return;
+        }
+        finished_ = true;
+        if (on_finished_) {
+            on_finished_();
+        }
+    }
+
+    const BenchConfig config_;
+    const int index_;
+    const QString sender_id_;
+    std::function<void()> on_finished_;
+    QIODevice* socket_ = nullptr;
+    IpcReceiveBuffer buffer_;
+    IpcCodecType codec_ = IpcCodecType::kJson;  // kHelloAck之前总用JSON
+    bool finished_ = false;
+};
+
+/**
+ * @brief 时延样本汇总
+ */
+QJsonObject summarizeLatency(std::vector<qint64> samples_ns)
+{
+    QJsonObject json;
+    json["samples"] = static_cast<qint64>(samples_ns.size());
+    if (samples_ns.empty()) {
+        return json;
+    }
+    std::sort(samples_ns.begin(), samples_ns.end());
+    auto percentile = [&samples_ns](double q) {
+        const size_t index = std::min(samples_ns.size() - 1,
+                                      static_cast<size_t>(q * static_cast<double>(samples_ns.size())));
+        return samples_ns[index] / 1000.0;
+    };
+    double sum = 0.0;
+    for (qint64 sample : samples_ns) {
+        sum += static_cast<double>(sample);
+    }
+    json["min_us"] = samples_ns.front() / 1000.0;
+    json["mean_us"] = sum / static_cast<double>(samples_ns.size()) / 1000.0;
+    json["p50_us"] = percentile(0.50);
+    json["p99_us"] = percentile(0.99);
+    json["p999_us"] = percentile(0.999);
+    json["max_us"] = samples_ns.back() / 1000.0;
+    return json;
+}
+
+/**
+ * @brief 服务端驱动：创建IPC策略、拉起客户端、按窗口发出操作并统计结果
+ */
+class BenchRunner : public QObject {
+public:
+    explicit BenchRunner(const BenchConfig& config) : config_(config), random_(config.seed) {}
+
+    ~BenchRunner() override { stopClients(); }
+
+    bool start(QString* error)
+    {
+        QJsonObject ipc_config;
+        IpcType type = IpcType::kLocalSocket;
+        if (config_.transport == QLatin1String("tcp")) {
+            type = IpcType::kTcpSocket;
+            QJsonObject tcp_socket;
+            tcp_socket["bind_addresses"] = QJsonArray{QStringLiteral("127.0.0.1")};
+            tcp_socket["port"] = config_.port;
+            tcp_socket["no_delay"] = true;
+            // 基准测试一次性拉起全部客户端，不做连接数与速率限制
+            tcp_socket["max_connections"] = 0;
+            tcp_socket["accept_rate_per_second"] = 0;
+            ipc_config["tcp_socket"] = tcp_socket;
+        } else {
+            QJsonObject local_socket;
+            local_socket["server_name"] = config_.server_name;
+            local_socket["max_connections"] = 0;
+            local_socket["accept_rate_per_second"] = 0;
+            ipc_config["local_socket"] = local_socket;
+        }
+
+        strategy_ = IpcCommunicationFactory::createIpcCommunication(type, ipc_config);
+        if (!strategy_ || !strategy_->start()) {
+            *error = strategy_ ? strategy_->getLastError() : QStringLiteral("创建IPC策略失败");
+            return false;
+        }
+        connect(strategy_.get(), &IIpcCommunication::messageReceived, this,
+                [this](const IpcMessage& message) { onMessage(message); });
+
+        for (int i = 0; i < config_.clients; ++i) {
+            ++group_sizes_[config_.groupOf(i)];
+        }
+        buildTemplates();
+        launchClients();
+
+        QTimer::singleShot(config_.timeout_s * 1000, this, [this] {
+            fprintf(stderr, "[ipc_benchmark] 超时，已完成%lld/%d个操作\n",
+                    static_cast<long long>(completed_ops_), config_.warmup + config_.operations);
+            finish(true);
+        });
+        return true;
+    }
+
+    /**
+     * @brief 结果报告，事件循环退出后有效
+     */
+    const QJsonObject& report() const { return report_; }
+
+private:
+    struct PendingOp {
+        Operation op = Operation::kUnicast;
+        qint64 sent_ns = 0;
+        int remaining = 0;      // 尚未回显的接收者数
+        bool measured = false;  // 预热阶段的操作不计入结果
+    };
+
+    void launchClients()
+    {
+        if (config_.mode == QLatin1String("process")) {
+            for (int i = 0; i < config_.clients; ++i) {
+                auto* process = new QProcess(this);
+                process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+                process->start(QCoreApplication::applicationFilePath(),
+                               {QStringLiteral("--client-index"), QString::number(i),
+                                QStringLiteral("--transport"), config_.transport,
+                                QStringLiteral("--server-name"), config_.server_name,
+                                QStringLiteral("--port"), QString::number(config_.port),
+                                QStringLiteral("--codec"), config_.codec,
+                                QStringLiteral("--topic-groups"), QString::number(config_.topic_groups)});
+                processes_.push_back(process);
+            }
+            return;
+        }
+
+        for (int i = 0; i < config_.clients; ++i) {
+            auto* thread = new QThread(this);
+            auto* client = new BenchClient(config_, i, nullptr);
+            client->moveToThread(thread);
+            connect(thread, &QThread::finished, client, &QObject::deleteLater);
+            thread->start();
+            QMetaObject::invokeMethod(client, [client] { client->start(); }, Qt::QueuedConnection);
+            threads_.push_back(thread);
+        }
+    }
+
+    void stopClients()
+    {
+        for (QThread* thread : threads_) {
+            thread->quit();
+            thread->wait();
+        }
+        threads_.clear();
+        for (QProcess* process : processes_) {
+            if (!process->waitForFinished(3000)) {
+                process->kill();
+                process->waitForFinished(1000);
+            }
+        }
+        processes_.clear();
+    }
+
+    void buildTemplates()
+    {
+        const QString payload(config_.payload_bytes, QLatin1Char('x'));
+        const IpcCodecType codec = IpcFrameCodec::codecFromName(config_.codec);
+        for (int i = 0; i < kOperationCount; ++i) {
+            const auto op = static_cast<Operation>(i);
+            IpcMessage& message = templates_[i];
+            message.type = op == Operation::kHeartbeat ? MessageType::kHeartbeat : MessageType::kCommand;
+            message.sender_id = kMasterId;
+            if (op != Operation::kHeartbeat) {
+                message.body["payload"] = payload;
+            }
+            message.body["sent_ns"] = nowNs();
+            message.topic = op == Operation::kPublish ? groupTopic(0)
+                                                      : QStringLiteral("bench.%1").arg(operationName(op));
+            message.msg_id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+            message.receiver_id = clientLogicalId(0);
+            frame_bytes_[i] = IpcFrameCodec::encode(message, codec).size();
+        }
+    }
+
+    void onMessage(const IpcMessage& message)
+    {
+        switch (message.type) {
+            case MessageType::kHello: {
+                IpcMessage ack;
+                ack.type = MessageType::kHelloAck;
+                ack.topic = message.topic;
+                ack.msg_id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+                ack.timestamp = QDateTime::currentMSecsSinceEpoch();
+                ack.sender_id = kMasterId;
+                ack.receiver_id = message.sender_id;
+                strategy_->sendMessage(ack);
+                return;
+            }
+            case MessageType::kStatusReport:
+                if (message.topic == kReadyTopic && ++ready_clients_ == config_.clients) {
+                    fprintf(stderr, "[ipc_benchmark] %d个客户端就绪，开始预热\n", config_.clients);
+                    pump();
+                }
+                return;
+            case MessageType::kCommandResponse:
+            case MessageType::kHeartbeatAck:
+                onEcho(message);
+                return;
+            default:
+                return;
+        }
+    }
+
+    void onEcho(const IpcMessage& message)
+    {
+        const qint64 now = nowNs();
+        auto it = pending_.find(message.msg_id);
+        if (it == pending_.end()) {
+            return;
+        }
+        PendingOp& pending = it.value();
+        --in_flight_;
+        if (pending.measured) {
+            const qint64 latency = now - pending.sent_ns;
+            latencies_[static_cast<int>(pending.op)].push_back(latency);
+            ++deliveries_;
+        }
+        if (--pending.remaining == 0) {
+            pending_.erase(it);
+            ++completed_ops_;
+        }
+
+        if (!measuring_ && completed_ops_ == config_.warmup) {
+            beginMeasurement();
+        }
+        if (completed_ops_ == static_cast<qint64>(config_.warmup) + config_.operations) {
+            finish(false);
+            return;
+        }
+        pump();
+    }
+
+    void beginMeasurement()
+    {
+        measuring_ = true;
+        cpu_start_ = processCpuTimes();
+        elapsed_.start();
+        fprintf(stderr, "[ipc_benchmark] 预热完成，开始计时\n");
+    }
+
+    Operation pickOperation()
+    {
+        int total = 0;
+        for (int weight : config_.weights) {
+            total += weight;
+        }
+        int value = static_cast<int>(random_.bounded(total));
+        for (int i = 0; i < kOperationCount; ++i) {
+            if (value < config_.weights[i]) {
+                return static_cast<Operation>(i);
+            }
+            value -= config_.weights[i];
+        }
+        return Operation::kUnicast;
+    }
+
+    void pump()
+    {
+        const qint64 total_ops = static_cast<qint64>(config_.warmup) + config_.operations;
+        while (issued_ops_ < total_ops && in_flight_ < config_.window) {
+            // 预热阶段全部回显后再开始计时，避免两阶段混在一起
+            if (issued_ops_ == config_.warmup && !measuring_) {
+                if (in_flight_ > 0) {
+                    return;
+                }
+                beginMeasurement();
+            }
+            issue(pickOperation());
+        }
+    }
+
+    void issue(Operation op)
+    {
+        const int index = static_cast<int>(op);
+        IpcMessage message = templates_[index];
+        message.msg_id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+
+        PendingOp pending;
+        pending.op = op;
+        pending.measured = measuring_;
+        bool sent = false;
+
+        switch (op) {
+            case Operation::kUnicast:
+            case Operation::kHeartbeat:
+                message.receiver_id = clientLogicalId(next_client_);
+                next_client_ = (next_client_ + 1) % config_.clients;
+                pending.remaining = 1;
+                break;
+            case Operation::kBroadcast:
+                message.receiver_id.clear();
+                pending.remaining = config_.clients;
+                break;
+            case Operation::kPublish: {
+                // 跳过没有成员的分组
+                int group = static_cast<int>(random_.bounded(config_.topic_groups));
+                while (group_sizes_[group] == 0) {
+                    group = (group + 1) % config_.topic_groups;
+                }
+                message.topic = groupTopic(group);
+                message.receiver_id.clear();
+                pending.remaining = group_sizes_[group];
+                break;
+            }
+            default:
+                break;
+        }
+
+        pending.sent_ns = nowNs();
+        message.body["sent_ns"] = pending.sent_ns;
+        pending_.insert(message.msg_id, pending);
+        in_flight_ += pending.remaining;
+        ++issued_ops_;
+
+        switch (op) {
+            case Operation::kUnicast:
+            case Operation::kHeartbeat:
+                sent = strategy_->sendMessage(message);
+                break;
+            case Operation::kBroadcast:
+                sent = strategy_->broadcastMessage(message);
+                break;
+            case Operation::kPublish:
+                sent = strategy_->publishToTopic(message.topic, message);
+                break;
+            default:
+                break;
+        }
+
+        if (!sent) {
+            ++send_failures_;
+            in_flight_ -= pending.remaining;
+            pending_.remove(message.msg_id);
+            ++completed_ops_;
+            return;
+        }
+        if (pending.measured) {
+            ++op_counts_[index];
+            outbound_bytes_ += frame_bytes_[index] * pending.remaining;
+        }
+    }
+
+    void finish(bool timed_out)
+    {
+        if (finished_) {
+            return;
+        }
+        finished_ = true;
+
+        const double elapsed_s = measuring_ ? elapsed_.nsecsElapsed() / 1e9 : 0.0;
+        const CpuTimes cpu_end = processCpuTimes();
+        const double cpu_user = measuring_ ? cpu_end.user_s - cpu_start_.user_s : 0.0;
+        const double cpu_system = measuring_ ? cpu_end.system_s - cpu_start_.system_s : 0.0;
+
+        std::vector<qint64> all_latencies;
+        QJsonObject per_operation;
+        for (int i = 0; i < kOperationCount; ++i) {
+            QJsonObject entry;
+            entry["operations"] = static_cast<qint64>(op_counts_[i]);
+            entry["latency"] = summarizeLatency(latencies_[i]);
+            per_operation[operationName(static_cast<Operation>(i))] = entry;
+            all_latencies.insert(all_latencies.end(), latencies_[i].begin(), latencies_[i].end());
+        }
+
+        QJsonObject cpu;
+        cpu["user_s"] = cpu_user;
+        cpu["system_s"] = cpu_system;
+        cpu["us_per_message"] = deliveries_ > 0 ? (cpu_user + cpu_system) * 1e6 / deliveries_ : 0.0;
+        // 线程模式下CPU时间包含模拟客户端，进程模式下只含服务端
+        cpu["includes_clients"] = config_.mode != QLatin1String("process");
+
+        QJsonObject results;
+        results["timed_out"] = timed_out;
+        results["elapsed_s"] = elapsed_s;
+        results["deliveries"] = static_cast<qint64>(deliveries_);
+        results["lost_deliveries"] = static_cast<qint64>(in_flight_);
+        results["send_failures"] = static_cast<qint64>(send_failures_);
+        results["messages_per_sec"] = elapsed_s > 0 ? deliveries_ / elapsed_s : 0.0;
+        results["outbound_bytes"] = static_cast<qint64>(outbound_bytes_);
+        results["outbound_bytes_per_sec"] = elapsed_s > 0 ? outbound_bytes_ / elapsed_s : 0.0;
+        results["latency"] = summarizeLatency(std::move(all_latencies));
+        results["per_operation"] = per_operation;
+        results["cpu"] = cpu;
+
+        QJsonObject report;
+        report["benchmark"] = QStringLiteral("ipc");
+        report["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+        report["qt_version"] = QString::fromLatin1(qVersion());
+        report["config"] = config_.toJson();
+        report["results"] = results;
+        report["transport_statistics"] = strategy_->getStatistics();
+        report_ = report;
+
+        // 停止服务端会断开全部连接，客户端随之退出
+        strategy_->stop();
+        stopClients();
+        QCoreApplication::exit(timed_out ? 2 : 0);
+    }
+
+    const BenchConfig config_;
+    QRandomGenerator random_;
+    std::unique_ptr<IIpcCommunication> strategy_;
+    std::vector<QThread*> threads_;
+    std::vector<QProcess*> processes_;
+
+    std::array<IpcMessage, kOperationCount> templates_;
+    std::array<qint64, kOperationCount> frame_bytes_{};
+    std::array<std::vector<qint64>, kOperationCount> latencies_;
+    std::array<qint64, kOperationCount> op_counts_{};
+    QHash<int, int> group_sizes_;
+    QHash<QString, PendingOp> pending_;  // msg_id -> 在途操作
+
+    int ready_clients_ = 0;
+    int next_client_ = 0;
+    qint64 issued_ops_ = 0;
+    qint64 completed_ops_ = 0;
+    qint64 in_flight_ = 0;        // 尚未回显的投递数
+    qint64 deliveries_ = 0;       // 计时阶段完成的投递数
+    qint64 send_failures_ = 0;
+    qint64 outbound_bytes_ = 0;
+    bool measuring_ = false;
+    bool finished_ = false;
+    QElapsedTimer elapsed_;
+    CpuTimes cpu_start_;
+    QJsonObject report_;
+};
+
+void quietMessageHandler(QtMsgType type, const QMessageLogContext&, const QString& message)
+{
+    // IPC层的调试日志按消息打印，会严重干扰测量结果
+    if (type == QtDebugMsg || type == QtInfoMsg) {
+        return;
+    }
+    fprintf(stderr, "%s\n", qPrintable(message));
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("ipc_benchmark"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("JT_Studio IPC吞吐与时延基准测试"));
+    parser.addHelpOption();
+    const QCommandLineOption transport_option("transport", "传输方式: local | tcp", "name", "local");
+    const QCommandLineOption mode_option("mode", "客户端运行方式: thread | process", "mode", "thread");
+    const QCommandLineOption codec_option("codec", "客户端声明的编码: json | cbor", "codec", "json");
+    const QCommandLineOption clients_option("clients", "模拟客户端数量", "n", "8");
+    const QCommandLineOption operations_option("operations", "计时阶段的操作数", "n", "20000");
+    const QCommandLineOption warmup_option("warmup", "预热操作数", "n", "1000");
+    const QCommandLineOption payload_option("payload", "消息负载字节数", "bytes", "256");
+    const QCommandLineOption window_option("window", "在途投递数上限", "n", "512");
+    const QCommandLineOption groups_option("topic-groups", "发布订阅分组数", "n", "4");
+    const QCommandLineOption mix_option("mix", "操作比例，如 unicast=40,broadcast=10,publish=40,heartbeat=10",
+                                        "mix", "unicast=40,broadcast=10,publish=40,heartbeat=10");
+    const QCommandLineOption port_option("port", "TCP端口", "port", "27600");
+    const QCommandLineOption server_name_option("server-name", "本地socket服务名（默认按进程号生成）", "name");
+    const QCommandLineOption timeout_option("timeout", "超时时间（秒）", "s", "120");
+    const QCommandLineOption seed_option("seed", "随机种子", "n", "1");
+    const QCommandLineOption output_option("output", "结果JSON输出文件（默认stdout）", "file");
+    const QCommandLineOption verbose_option("verbose", "输出IPC层调试日志");
+    const QCommandLineOption client_index_option("client-index", "内部使用：以子进程客户端身份运行", "n");
+    parser.addOptions({transport_option, mode_option, codec_option, clients_option, operations_option,
+                       warmup_option, payload_option, window_option, groups_option, mix_option, port_option,
+                       server_name_option, timeout_option, seed_option, output_option, verbose_option,
+                       client_index_option});
+    parser.process(app);
+
+    if (!parser.isSet(verbose_option)) {
+        qInstallMessageHandler(quietMessageHandler);
+    }
+
+    BenchConfig config;
+    config.transport = parser.value(transport_option);
+    config.mode = parser.value(mode_option);
+    config.codec = parser.value(codec_option);
+    config.clients = std::max(1, parser.value(clients_option).toInt());
+    config.operations = std::max(1, parser.value(operations_option).toInt());
+    config.warmup = std::max(0, parser.value(warmup_option).toInt());
+    config.payload_bytes = std::max(0, parser.value(payload_option).toInt());
+    config.window = std::max(1, parser.value(window_option).toInt());
+    config.topic_groups = std::max(1, parser.value(groups_option).toInt());
+    config.port = static_cast<quint16>(parser.value(port_option).toUInt());
+    config.timeout_s = std::max(1, parser.value(timeout_option).toInt());
+    config.seed = parser.value(seed_option).toUInt();
+    config.server_name = parser.isSet(server_name_option)
+                             ? parser.value(server_name_option)
+                             : QStringLiteral("jt_ipc_bench_%1").arg(QCoreApplication::applicationPid());
+    QString error;
+    if (!config.parseMix(parser.value(mix_option), &error)) {
+        fprintf(stderr, "[ipc_benchmark] %s\n", qPrintable(error));
+        return 1;
+    }
+
+    // 子进程客户端：连接、回显，服务端断开后退出
+    if (parser.isSet(client_index_option)) {
+        BenchClient client(config, parser.value(client_index_option).toInt(), [] { QCoreApplication::quit(); });
+        client.start();
+        return app.exec();
+    }
+
+    BenchRunner runner(config);
+    if (!runner.start(&error)) {
+        fprintf(stderr, "[ipc_benchmark] 启动失败: %s\n", qPrintable(error));
+        return 1;
+    }
+    const int exit_code = app.exec();
+
+    const QByteArray json = QJsonDocument(runner.report()).toJson(QJsonDocument::Indented);
+    if (parser.isSet(output_option)) {
+        QFile file(parser.value(output_option));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            fprintf(stderr, "[ipc_benchmark] 无法写入 %s\n", qPrintable(file.fileName()));
+            return 1;
+        }
+        file.write(json);
+    } else {
+        fwrite(json.constData(), 1, static_cast<size_t>(json.size()), stdout);
+    }
+    return exit_code;
+}
@@ -0,0 +1,594 @@
+#include "MasterClient.h"
+#include "IpcRequestTracker.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QJsonArray>
+#include <QLocalSocket>
+#include <QMetaMethod>
+#include <QPromise>
+#include <QRandomGenerator>
+#include <QTcpSocket>
+#include <QUuid>
+
+namespace {
+    const QString kSubscribeTopic = QStringLiteral("subscribe_topic");
+    const QString kUnsubscribeTopic = QStringLiteral("unsubscribe_topic");
+    const QString kMigrateEndpoint = QStringLiteral("migrate_endpoint");
+}
+
+MasterClientConfig MasterClientConfig::fromJson(const QJsonObject& json)
+{
+    MasterClientConfig config;
+    config.server_name = json["server_name"].toString(config.server_name);
+    config.host = json["host"].toString(config.host);
+    config.port = static_cast<quint16>(json["port"].toInt(config.port));
+    config.client_id = json["client_id"].toString(config.client_id);
+    config.master_id = json["master_id"].toString(config.master_id);
+    if (json.contains("codecs")) {
+        config.codecs.clear();
+        for (const QJsonValue& codec : json["codecs"].toArray()) {
+            config.codecs.append(codec.toString());
+        }
+    }
+    config.heartbeat_interval_ms = json["heartbeat_interval_ms"].toInt(config.heartbeat_interval_ms);
+    config.liveness_timeout_ms = json["liveness_timeout_ms"].toInt(config.liveness_timeout_ms);
+    config.reconnect_initial_ms = qMax(10, json["reconnect_initial_ms"].toInt(config.reconnect_initial_ms));
+    config.reconnect_max_ms = qMax(config.reconnect_initial_ms,
+                                   json["reconnect_max_ms"].toInt(config.reconnect_max_ms));
+    config.batch_delay_ms = qMax(0, json["batch_delay_ms"].toInt(config.batch_delay_ms));
+    config.max_pending_messages = qMax(1, json["max_pending_messages"].toInt(config.max_pending_messages));
+    config.max_write_buffer_bytes = json["max_write_buffer_bytes"].toInteger(config.max_write_buffer_bytes);
+    return config;
+}
+
+MasterClient::MasterClient(const MasterClientConfig& config, QObject* parent)
+    : QObject(parent)
+    , config_(config)
+    , request_tracker_(std::make_unique<IpcRequestTracker>())
+{
+    if (config_.client_id.isEmpty()) {
+        config_.client_id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    }
+
+    reconnect_timer_.setSingleShot(true);
+    connect(&reconnect_timer_, &QTimer::timeout, this, &MasterClient::connectToMaster);
+
+    connect(&heartbeat_timer_, &QTimer::timeout, this, [this] {
+        checkLiveness();
+        if (isReady()) {
+            sendHeartbeat();
+        }
+    });
+
+    batch_timer_.setSingleShot(true);
+    connect(&batch_timer_, &QTimer::timeout, this, &MasterClient::flush);
+}
+
+MasterClient::~MasterClient()
+{
+    stop();
+}
+
+void MasterClient::start()
+{
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    reconnect_delay_ms_ = 0;
+    connectToMaster();
+}
+
+void MasterClient::stop()
+{
+    running_ = false;
+    reconnect_timer_.stop();
+    heartbeat_timer_.stop();
+    batch_timer_.stop();
+    if (socket_) {
+        flush();
+        QIODevice* socket = socket_;
+        socket_ = nullptr;
+        QObject::disconnect(socket, nullptr, this, nullptr);
+        socket->close();
+        socket->deleteLater();
+    }
+    write_buffer_.clear();
+    pending_.clear();
+    request_tracker_->failAll("客户端已停止");
+    setState(State::kDisconnected);
+}
+
+bool MasterClient::send(IpcMessage message)
+{
+    fillDefaults(&message);
+    if (state_ != State::kReady) {
+        if (static_cast<int>(pending_.size()) >= config_.max_pending_messages) {
+            ++messages_rejected_;
+            return false;
+        }
+        pending_.push_back(std::move(message));
+        return true;
+    }
+    return enqueueFrame(message, codec_);
+}
+
+bool MasterClient::send(MessageType type, const QString& topic, const QJsonObject& body,
+                        const QString& receiver_id)
+{
+    return send(makeMessage(type, topic, body, receiver_id));
+}
+
+QFuture<IpcRequestResult> MasterClient::request(const QString& topic, const QJsonObject& body, int timeout_ms,
+                                                const QString& receiver_id)
+{
+    IpcMessage message = makeMessage(MessageType::kCommand, topic, body, receiver_id);
+
+    // 先登记再发送，避免响应先于登记到达
+    QFuture<IpcRequestResult> future = request_tracker_->track(message.msg_id, topic, timeout_ms);
+    if (!send(message)) {
+        request_tracker_->fail(message.msg_id, "发送队列已满");
+    }
+    return future;
+}
+
+bool MasterClient::respond(const IpcMessage& command, bool success, const QJsonObject& body,
+                           const QString& error)
+{
+    QJsonObject response_body = body;
+    response_body["request_id"] = command.msg_id;
+    response_body["success"] = success;
+    if (!error.isEmpty()) {
+        response_body["error"] = error;
+    }
+    return send(MessageType::kCommandResponse, command.topic, response_body, command.sender_id);
+}
+
+bool MasterClient::subscribe(const QString& pattern)
+{
+    if (pattern.isEmpty() || subscriptions_.contains(pattern)) {
+        return false;
+    }
+    subscriptions_.insert(pattern);
+    // 未就绪时只登记，握手完成后统一发送
+    if (isReady()) {
+        enqueueFrame(makeMessage(MessageType::kCommand, kSubscribeTopic, QJsonObject{{"topic", pattern}},
+                                 QString()), codec_);
+    }
+    return true;
+}
+
+bool MasterClient::unsubscribe(const QString& pattern)
+{
+    if (!subscriptions_.remove(pattern)) {
+        return false;
+    }
+    if (isReady()) {
+        enqueueFrame(makeMessage(MessageType::kCommand, kUnsubscribeTopic, QJsonObject{{"topic", pattern}},
+                                 QString()), codec_);
+    }
+    return true;
+}
+
+QJsonObject MasterClient::statistics() const
+{
+    QJsonObject stats;
+    stats["client_id"] = config_.client_id;
+    stats["state"] = static_cast<int>(state_);
+    stats["codec"] = IpcFrameCodec::codecName(codec_);
+    stats["client_handle"] = static_cast<qint64>(client_handle_);
+    stats["messages_sent"] = static_cast<qint64>(messages_sent_);
+    stats["messages_received"] = static_cast<qint64>(messages_received_);
+    stats["bytes_sent"] = static_cast<qint64>(bytes_sent_);
+    stats["bytes_received"] = static_cast<qint64>(bytes_received_);
+    stats["writes"] = static_cast<qint64>(writes_);
+    stats["messages_rejected"] = static_cast<qint64>(messages_rejected_);
+    stats["reconnects"] = static_cast<qint64>(reconnects_);
+    stats["migrations"] = static_cast<qint64>(migrations_);
+    stats["heartbeat"] = QJsonObject{
+        {"compact", compact_heartbeat_},
+        {"sent", static_cast<qint64>(heartbeats_sent_)},
+        {"skipped", static_cast<qint64>(heartbeats_skipped_)},
+        {"rtt_ms", heartbeat_rtt_ms_}};
+    stats["pending_messages"] = static_cast<qint64>(pending_.size());
+    stats["write_buffer_bytes"] = static_cast<qint64>(write_buffer_.size());
+    stats["pending_requests"] = request_tracker_->pendingCount();
+    stats["subscriptions"] = QJsonArray::fromStringList(subscriptions());
+    return stats;
+}
+
+void MasterClient::connectToMaster()
+{
+    if (!running_ || socket_) {
+        return;
+    }
+    setState(State::kConnecting);
+    receive_buffer_.clear();
+    write_buffer_.clear();
+    codec_ = IpcCodecType::kJson;
+    compact_heartbeat_ = false;
+
+    if (!config_.host.isEmpty()) {
+        auto* socket = new QTcpSocket(this);
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        connect(socket, &QTcpSocket::connected, this, &MasterClient::onConnected);
+        connect(socket, &QTcpSocket::disconnected, this, &MasterClient::onDisconnected);
+        connect(socket, &QTcpSocket::errorOccurred, this, [this, socket] {
+            if (socket == socket_) {
+                onSocketError(socket->errorString());
+            }
+        });
+        socket_ = socket;
+        socket->connectToHost(config_.host, config_.port);
+    } else {
+        auto* socket = new QLocalSocket(this);
+        connect(socket, &QLocalSocket::connected, this, &MasterClient::onConnected);
+        connect(socket, &QLocalSocket::disconnected, this, &MasterClient::onDisconnected);
+        connect(socket, &QLocalSocket::errorOccurred, this, [this, socket] {
+            if (socket == socket_) {
+                onSocketError(socket->errorString());
+            }
+        });
+        socket_ = socket;
+        socket->connectToServer(config_.server_name);
+    }
+    connect(socket_, &QIODevice::readyRead, this, &MasterClient::onReadyRead);
+}
+
+void MasterClient::onConnected()
+{
+    setState(State::kHandshaking);
+    last_receive_.start();
+
+    // kHello 总以JSON发送，kHelloAck携带主控选定的编码
+    IpcMessage hello = makeMessage(MessageType::kHello, QStringLiteral("hello"), QJsonObject(), QString());
+    hello.body["codecs"] = QJsonArray::fromStringList(config_.codecs);
+    hello.body["process_name"] = config_.client_id;
+    hello.body["heartbeat"] = QStringLiteral("compact");
+    enqueueFrame(hello, IpcCodecType::kJson);
+
+    if (config_.heartbeat_interval_ms > 0) {
+        heartbeat_timer_.start(config_.heartbeat_interval_ms);
+    }
+}
+
+void MasterClient::onDisconnected()
+{
+    if (!socket_) {
+        return;
+    }
+    QIODevice* socket = socket_;
+    socket_ = nullptr;
+    QObject::disconnect(socket, nullptr, this, nullptr);
+    socket->deleteLater();
+
+    heartbeat_timer_.stop();
+    batch_timer_.stop();
+    flush_scheduled_ = false;
+    write_buffer_.clear();
+    client_handle_ = 0;
+    // 主控不会再应答断开前发出的请求
+    request_tracker_->failAll("与主控的连接已断开");
+
+    const bool was_connected = state_ == State::kHandshaking || state_ == State::kReady;
+    setState(State::kDisconnected);
+    if (was_connected) {
+        qWarning() << "[MasterClient] 与主控的连接已断开:" << config_.client_id;
+        emit disconnected();
+    }
+    scheduleReconnect();
+}
+
+void MasterClient::onReadyRead()
+{
+    const qint64 bytes = receive_buffer_.readFrom(socket_);
+    if (bytes <= 0) {
+        return;
+    }
+    bytes_received_ += static_cast<quint64>(bytes);
+    last_receive_.start();
+
+    const QByteArrayView data = receive_buffer_.readable();
+    qsizetype offset = 0;
+    while (offset < data.size() && socket_) {
+        IpcMessage message;
+        qsizetype consumed = 0;
+        const IpcFrameCodec::DecodeStatus status = IpcFrameCodec::decode(data.sliced(offset), &message, &consumed);
+        if (status == IpcFrameCodec::DecodeStatus::kNeedMoreData) {
+            break;
+        }
+        offset += consumed;
+        if (status == IpcFrameCodec::DecodeStatus::kOk) {
+            ++messages_received_;
+            handleMessage(message);
+        }
+    }
+    // 消息处理中可能已断开并清空缓冲区
+    if (socket_) {
+        receive_buffer_.consume(offset);
+    }
+}
+
+void MasterClient::onSocketError(const QString& error)
+{
+    qWarning() << "[MasterClient] 连接错误:" << error;
+    emit errorOccurred(error);
+
+    // 连接阶段失败不会发出disconnected，这里统一按断开处理
+    const bool connected = socket_ && socket_->isOpen();
+    if (!connected) {
+        onDisconnected();
+    }
+}
+
+void MasterClient::handleMessage(const IpcMessage& message)
+{
+    switch (message.type) {
+        case MessageType::kHelloAck:
+            handleHelloAck(message);
+            return;
+        case MessageType::kHeartbeatAck:
+            // 紧凑心跳应答的timestamp是回显的发送时间
+            if (compact_heartbeat_ && message.timestamp > 0) {
+                heartbeat_rtt_ms_ = QDateTime::currentMSecsSinceEpoch() - message.timestamp;
+            }
+            return;
+        case MessageType::kCommand:
+            if (message.topic == kMigrateEndpoint) {
+                handleMigrateEndpoint(message);
+                return;
+            }
+            break;
+        case MessageType::kCommandResponse:
+            if (request_tracker_->complete(message)) {
+                return;
+            }
+            break;
+        case MessageType::kShutdown:
+            handleShutdown(message);
+            return;
+        default:
+            break;
+    }
+    emit messageReceived(message);
+}
+
+void MasterClient::handleHelloAck(const IpcMessage& ack)
+{
+    codec_ = IpcFrameCodec::codecFromName(ack.body.value("codec").toString());
+    client_handle_ = static_cast<quint32>(ack.body.value("client_handle").toInteger());
+    compact_heartbeat_ = ack.body.value("heartbeat").toString() == QLatin1String("compact");
+    reconnect_delay_ms_ = 0;
+    setState(State::kReady);
+    qDebug() << "[MasterClient]" << config_.client_id << "握手完成，编码:" << IpcFrameCodec::codecName(codec_)
+             << "句柄:" << client_handle_;
+
+    // 先恢复订阅，再按序写出断线期间积压的消息
+    for (const QString& pattern : std::as_const(subscriptions_)) {
+        enqueueFrame(makeMessage(MessageType::kCommand, kSubscribeTopic, QJsonObject{{"topic", pattern}},
+                                 QString()), codec_);
+    }
+    while (!pending_.empty() && isReady()) {
+        if (!enqueueFrame(pending_.front(), codec_)) {
+            break;
+        }
+        pending_.pop_front();
+    }
+    emit ready(client_handle_);
+}
+
+void MasterClient::handleShutdown(const IpcMessage& notice)
+{
+    const int deadline_ms = notice.body.value("deadline_ms").toInt();
+    qDebug() << "[MasterClient]" << config_.client_id << "收到关闭通知，期限:" << deadline_ms << "ms";
+
+    // 应答立即写出，主控据此改为等待进程自行退出
+    enqueueFrame(makeMessage(MessageType::kShutdown, QStringLiteral("shutdown_ack"),
+                             QJsonObject{{"request_id", notice.msg_id}}, QString()), codec_);
+    flush();
+
+    if (isSignalConnected(QMetaMethod::fromSignal(&MasterClient::shutdownRequested))) {
+        emit shutdownRequested(deadline_ms);
+    } else {
+        QCoreApplication::quit();
+    }
+}
+
+void MasterClient::handleMigrateEndpoint(const IpcMessage& command)
+{
+    const QString transport = command.body.value("transport").toString();
+    if (transport == QLatin1String("local_socket")) {
+        const QString server_name = command.body.value("server_name").toString();
+        if (server_name.isEmpty()) {
+            qWarning() << "[MasterClient] 迁移命令缺少server_name，忽略";
+            return;
+        }
+        config_.host.clear();
+        config_.server_name = server_name;
+    } else if (transport == QLatin1String("tcp_socket")) {
+        const quint16 port = static_cast<quint16>(command.body.value("port").toInt());
+        if (port == 0) {
+            qWarning() << "[MasterClient] 迁移命令中的port无效，忽略";
+            return;
+        }
+        // 主控监听所有网卡时不下发host，沿用当前主机
+        const QString host = command.body.value("host").toString();
+        if (!host.isEmpty()) {
+            config_.host = host;
+        } else if (config_.host.isEmpty()) {
+            config_.host = QStringLiteral("127.0.0.1");
+        }
+        config_.port = port;
+    } else {
+        qWarning() << "[MasterClient] 不支持的迁移传输类型:" << transport;
+        return;
+    }
+    qDebug() << "[MasterClient]" << config_.client_id << "迁移到新端点:" << command.body.object();
+    ++migrations_;
+
+    // 已编码的帧先写到旧连接，旧连接在内核缓冲写完后关闭
+    flush();
+    if (socket_) {
+        QIODevice* socket = socket_;
+        socket_ = nullptr;
+        QObject::disconnect(socket, nullptr, this, nullptr);
+        if (auto* local = qobject_cast<QLocalSocket*>(socket)) {
+            connect(local, &QLocalSocket::disconnected, local, &QObject::deleteLater);
+            local->disconnectFromServer();
+        } else if (auto* tcp = qobject_cast<QTcpSocket*>(socket)) {
+            connect(tcp, &QTcpSocket::disconnected, tcp, &QObject::deleteLater);
+            tcp->disconnectFromHost();
+        } else {
+            socket->deleteLater();
+        }
+    }
+
+    // 未完成的请求继续等待：主控会把响应发往新连接
+    heartbeat_timer_.stop();
+    batch_timer_.stop();
+    flush_scheduled_ = false;
+    write_buffer_.clear();
+    client_handle_ = 0;
+    reconnect_timer_.stop();
+    reconnect_delay_ms_ = 0;
+    setState(State::kDisconnected);
+    connectToMaster();
+}
+
+void MasterClient::scheduleReconnect()
+{
+    if (!running_ || reconnect_timer_.isActive()) {
+        return;
+    }
+    reconnect_delay_ms_ = reconnect_delay_ms_ == 0
+        ? config_.reconnect_initial_ms
+        : qMin(reconnect_delay_ms_ * 2, config_.reconnect_max_ms);
+    // 加入随机抖动，避免主控重启后所有插件同时重连
+    const int jitter = QRandomGenerator::global()->bounded(reconnect_delay_ms_ / 5 + 1);
+    ++reconnects_;
+    reconnect_timer_.start(reconnect_delay_ms_ + jitter);
+}
+
+void MasterClient::setState(State state)
+{
+    if (state_ != state) {
+        state_ = state;
+        emit stateChanged(state);
+    }
+}
+
+void MasterClient::sendHeartbeat()
+{
+    // 主控把任何入站数据都视为心跳；本周期内已发出业务消息且收到过主控数据时无需再发
+    if (last_activity_.isValid() && last_activity_.elapsed() < config_.heartbeat_interval_ms &&
+        last_receive_.elapsed() < config_.heartbeat_interval_ms) {
+        ++heartbeats_skipped_;
+        return;
+    }
+
+    ++heartbeats_sent_;
+    if (!compact_heartbeat_) {
+        enqueueFrame(makeMessage(MessageType::kHeartbeat, QStringLiteral("heartbeat"),
+                                 QJsonObject{{"process_name", config_.client_id}}, QString()), codec_);
+        return;
+    }
+
+    if (!socket_ || socket_->bytesToWrite() + write_buffer_.size() > config_.max_write_buffer_bytes) {
+        return;
+    }
+    IpcFrameCodec::Heartbeat heartbeat;
+    heartbeat.sequence = ++heartbeat_sequence_;
+    heartbeat.timestamp = QDateTime::currentMSecsSinceEpoch();
+    write_buffer_.append(IpcFrameCodec::encodeHeartbeat(heartbeat));
+    scheduleFlush();
+}
+
+void MasterClient::checkLiveness()
+{
+    if (!socket_ || config_.liveness_timeout_ms <= 0 || !last_receive_.isValid()) {
+        return;
+    }
+    if (last_receive_.elapsed() > config_.liveness_timeout_ms) {
+        qWarning() << "[MasterClient]" << config_.liveness_timeout_ms << "ms内未收到主控数据，重新连接";
+        onDisconnected();
+    }
+}
+
+bool MasterClient::enqueueFrame(const IpcMessage& message, IpcCodecType codec)
+{
+    if (!socket_) {
+        ++messages_rejected_;
+        return false;
+    }
+    if (socket_->bytesToWrite() + write_buffer_.size() > config_.max_write_buffer_bytes) {
+        ++messages_rejected_;
+        return false;
+    }
+    write_buffer_.append(IpcFrameCodec::encode(message, codec));
+    ++messages_sent_;
+    if (message.type != MessageType::kHeartbeat) {
+        last_activity_.start();
+    }
+    scheduleFlush();
+    return true;
+}
+
+void MasterClient::scheduleFlush()
+{
+    if (config_.batch_delay_ms > 0) {
+        if (!batch_timer_.isActive()) {
+            batch_timer_.start(config_.batch_delay_ms);
+        }
+        return;
+    }
+    if (!flush_scheduled_) {
+        flush_scheduled_ = true;
+        QMetaObject::invokeMethod(this, &MasterClient::flush, Qt::QueuedConnection);
+    }
+}
+
+void MasterClient::flush()
+{
+    flush_scheduled_ = false;
+    if (!socket_ || write_buffer_.isEmpty()) {
+        return;
+    }
+    const qint64 written = socket_->write(write_buffer_);
+    if (written < 0) {
+        onSocketError(socket_->errorString());
+        return;
+    }
+    bytes_sent_ += static_cast<quint64>(written);
+    ++writes_;
+    write_buffer_.clear();
+}
+
+void MasterClient::fillDefaults(IpcMessage* message) const
+{
+    if (message->sender_id.isEmpty()) {
+        message->sender_id = config_.client_id;
+    }
+    if (message->receiver_id.isEmpty()) {
+        message->receiver_id = config_.master_id;
+    }
+    if (message->msg_id.isEmpty()) {
+        message->msg_id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    }
+    if (message->timestamp == 0) {
+        message->timestamp = QDateTime::currentMSecsSinceEpoch();
+    }
+}
+
+IpcMessage MasterClient::makeMessage(MessageType type, const QString& topic, const QJsonObject& body,
+                                     const QString& receiver_id) const
+{
+    IpcMessage message;
+    message.type = type;
+    message.topic = topic;
+    message.timestamp = 0;
+    message.receiver_id = receiver_id;
+    message.body = body;
+    fillDefaults(&message);
+    return message;
+}
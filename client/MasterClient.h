@@ -0,0 +1,237 @@
+#ifndef MASTER_CLIENT_MASTERCLIENT_H_
+#define MASTER_CLIENT_MASTERCLIENT_H_
+
+#include "IIpcCommunication.h"
+#include "IpcFrameCodec.h"
+#include "IpcReceiveBuffer.h"
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QJsonObject>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <deque>
+#include <memory>
+
+class QIODevice;
+class IpcRequestTracker;
+
+/**
+ * @brief 插件客户端配置
+ *
+ * fromJson 读取的字段与成员同名，如 {"server_name": "...", "client_id": "...",
+ * "heartbeat_interval_ms": 5000}。
+ */
+struct MasterClientConfig {
+    QString server_name = QStringLiteral("master_ipc_server"); // 本地socket名称
+    QString host;                           // 非空时改用TCP连接 host:port
+    quint16 port = 0;
+    QString client_id;                      // 逻辑ID，作为所有消息的sender_id
+    QString master_id = QStringLiteral("main_controller"); // 发给主控的消息的receiver_id
+    QStringList codecs = {QStringLiteral("cbor"), QStringLiteral("json")}; // 握手时提供的编码（按优先级）
+    int heartbeat_interval_ms = 5000;       // 心跳间隔，0表示不发心跳（有业务流量时自动跳过）
+    int liveness_timeout_ms = 15000;        // 超过该时间没有收到任何数据视为连接失效，0表示不检查
+    int reconnect_initial_ms = 200;         // 首次重连延迟
+    int reconnect_max_ms = 10000;           // 重连延迟上限（指数退避）
+    int batch_delay_ms = 0;                 // 合并写出的等待时间，0表示在本轮事件循环结束时写出
+    int max_pending_messages = 10000;       // 未就绪（断线、握手中）时缓存的消息数上限
+    qint64 max_write_buffer_bytes = 16 * 1024 * 1024; // socket发送缓冲积压上限，超过时拒绝新消息
+
+    static MasterClientConfig fromJson(const QJsonObject& json);
+};
+
+/**
+ * @brief 插件进程的主控IPC客户端
+ *
+ * 实现与 StreamIpcCommunication 对端一致的协议：kHello握手与编码协商
+ * （JSON / CBOR二进制帧）、定时心跳、subscribe_topic / unsubscribe_topic
+ * 订阅命令、按 body.request_id 关联的请求/响应。
+ *
+ * - 发送全部异步：消息编码后追加到批量写缓冲，同一轮事件循环（或
+ *   batch_delay_ms 内）的多条消息合并为一次write；未就绪时缓存在待发队列，
+ *   握手完成后按序写出
+ * - 连接断开或长时间收不到数据时按指数退避自动重连，重连后重新握手并
+ *   恢复全部订阅
+ * - 主控支持时心跳改用16字节的紧凑心跳帧；一个心跳周期内已发出业务消息
+ *   且收到过主控数据时跳过该次心跳
+ * - 收到的帧在接收缓冲区上原地解码，消息体按需解析
+ * - 主控切换IPC策略时下发 migrate_endpoint 命令，客户端立即（不退避）以同一
+ *   逻辑ID重连到新端点；订阅与待发队列保留，握手后照常恢复
+ * - 收到主控的kShutdown时立即应答，再发出shutdownRequested由插件自行收尾退出；
+ *   没有连接该信号时直接退出事件循环
+ *
+ * 仅在所属线程使用。
+ */
+class MasterClient : public QObject {
+    Q_OBJECT
+
+public:
+    enum class State {
+        kDisconnected = 0,   // 未连接（已停止或等待重连）
+        kConnecting,         // 正在连接
+        kHandshaking,        // 已连接，等待kHelloAck
+        kReady               // 握手完成，可以收发
+    };
+    Q_ENUM(State)
+
+    explicit MasterClient(const MasterClientConfig& config, QObject* parent = nullptr);
+    ~MasterClient() override;
+
+    /**
+     * @brief 开始连接主控，此后断线自动重连
+     */
+    void start();
+
+    /**
+     * @brief 断开连接并停止重连，等待中的请求以失败结束
+     */
+    void stop();
+
+    State state() const { return state_; }
+    bool isReady() const { return state_ == State::kReady; }
+    IpcCodecType codec() const { return codec_; }
+    const MasterClientConfig& config() const { return config_; }
+
+    /**
+     * @brief 发送消息
+     *
+     * 空的 sender_id / msg_id / timestamp / receiver_id 会自动填充。
+     * @return 已排队返回true；待发队列或发送缓冲已满时返回false
+     */
+    bool send(IpcMessage message);
+
+    /**
+     * @brief 构造并发送一条消息
+     * @param receiver_id 接收者逻辑ID，空表示主控
+     */
+    bool send(MessageType type, const QString& topic, const QJsonObject& body,
+              const QString& receiver_id = QString());
+
+    /**
+     * @brief 发送命令并等待响应
+     * @param topic 命令名称
+     * @param body 命令参数
+     * @param timeout_ms 超时时间
+     * @param receiver_id 接收者逻辑ID，空表示主控
+     * @return 在响应到达、超时或发送失败时完成
+     */
+    QFuture<IpcRequestResult> request(const QString& topic, const QJsonObject& body, int timeout_ms,
+                                      const QString& receiver_id = QString());
+
+    /**
+     * @brief 应答收到的命令（body.request_id 取命令的msg_id）
+     */
+    bool respond(const IpcMessage& command, bool success, const QJsonObject& body = QJsonObject(),
+                 const QString& error = QString());
+
+    /**
+     * @brief 订阅Topic，模式可含 '*' / '#'；重连后自动恢复
+     */
+    bool subscribe(const QString& pattern);
+    bool unsubscribe(const QString& pattern);
+    QStringList subscriptions() const { return subscriptions_.values(); }
+
+    /**
+     * @brief 收发计数与连接状态
+     */
+    QJsonObject statistics() const;
+
+signals:
+    void stateChanged(MasterClient::State state);
+
+    /**
+     * @brief 握手完成（每次重连后都会发出）
+     * @param client_handle 主控分配的连接句柄
+     */
+    void ready(quint32 client_handle);
+
+    void disconnected();
+
+    /**
+     * @brief 收到消息（心跳确认与已关联到请求的响应除外）
+     */
+    void messageReceived(const IpcMessage& message);
+
+    void errorOccurred(const QString& error);
+
+    /**
+     * @brief 主控要求插件退出，应答已发出
+     * @param deadline_ms 主控等待退出的毫秒数，超时后强制终止进程
+     */
+    void shutdownRequested(int deadline_ms);
+
+private:
+    void connectToMaster();
+    void onConnected();
+    void onDisconnected();
+    void onReadyRead();
+    void onSocketError(const QString& error);
+    void handleMessage(const IpcMessage& message);
+    void handleHelloAck(const IpcMessage& ack);
+
+    /**
+     * @brief 按主控下发的新端点更新连接配置，写出缓冲后关闭旧连接并立即重连
+     */
+    void handleMigrateEndpoint(const IpcMessage& command);
+
+    /**
+     * @brief 应答关闭通知，然后交给插件退出
+     */
+    void handleShutdown(const IpcMessage& notice);
+    void scheduleReconnect();
+    void setState(State state);
+    void sendHeartbeat();
+    void checkLiveness();
+
+    /**
+     * @brief 编码并追加到写缓冲，安排一次合并写出
+     */
+    bool enqueueFrame(const IpcMessage& message, IpcCodecType codec);
+    void scheduleFlush();
+    void flush();
+    void fillDefaults(IpcMessage* message) const;
+    IpcMessage makeMessage(MessageType type, const QString& topic, const QJsonObject& body,
+                           const QString& receiver_id) const;
+
+    MasterClientConfig config_;
+    State state_ = State::kDisconnected;
+    bool running_ = false;
+
+    QIODevice* socket_ = nullptr;           // 当前连接，断开时deleteLater
+    IpcReceiveBuffer receive_buffer_;
+    IpcCodecType codec_ = IpcCodecType::kJson;
+    quint32 client_handle_ = 0;
+
+    std::deque<IpcMessage> pending_;        // 未就绪时待发的消息
+    QByteArray write_buffer_;               // 已编码、等待合并写出的帧
+    bool flush_scheduled_ = false;
+
+    QSet<QString> subscriptions_;
+    std::unique_ptr<IpcRequestTracker> request_tracker_;
+
+    QTimer reconnect_timer_;
+    QTimer heartbeat_timer_;
+    QTimer batch_timer_;
+    int reconnect_delay_ms_ = 0;
+    QElapsedTimer last_receive_;
+    QElapsedTimer last_activity_;           // 最近一次发出业务消息（心跳除外）
+    bool compact_heartbeat_ = false;        // 主控在kHelloAck中确认支持紧凑心跳帧
+    quint32 heartbeat_sequence_ = 0;
+    qint64 heartbeat_rtt_ms_ = -1;          // 最近一次紧凑心跳的往返时延
+
+    quint64 messages_sent_ = 0;
+    quint64 messages_received_ = 0;
+    quint64 bytes_sent_ = 0;
+    quint64 bytes_received_ = 0;
+    quint64 writes_ = 0;                    // 实际write调用次数，与messages_sent_之比即批量效果
+    quint64 messages_rejected_ = 0;
+    quint64 reconnects_ = 0;
+    quint64 migrations_ = 0;                // 按主控要求切换端点的次数
+    quint64 heartbeats_sent_ = 0;
+    quint64 heartbeats_skipped_ = 0;        // 因已有双向流量而跳过的心跳
+};
+
+#endif // MASTER_CLIENT_MASTERCLIENT_H_
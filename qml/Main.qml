@@ -120,7 +120,7 @@ ApplicationWindow {
                         background: Rectangle {
                             color: aboutItem2.highlighted ? "#2a2a2a" : "transparent"
                         }
-                        onTriggered: Qt.quit()
+                        onTriggered: mainWindow.close()
                     }
                 }
 
@@ -0,0 +1,166 @@
+#include "DeadlineWheel.h"
+#include <algorithm>
+
+namespace {
+
+constexpr quint64 kSlotMask = DeadlineWheel::kSlotsPerLevel - 1;
+
+// 第 level 层一个槽覆盖的tick数
+constexpr quint64 LevelSpan(int level)
+{
+    return quint64(1) << (DeadlineWheel::kSlotBits * level);
+}
+
+} // namespace
+
+DeadlineWheel::DeadlineWheel(int tick_ms, QObject* parent)
+    : QObject(parent),
+      tick_ms_(std::max(1, tick_ms))
+{
+    ticker_.setTimerType(Qt::PreciseTimer);
+    ticker_.setSingleShot(true);
+    connect(&ticker_, &QTimer::timeout, this, &DeadlineWheel::onTick);
+    clock_.start();
+}
+
+void DeadlineWheel::arm(const QString& key, qint64 delay_ms)
+{
+    if (index_.isEmpty()) {
+        // 空闲期间不推进tick，重新启动时直接对齐当前时间，避免补跑空槽
+        current_tick_ = ElapsedTicks();
+    }
+
+    // 按绝对时间向上取整，保证不会早于截止时间触发
+    const qint64 deadline_ms = clock_.elapsed() + std::max<qint64>(0, delay_ms);
+    const quint64 expire_tick = std::max<quint64>(
+        current_tick_ + 1, static_cast<quint64>((deadline_ms + tick_ms_ - 1) / tick_ms_));
+
+    auto found = index_.find(key);
+    if (found != index_.end()) {
+        Slot& from = levels_[found->level][found->slot];
+        found->it->expire_tick = expire_tick;
+        Place(from, found->it);
+    } else {
+        Slot staging;
+        staging.push_back(Entry{key, expire_tick});
+        index_.insert(key, Location{0, 0, staging.begin()});
+        Place(staging, staging.begin());
+    }
+
+    // 心跳改期通常把截止时间推后，只有提前到下一次唤醒之前才需要重设QTimer
+    if (!ticker_.isActive() || expire_tick < wake_tick_) {
+        Reschedule();
+    }
+}
+
+bool DeadlineWheel::disarm(const QString& key)
+{
+    auto found = index_.find(key);
+    if (found == index_.end()) {
+        return false;
+    }
+    levels_[found->level][found->slot].erase(found->it);
+    index_.erase(found);
+    if (index_.isEmpty()) {
+        ticker_.stop();
+    }
+    return true;
+}
+
+void DeadlineWheel::onTick()
+{
+    // 事件循环繁忙或QTimer跳过空槽时，一次补齐所有经过的tick
+    const quint64 target_tick = ElapsedTicks();
+    QStringList due;
+    while (current_tick_ < target_tick && !index_.isEmpty()) {
+        ++current_tick_;
+
+        // 低位全为零时对应层的槽开始生效，先处理高层，下沉的条目可能落入低层当前槽
+        int top_level = 0;
+        while (top_level + 1 < kLevels && (current_tick_ & (LevelSpan(top_level + 1) - 1)) == 0) {
+            ++top_level;
+        }
+        for (int level = top_level; level >= 1; --level) {
+            Cascade(level, &due);
+        }
+
+        Slot& slot = levels_[0][current_tick_ & kSlotMask];
+        for (auto it = slot.begin(); it != slot.end();) {
+            if (it->expire_tick <= current_tick_) {
+                due.append(it->key);
+                index_.remove(it->key);
+                it = slot.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    current_tick_ = std::max(current_tick_, target_tick);
+
+    Reschedule();
+
+    // 接收方可能再次arm或disarm，统一在遍历结束后发出
+    for (const QString& key : due) {
+        emit expired(key);
+    }
+}
+
+quint64 DeadlineWheel::ElapsedTicks() const
+{
+    return static_cast<quint64>(clock_.elapsed() / tick_ms_);
+}
+
+void DeadlineWheel::Place(Slot& from, Slot::iterator it)
+{
+    const quint64 delta = it->expire_tick > current_tick_ ? it->expire_tick - current_tick_ : 1;
+    int level = 0;
+    while (level + 1 < kLevels && delta >= LevelSpan(level + 1)) {
+        ++level;
+    }
+    // 超出最高层范围的条目先放在最高层，经过时重新分配
+    const int slot_index = static_cast<int>((it->expire_tick >> (kSlotBits * level)) & kSlotMask);
+
+    Slot& to = levels_[level][slot_index];
+    to.splice(to.end(), from, it);
+    index_[it->key] = Location{level, slot_index, it};
+}
+
+void DeadlineWheel::Cascade(int level, QStringList* due)
+{
+    const int slot_index = static_cast<int>((current_tick_ >> (kSlotBits * level)) & kSlotMask);
+
+    // 先整体摘下，避免超出范围的条目被放回同一个槽
+    Slot pending;
+    pending.swap(levels_[level][slot_index]);
+    while (!pending.empty()) {
+        auto it = pending.begin();
+        if (it->expire_tick <= current_tick_) {
+            due->append(it->key);
+            index_.remove(it->key);
+            pending.erase(it);
+        } else {
+            Place(pending, it);
+        }
+    }
+}
+
+void DeadlineWheel::Reschedule()
+{
+    if (index_.isEmpty()) {
+        ticker_.stop();
+        return;
+    }
+
+    // 下一次需要处理的tick：第0层当前一圈内的下一个非空槽，否则是下一次下沉
+    quint64 next_tick = (current_tick_ | kSlotMask) + 1;
+    for (quint64 tick = current_tick_ + 1; tick < next_tick; ++tick) {
+        if (!levels_[0][tick & kSlotMask].empty()) {
+            next_tick = tick;
+            break;
+        }
+    }
+
+    wake_tick_ = next_tick;
+    const qint64 delay_ms = static_cast<qint64>(next_tick) * tick_ms_ - clock_.elapsed();
+    ticker_.start(static_cast<int>(std::max<qint64>(0, delay_ms)));
+}
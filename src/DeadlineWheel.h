@@ -0,0 +1,111 @@
+#ifndef MASTER_SRC_DEADLINEWHEEL_H_
+#define MASTER_SRC_DEADLINEWHEEL_H_
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <array>
+#include <list>
+
+/**
+ * @brief 分层时间轮：按键管理长期截止时间（心跳超时等）
+ *
+ * 与 TimerWheel 不同，每个键最多只有一个截止时间，重复 arm() 即为改期，
+ * 在原位置摘除后重新挂入，O(1)。共 kLevels 层、每层 kSlotsPerLevel 个槽，
+ * 第 L 层一个槽覆盖 kSlotsPerLevel^L 个tick；临近到期的条目逐层下沉到第0层，
+ * 在实际到期的tick触发，精度为一个tick。
+ *
+ * 时间取自单调时钟（QElapsedTimer），不受系统时间调整影响。QTimer只在
+ * 第0层下一个非空槽或下一次下沉时唤醒，没有条目时停止。
+ *
+ * 非线程安全，只能在所属线程使用；expired信号在该线程的事件循环中发出。
+ */
+class DeadlineWheel : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 6;
+    static constexpr int kSlotsPerLevel = 1 << kSlotBits;
+
+    /**
+     * @brief 构造函数
+     * @param tick_ms 时间轮精度（毫秒），四层共覆盖 tick_ms * 64^4 毫秒
+     * @param parent 父对象
+     */
+    explicit DeadlineWheel(int tick_ms = 100, QObject* parent = nullptr);
+
+    /**
+     * @brief 设置（或改期）键的截止时间
+     * @param key 键
+     * @param delay_ms 距现在的延迟（毫秒），向上取整到tick
+     */
+    void arm(const QString& key, qint64 delay_ms);
+
+    /**
+     * @brief 取消键的截止时间
+     * @return 键存在且尚未触发时返回true
+     */
+    bool disarm(const QString& key);
+
+    bool isArmed(const QString& key) const { return index_.contains(key); }
+    int pendingCount() const { return static_cast<int>(index_.size()); }
+
+    /**
+     * @brief 时间轮单调时钟的当前毫秒数
+     */
+    qint64 nowMs() const { return clock_.elapsed(); }
+
+signals:
+    /**
+     * @brief 截止时间到达，键已从时间轮中移除
+     * @param key 键
+     */
+    void expired(const QString& key);
+
+private slots:
+    void onTick();
+
+private:
+    struct Entry {
+        QString key;
+        quint64 expire_tick;
+    };
+    using Slot = std::list<Entry>;
+
+    struct Location {
+        int level;
+        int slot;
+        Slot::iterator it;
+    };
+
+    const int tick_ms_;
+    std::array<std::array<Slot, kSlotsPerLevel>, kLevels> levels_;
+    QHash<QString, Location> index_;
+    QTimer ticker_;
+    QElapsedTimer clock_;
+    quint64 current_tick_ = 0;   // 已处理到的tick
+    quint64 wake_tick_ = 0;      // QTimer下一次唤醒对应的tick
+
+    quint64 ElapsedTicks() const;
+
+    /**
+     * @brief 按距到期的tick数选择层和槽，把条目从 from 移入目标槽
+     */
+    void Place(Slot& from, Slot::iterator it);
+
+    /**
+     * @brief 把第 level 层当前槽的条目重新分配到更低的层
+     */
+    void Cascade(int level, QStringList* due);
+
+    /**
+     * @brief 按下一个需要处理的tick重新设置QTimer
+     */
+    void Reschedule();
+};
+
+#endif // MASTER_SRC_DEADLINEWHEEL_H_
@@ -0,0 +1,682 @@
+#include "EpollIpcCommunication.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QUuid>
+#include <array>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+// epoll_data.u64 中除连接句柄（32位）外的两个保留标识
+constexpr quint64 kListenToken = quint64(1) << 32;
+constexpr quint64 kWakeToken = (quint64(1) << 32) + 1;
+// 单次epoll_wait返回的事件上限
+constexpr int kMaxEpollEvents = 256;
+// 单个连接每轮最多读取的字节数，超过时留到下一轮，避免一个连接独占I/O线程
+constexpr qsizetype kMaxReadBytesPerRound = 256 * 1024;
+constexpr qsizetype kReadChunkBytes = 64 * 1024;
+// 单次sendmsg聚合的帧数上限
+constexpr int kMaxIovecs = IOV_MAX < 64 ? IOV_MAX : 64;
+constexpr int kListenBacklog = 511;
+// 等待事件循环生成统计快照的上限
+constexpr unsigned long kStatisticsTimeoutMs = 1000;
+
+QString errnoString(int error) {
+  return QString::fromLocal8Bit(std::strerror(error));
+}
+
+/**
+ * @brief 把出站队列中的帧移入连接的写队列，由FlushConnection批量写出
+ */
+class WriteQueueSink : public IpcFrameSink {
+public:
+  WriteQueueSink(std::deque<QByteArray> *queue, qint64 *queued_bytes)
+      : queue_(queue), queued_bytes_(queued_bytes) {}
+
+  qint64 pendingBytes() const override { return *queued_bytes_; }
+
+  qint64 writeFrame(const QByteArray &frame) override {
+    queue_->push_back(frame);
+    *queued_bytes_ += frame.size();
+    return frame.size();
+  }
+
+private:
+  std::deque<QByteArray> *queue_;
+  qint64 *queued_bytes_;
+};
+} // namespace
+
+// ================== EpollIpcCommunication 实现 ==================
+
+EpollIpcCommunication::EpollIpcCommunication(QObject *parent)
+    : StreamIpcCommunication(parent) {}
+
+EpollIpcCommunication::~EpollIpcCommunication() {
+  // 基类析构时虚函数已不再分派到本类，必须在这里停止反应器
+  stop();
+}
+
+bool EpollIpcCommunication::initialize(const QJsonObject &config) {
+  SetConnectionState(ConnectionState::kConnecting);
+
+  QJsonObject local_socket = config["local_socket"].toObject();
+  server_name_ = local_socket["server_name"].toString();
+  if (server_name_.isEmpty()) {
+    SetLastError("初始化失败: 配置中缺少 'server_name'");
+    qWarning() << "[EpollIpcCommunication] 初始化失败: 配置中缺少 'server_name'";
+    SetConnectionState(ConnectionState::kError);
+    return false;
+  }
+
+  initializeStream(local_socket);
+
+  qDebug() << "[EpollIpcCommunication] 初始化服务器名称:" << server_name_;
+  SetConnectionState(ConnectionState::kInitialized);
+  return true;
+}
+
+QJsonObject EpollIpcCommunication::getEndpoint() const {
+  // 客户端仍以QLocalSocket的命名规则连接，与LocalSocket策略的端点格式相同
+  return QJsonObject{{"transport", "local_socket"}, {"server_name", server_name_}};
+}
+
+std::unique_ptr<IpcStreamServer> EpollIpcCommunication::createServer() const {
+  return nullptr;
+}
+
+bool EpollIpcCommunication::StartReactor(QString *endpoint, QString *error) {
+  auto reactor = std::make_unique<EpollIpcReactor>(this, server_name_);
+  if (!reactor->listen(error)) {
+    return false;
+  }
+  *endpoint = reactor->serverName();
+  epoll_reactor_ = std::move(reactor);
+
+  EpollIpcReactor *raw_reactor = epoll_reactor_.get();
+  epoll_thread_.reset(QThread::create([raw_reactor]() { raw_reactor->run(); }));
+  epoll_thread_->setObjectName("EpollIpcIo");
+  epoll_thread_->start();
+  return true;
+}
+
+void EpollIpcCommunication::StopReactor() {
+  if (epoll_reactor_) {
+    epoll_reactor_->requestStop();
+  }
+  if (epoll_thread_) {
+    epoll_thread_->wait();
+    epoll_thread_.reset();
+  }
+  epoll_reactor_.reset();
+}
+
+void EpollIpcCommunication::WakeReactor() {
+  if (epoll_reactor_) {
+    epoll_reactor_->wake();
+  }
+}
+
+QJsonObject EpollIpcCommunication::ReactorStatistics() const {
+  return epoll_reactor_ ? epoll_reactor_->statistics() : QJsonObject();
+}
+
+// ================== EpollIpcReactor 实现 ==================
+
+EpollIpcReactor::EpollIpcReactor(StreamIpcCommunication *owner,
+                                 const QString &server_name)
+    : IpcReactorProtocol(owner, "[EpollIpcCommunication]"),
+      server_name_(server_name) {
+  // 与QLocalServer在Unix上的命名规则一致，插件端可继续使用QLocalSocket连接
+  socket_path_ = QDir::isAbsolutePath(server_name)
+                     ? server_name
+                     : QDir::tempPath() + QLatin1Char('/') + server_name;
+}
+
+EpollIpcReactor::~EpollIpcReactor() { Teardown(); }
+
+bool EpollIpcReactor::listen(QString *error) {
+  const QByteArray path = QFile::encodeName(socket_path_);
+  sockaddr_un address{};
+  if (path.size() >= static_cast<qsizetype>(sizeof(address.sun_path))) {
+    *error = QString("socket路径过长: %1").arg(socket_path_);
+    return false;
+  }
+  address.sun_family = AF_UNIX;
+  std::memcpy(address.sun_path, path.constData(), path.size());
+
+  listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (listen_fd_ < 0) {
+    *error = QString("创建socket失败: %1").arg(errnoString(errno));
+    return false;
+  }
+
+  // 移除之前的同名服务器（如果存在）
+  ::unlink(path.constData());
+  if (::bind(listen_fd_, reinterpret_cast<sockaddr *>(&address),
+             sizeof(address)) < 0 ||
+      ::listen(listen_fd_, kListenBacklog) < 0) {
+    *error = QString("监听 %1 失败: %2").arg(socket_path_, errnoString(errno));
+    Teardown();
+    return false;
+  }
+
+  epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+  wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (epoll_fd_ < 0 || wake_fd_ < 0) {
+    *error = QString("创建epoll失败: %1").arg(errnoString(errno));
+    Teardown();
+    return false;
+  }
+
+  epoll_event listen_event{};
+  listen_event.events = EPOLLIN | EPOLLET;
+  listen_event.data.u64 = kListenToken;
+  epoll_event wake_event{};
+  wake_event.events = EPOLLIN | EPOLLET;
+  wake_event.data.u64 = kWakeToken;
+  if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &listen_event) < 0 ||
+      ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &wake_event) < 0) {
+    *error = QString("注册epoll事件失败: %1").arg(errnoString(errno));
+    Teardown();
+    return false;
+  }
+
+  stop_requested_.store(false);
+  qDebug() << "[EpollIpcCommunication] 监听:" << socket_path_;
+  return true;
+}
+
+void EpollIpcReactor::Teardown() {
+  for (auto &entry : connections_) {
+    Connection *connection = static_cast<Connection *>(entry.get());
+    if (connection && connection->fd >= 0) {
+      ::close(connection->fd);
+    }
+  }
+  ClearConnections();
+  dirty_connections_.clear();
+  read_backlog_.clear();
+
+  if (listen_fd_ >= 0) {
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    ::unlink(QFile::encodeName(socket_path_).constData()); // 确保移除服务器文件
+  }
+  if (wake_fd_ >= 0) {
+    ::close(wake_fd_);
+    wake_fd_ = -1;
+  }
+  if (epoll_fd_ >= 0) {
+    ::close(epoll_fd_);
+    epoll_fd_ = -1;
+  }
+}
+
+void EpollIpcReactor::requestStop() {
+  stop_requested_.store(true);
+  wake();
+}
+
+void EpollIpcReactor::wake() {
+  const quint64 one = 1;
+  // eventfd计数溢出前的写入不会失败；EAGAIN说明已有未处理的唤醒
+  [[maybe_unused]] const ssize_t result = ::write(wake_fd_, &one, sizeof(one));
+}
+
+void EpollIpcReactor::run() {
+  std::array<epoll_event, kMaxEpollEvents> events;
+  std::vector<IpcClientHandle> backlog;
+  while (!stop_requested_.load()) {
+    // 有未读完的连接时不阻塞，先处理新事件再继续读取
+    backlog.clear();
+    backlog.swap(read_backlog_);
+    // 有未握手的连接时定期醒来检查握手超时
+    const int reap_interval_ms =
+        pending_handshakes_ > 0 ? admission_.reapIntervalMs() : 0;
+    const int timeout_ms =
+        !backlog.empty() ? 0 : (reap_interval_ms > 0 ? reap_interval_ms : -1);
+    const int count =
+        ::epoll_wait(epoll_fd_, events.data(), kMaxEpollEvents, timeout_ms);
+    if (count < 0) {
+      if (errno == EINTR) {
+        read_backlog_.swap(backlog);
+        continue;
+      }
+      qWarning() << "[EpollIpcCommunication] epoll_wait失败:"
+                 << errnoString(errno);
+      break;
+    }
+
+    for (int i = 0; i < count; ++i) {
+      const quint64 token = events[i].data.u64;
+      if (token == kListenToken) {
+        AcceptConnections();
+        continue;
+      }
+      if (token == kWakeToken) {
+        quint64 value = 0;
+        [[maybe_unused]] const ssize_t result =
+            ::read(wake_fd_, &value, sizeof(value));
+        DrainOutbound();
+        continue;
+      }
+
+      // 同一批事件中连接可能已被关闭，句柄代数保证不会误投到复用槽位的新连接
+      Connection *connection =
+          FindConnection(static_cast<IpcClientHandle>(token));
+      if (!connection) {
+        continue;
+      }
+      if (events[i].events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) {
+        connection->writable = true;
+        PumpConnection(connection);
+        MarkDirty(connection);
+      }
+      if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP)) {
+        QString error;
+        if (!ReadConnection(connection, &error)) {
+          CloseConnection(connection, error);
+        }
+      }
+    }
+
+    // 上一轮达到读取上限的连接继续读取
+    for (IpcClientHandle handle : backlog) {
+      Connection *connection = FindConnection(handle);
+      if (!connection) {
+        continue;
+      }
+      connection->read_pending = false;
+      QString error;
+      if (!ReadConnection(connection, &error)) {
+        CloseConnection(connection, error);
+      }
+    }
+
+    if (reap_interval_ms > 0 &&
+        admission_.nowMs() - last_reap_ms_ >= reap_interval_ms) {
+      last_reap_ms_ = admission_.nowMs();
+      ReapHandshakes();
+    }
+
+    FlushPendingWrites();
+
+    if (stats_requested_.exchange(false)) {
+      PublishStatistics();
+    }
+  }
+
+  // 与StreamIpcReactor::shutdown一致：直接断开，不再投递断开事件
+  Teardown();
+}
+
+void EpollIpcReactor::AcceptConnections() {
+  for (;;) {
+    const int fd = ::accept4(listen_fd_, nullptr, nullptr,
+                             SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        qWarning() << "[EpollIpcCommunication] 接受连接失败:"
+                   << errnoString(errno);
+      }
+      return;
+    }
+
+    // 准入控制：连接数上限与接受速率，拒绝的连接不登记、不通知主线程
+    const IpcAdmissionControl::Decision decision =
+        admission_.admit(connection_count_);
+    if (decision != IpcAdmissionControl::Decision::kAccept) {
+      qWarning() << "[EpollIpcCommunication] 拒绝连接:"
+                 << (decision == IpcAdmissionControl::Decision::kRejectCapacity
+                         ? "连接数已达上限"
+                         : "接受速率超限");
+      ::close(fd);
+      continue;
+    }
+
+    auto connection = std::make_unique<Connection>(&owner_->outbound_config_);
+    connection->client_id = QUuid::createUuid().toString(
+        QUuid::WithoutBraces); // 为每个客户端生成唯一ID
+    connection->fd = fd;
+    connection->accepted_at_ms = admission_.nowMs();
+    connection->handle = owner_->RegisterClient(connection->client_id);
+    if (connection->handle == 0) {
+      qWarning() << "[EpollIpcCommunication] 连接句柄已耗尽，拒绝连接";
+      ::close(fd);
+      continue;
+    }
+
+    // 边沿触发：可读/可写状态变化时各通知一次，读写都要进行到EAGAIN
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    event.data.u64 = connection->handle;
+    if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+      qWarning() << "[EpollIpcCommunication] 注册连接失败:"
+                 << errnoString(errno);
+      owner_->RemoveClient(connection->handle);
+      ::close(fd);
+      continue;
+    }
+
+    const QString client_id = connection->client_id;
+    qDebug() << "[EpollIpcCommunication] 新的IPC连接:" << client_id
+             << "句柄:" << connection->handle;
+
+    InsertConnection(std::move(connection));
+    accepted_total_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+bool EpollIpcReactor::ReadConnection(Connection *connection, QString *error) {
+  // 直接读入连接缓冲区，随后在同一块内存上逐帧解码
+  IpcReceiveBuffer &buffer = connection->receive_buffer;
+  qsizetype total = 0;
+  bool open = true;
+  while (total < kMaxReadBytesPerRound) {
+    char *tail = buffer.prepareWrite(kReadChunkBytes);
+    const ssize_t bytes_read =
+        ::read(connection->fd, tail, static_cast<size_t>(buffer.writableBytes()));
+    if (bytes_read > 0) {
+      buffer.commit(bytes_read);
+      total += bytes_read;
+      read_calls_.fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
+    if (bytes_read == 0) {
+      open = false; // 对端关闭
+      break;
+    }
+    if (errno == EINTR) {
+      continue;
+    }
+    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      *error = QString("Socket错误: %1").arg(errnoString(errno));
+      open = false;
+    }
+    break;
+  }
+
+  // 达到上限时内核中可能还有数据，边沿触发不会再通知，登记到下一轮继续读
+  if (open && total >= kMaxReadBytesPerRound && !connection->read_pending) {
+    connection->read_pending = true;
+    read_backlog_.push_back(connection->handle);
+  }
+
+  if (total > 0) {
+    bytes_read_.fetch_add(static_cast<quint64>(total),
+                          std::memory_order_relaxed);
+    if (!DispatchFrames(connection, &buffer)) {
+      *error = QString("握手完成前收到kHello以外的帧");
+      return false;
+    }
+  }
+
+  // 握手前只允许少量数据，防止未认证的连接占用大块内存
+  if (open && !connection->handshaken &&
+      buffer.size() > IpcAdmissionControl::kMaxHandshakeBytes) {
+    admission_.recordHandshakeOverflow();
+    *error = QString("握手前数据超出上限");
+    open = false;
+  }
+  return open;
+}
+
+void EpollIpcReactor::DrainOutbound() {
+  owner_->outbound_drain_scheduled_.store(false);
+
+  IpcOutboundCommand command;
+  while (owner_->outbound_queue_.tryPop(&command)) {
+    // 同一条消息对每种编码只序列化一次，所有接收者共享同一个隐式共享的帧
+    EncodedFrames frames(command.message);
+    switch (command.kind) {
+    case IpcOutboundCommand::Kind::kUnicast:
+    case IpcOutboundCommand::Kind::kMulticast:
+      for (IpcClientHandle handle : std::as_const(command.handles)) {
+        Connection *connection = FindConnection(handle);
+        if (!connection) {
+          PostError(QString(), QString("发送消息失败: 接收者 '%1' 已断开")
+                                   .arg(command.message.receiver_id));
+          continue;
+        }
+        WriteMessage(connection, &frames);
+      }
+      break;
+    case IpcOutboundCommand::Kind::kBroadcast:
+      // 广播只发给已握手的连接，主线程从未获知其余连接
+      for (auto &connection : connections_) {
+        if (connection && connection->handshaken) {
+          WriteMessage(connection.get(), &frames);
+        }
+      }
+      break;
+    case IpcOutboundCommand::Kind::kDisconnect:
+      // 与QLocalSocket::disconnectFromServer一致，已排队的数据写完后再断开
+      for (IpcClientHandle handle : std::as_const(command.handles)) {
+        if (Connection *connection = FindConnection(handle)) {
+          connection->closing = true;
+          MarkDirty(connection);
+        }
+      }
+      break;
+    }
+  }
+}
+
+bool EpollIpcReactor::IsWritable(const ProtocolConnection *connection) const {
+  return !static_cast<const Connection *>(connection)->closing;
+}
+
+qint64
+EpollIpcReactor::InFlightBytes(const ProtocolConnection *connection) const {
+  return static_cast<const Connection *>(connection)->write_queue_bytes;
+}
+
+void EpollIpcReactor::PumpConnection(ProtocolConnection *base) {
+  Connection *connection = static_cast<Connection *>(base);
+  WriteQueueSink sink(&connection->write_queue,
+                      &connection->write_queue_bytes);
+  if (connection->outbound.pump(&sink) > 0) {
+    MarkDirty(connection);
+  }
+}
+
+bool EpollIpcReactor::FlushConnection(Connection *connection, QString *error) {
+  while (!connection->write_queue.empty()) {
+    // 一次系统调用写出多帧；sendmsg即带MSG_NOSIGNAL的writev，对端关闭时不触发SIGPIPE
+    std::array<iovec, kMaxIovecs> iov;
+    int iov_count = 0;
+    for (auto it = connection->write_queue.cbegin();
+         it != connection->write_queue.cend() && iov_count < kMaxIovecs;
+         ++it, ++iov_count) {
+      const qsizetype offset = iov_count == 0 ? connection->write_offset : 0;
+      iov[iov_count].iov_base = const_cast<char *>(it->constData()) + offset;
+      iov[iov_count].iov_len = static_cast<size_t>(it->size() - offset);
+    }
+
+    msghdr header{};
+    header.msg_iov = iov.data();
+    header.msg_iovlen = static_cast<size_t>(iov_count);
+    const ssize_t bytes_written =
+        ::sendmsg(connection->fd, &header, MSG_NOSIGNAL);
+    if (bytes_written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        connection->writable = false; // 等待EPOLLOUT
+        return true;
+      }
+      *error = QString("发送消息到 '%1' 失败: %2")
+                   .arg(connection->client_id, errnoString(errno));
+      return false;
+    }
+    write_calls_.fetch_add(1, std::memory_order_relaxed);
+    bytes_written_.fetch_add(static_cast<quint64>(bytes_written),
+                             std::memory_order_relaxed);
+    connection->write_queue_bytes -= bytes_written;
+
+    qsizetype remaining = bytes_written;
+    while (remaining > 0) {
+      const qsizetype left =
+          connection->write_queue.front().size() - connection->write_offset;
+      if (remaining < left) {
+        connection->write_offset += remaining;
+        break;
+      }
+      remaining -= left;
+      connection->write_queue.pop_front();
+      connection->write_offset = 0;
+      frames_written_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 写队列低于低水位后从出站队列补充
+    WriteQueueSink sink(&connection->write_queue,
+                        &connection->write_queue_bytes);
+    connection->outbound.pump(&sink);
+  }
+  return true;
+}
+
+void EpollIpcReactor::FlushPendingWrites() {
+  // 先换出列表，关闭连接不会影响遍历
+  std::vector<IpcClientHandle> dirty;
+  dirty.swap(dirty_connections_);
+  for (IpcClientHandle handle : dirty) {
+    Connection *connection = FindConnection(handle);
+    if (!connection) {
+      continue;
+    }
+    connection->flush_pending = false;
+    if (!connection->writable) {
+      continue; // EPOLLOUT到达后重新登记
+    }
+
+    QString error;
+    if (!FlushConnection(connection, &error)) {
+      CloseConnection(connection, error);
+      continue;
+    }
+    if (connection->closing && connection->write_queue.empty() &&
+        connection->outbound.isEmpty()) {
+      CloseConnection(connection, QString());
+    }
+  }
+}
+
+void EpollIpcReactor::MarkDirty(Connection *connection) {
+  if (!connection->flush_pending) {
+    connection->flush_pending = true;
+    dirty_connections_.push_back(connection->handle);
+  }
+}
+
+void EpollIpcReactor::CloseConnection(Connection *connection,
+                                      const QString &error) {
+  // 从连接表取出，连接在本函数返回时释放
+  const std::unique_ptr<ProtocolConnection> released =
+      TakeConnection(connection);
+  if (!released) {
+    return;
+  }
+
+  const QString client_id = connection->client_id;
+  const bool handshaken = connection->handshaken;
+  if (!error.isEmpty()) {
+    qWarning() << "[EpollIpcCommunication] 客户端 '" << client_id
+               << "' 发生错误: " << error;
+    if (handshaken) {
+      PostError(client_id, error);
+    }
+  }
+  qDebug() << "[EpollIpcCommunication] IPC连接断开:" << client_id;
+
+  // close会把fd从epoll中移除
+  ::close(connection->fd);
+
+  // 主线程从未获知未握手的连接，断开时也不通知
+  if (!handshaken) {
+    return;
+  }
+  IpcInboundEvent event;
+  event.kind = IpcInboundEvent::Kind::kClientDisconnected;
+  event.client_id = client_id;
+  owner_->PostInbound(std::move(event));
+}
+
+void EpollIpcReactor::DropConnection(ProtocolConnection *connection,
+                                     const QString &reason) {
+  CloseConnection(static_cast<Connection *>(connection), reason);
+}
+
+EpollIpcReactor::Connection *
+EpollIpcReactor::FindConnection(IpcClientHandle handle) const {
+  return static_cast<Connection *>(IpcReactorProtocol::FindConnection(handle));
+}
+
+void EpollIpcReactor::PublishStatistics() {
+  quint64 dropped_total = closed_dropped_messages_;
+  for (const auto &connection : connections_) {
+    if (connection) {
+      dropped_total += connection->outbound.droppedMessages();
+    }
+  }
+  QJsonObject admission = admission_.statistics();
+  admission["pending_handshakes"] = pending_handshakes_;
+
+  QJsonObject snapshot;
+  snapshot["connections"] = connection_count_;
+  snapshot["dropped_messages"] = static_cast<qint64>(dropped_total);
+  snapshot["admission"] = admission;
+  snapshot["relay"] = RelayStatistics();
+  snapshot["heartbeats"] = HeartbeatStatistics();
+
+  QMutexLocker locker(&stats_mutex_);
+  stats_snapshot_ = snapshot;
+  ++stats_generation_;
+  stats_ready_.wakeAll();
+}
+
+QJsonObject EpollIpcReactor::statistics() {
+  QJsonObject stats;
+  {
+    // 连接表与转发路由只在I/O线程访问，请求事件循环生成快照；
+    // 事件循环未能及时响应时返回上一次的快照
+    QMutexLocker locker(&stats_mutex_);
+    const quint64 generation = stats_generation_;
+    stats_requested_.store(true);
+    wake();
+    while (stats_generation_ == generation) {
+      if (!stats_ready_.wait(&stats_mutex_, kStatisticsTimeoutMs)) {
+        break;
+      }
+    }
+    stats = stats_snapshot_;
+  }
+
+  stats["transport"] = QStringLiteral("epoll");
+  stats["accepted_total"] =
+      static_cast<qint64>(accepted_total_.load(std::memory_order_relaxed));
+  stats["bytes_read"] =
+      static_cast<qint64>(bytes_read_.load(std::memory_order_relaxed));
+  stats["bytes_written"] =
+      static_cast<qint64>(bytes_written_.load(std::memory_order_relaxed));
+  stats["read_calls"] =
+      static_cast<qint64>(read_calls_.load(std::memory_order_relaxed));
+  stats["write_calls"] =
+      static_cast<qint64>(write_calls_.load(std::memory_order_relaxed));
+  stats["frames_written"] =
+      static_cast<qint64>(frames_written_.load(std::memory_order_relaxed));
+  return stats;
+}
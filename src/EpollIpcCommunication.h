@@ -0,0 +1,155 @@
+#ifndef MASTER_SRC_EPOLLIPCCOMMUNICATION_H_
+#define MASTER_SRC_EPOLLIPCCOMMUNICATION_H_
+
+#include "StreamIpcCommunication.h"
+#include <QByteArray>
+#include <QMutex>
+#include <QWaitCondition>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+
+class EpollIpcReactor;
+
+/**
+ * @brief 基于epoll的本地socket IPC通信实现（仅Linux）
+ *
+ * 协议、ID映射、Topic订阅、出站队列与插件间转发的语义与
+ * LocalSocketIpcCommunication完全相同（共用StreamIpcCommunication的客户端
+ * 目录与跨线程队列），插件端仍可用QLocalSocket或master_client连接。
+ * 区别只在I/O线程：不为每个连接创建QObject和信号连接，直接在AF_UNIX socket上
+ * 以边沿触发的epoll读取，出站帧以一次sendmsg（writev语义）批量写出。
+ * 适合数百个轻量插件进程连接同一主控、Qt逐socket开销占主导的场景。
+ *
+ * 不支持共享内存数据通道，kHello中的shm声明被忽略。
+ *
+ * 配置与LocalSocket相同，取自 ipc.local_socket；ipc.type 设为 "epoll_local"。
+ * server_name 不是绝对路径时与QLocalServer一致，放在临时目录下。
+ */
+class EpollIpcCommunication : public StreamIpcCommunication {
+  Q_OBJECT
+
+public:
+  explicit EpollIpcCommunication(QObject* parent = nullptr);
+  ~EpollIpcCommunication() override;
+
+  bool initialize(const QJsonObject& config) override;
+  QJsonObject getEndpoint() const override;
+
+protected:
+  // 不使用Qt服务端，由EpollIpcReactor直接管理监听socket
+  std::unique_ptr<IpcStreamServer> createServer() const override;
+
+  bool StartReactor(QString* endpoint, QString* error) override;
+  void StopReactor() override;
+  void WakeReactor() override;
+  QJsonObject ReactorStatistics() const override;
+
+private:
+  QString server_name_;
+  std::unique_ptr<EpollIpcReactor> epoll_reactor_;
+  std::unique_ptr<QThread> epoll_thread_;
+};
+
+/**
+ * @brief epoll I/O反应器，run()运行在独立线程
+ *
+ * 对应StreamIpcReactor，只负责fd层面的I/O：监听、按就绪事件读取、
+ * 以sendmsg批量写出；握手、心跳、帧分发与转发见IpcReactorProtocol。
+ * 连接表只在I/O线程访问，wake()/requestStop()/statistics()可在任意线程调用。
+ */
+class EpollIpcReactor : public IpcReactorProtocol {
+public:
+  EpollIpcReactor(StreamIpcCommunication* owner, const QString& server_name);
+  ~EpollIpcReactor() override;
+
+  /**
+   * @brief 创建监听socket、epoll实例和唤醒用的eventfd
+   */
+  bool listen(QString* error);
+
+  /**
+   * @brief 监听的socket文件路径
+   */
+  QString serverName() const { return socket_path_; }
+
+  /**
+   * @brief 事件循环，直到requestStop()后断开全部连接并返回
+   */
+  void run();
+
+  void requestStop();
+
+  /**
+   * @brief 唤醒事件循环处理发送命令
+   */
+  void wake();
+
+  /**
+   * @brief 连接、转发路由等统计由事件循环生成快照，调用方阻塞到快照就绪
+   */
+  QJsonObject statistics();
+
+private:
+  /**
+   * @brief 单个客户端连接的I/O状态（仅I/O线程访问）
+   */
+  struct Connection : ProtocolConnection {
+    explicit Connection(const IpcOutboundQueueConfig* config) : ProtocolConnection(config) {}
+
+    int fd = -1;                              // 句柄同时作为epoll事件的标识
+    bool writable = true;                     // 上次写出未遇到EAGAIN
+    bool flush_pending = false;               // 已登记到dirty_connections_
+    bool read_pending = false;                // 已登记到read_backlog_
+    bool closing = false;                     // 写完剩余数据后断开
+    std::deque<QByteArray> write_queue;       // 已出队、等待写入内核的帧
+    qsizetype write_offset = 0;               // write_queue.front()已写出的字节数
+    qint64 write_queue_bytes = 0;             // write_queue中尚未写出的字节数
+  };
+
+  QString server_name_;
+  QString socket_path_;
+  int listen_fd_ = -1;
+  int epoll_fd_ = -1;
+  int wake_fd_ = -1;
+  std::atomic_bool stop_requested_{false};
+  qint64 last_reap_ms_ = 0;
+
+  std::vector<IpcClientHandle> dirty_connections_;       // 本轮有待写出数据的连接
+  std::vector<IpcClientHandle> read_backlog_;            // 单次读取达到上限、仍有数据的连接
+
+  // I/O计数由I/O线程更新，statistics()在其他线程读取
+  std::atomic<quint64> accepted_total_{0};
+  std::atomic<quint64> bytes_read_{0};
+  std::atomic<quint64> bytes_written_{0};
+  std::atomic<quint64> read_calls_{0};
+  std::atomic<quint64> write_calls_{0};
+  std::atomic<quint64> frames_written_{0};
+
+  // 协议统计快照，statistics()请求后由事件循环在本轮结束时生成
+  std::atomic_bool stats_requested_{false};
+  QMutex stats_mutex_;
+  QWaitCondition stats_ready_;
+  quint64 stats_generation_ = 0;            // 每生成一次快照递增（stats_mutex_保护）
+  QJsonObject stats_snapshot_;              // stats_mutex_保护
+
+  void Teardown();
+  void AcceptConnections();
+  bool ReadConnection(Connection* connection, QString* error);
+  void DrainOutbound();
+  bool FlushConnection(Connection* connection, QString* error);
+  void FlushPendingWrites();
+  void MarkDirty(Connection* connection);
+  void CloseConnection(Connection* connection, const QString& error);
+  Connection* FindConnection(IpcClientHandle handle) const;
+  void PublishStatistics();
+
+  // IpcReactorProtocol
+  bool IsWritable(const ProtocolConnection* connection) const override;
+  qint64 InFlightBytes(const ProtocolConnection* connection) const override;
+  void PumpConnection(ProtocolConnection* connection) override;
+  void DropConnection(ProtocolConnection* connection, const QString& reason) override;
+};
+
+#endif // MASTER_SRC_EPOLLIPCCOMMUNICATION_H_
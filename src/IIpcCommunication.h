@@ -5,9 +5,16 @@
 #include <QString>
 #include <QJsonObject>
 #include <QJsonDocument>
+#include <QFuture>
+#include <QDeadlineTimer>
+#include "IpcMessageBody.h"
 #include <functional>
 #include <memory>
 
+class IpcRequestTracker;
+class IpcLivenessTable;
+class QTimer;
+
 /**
  * @brief IPC通信消息类型枚举
  */
@@ -35,7 +42,7 @@ struct IpcMessage {
     qint64 timestamp;           // 时间戳
     QString sender_id;          // 发送者ID
     QString receiver_id;        // 接收者ID（空表示广播）
-    QJsonObject body;           // 消息体
+    IpcMessageBody body;        // 消息体（解码所得的消息体按需解析）
     
     // 序列化为JSON
     QJsonObject toJson() const;
@@ -43,13 +50,27 @@ struct IpcMessage {
     // 从JSON反序列化
     static IpcMessage fromJson(const QJsonObject& json);
     
-    // 转换为字节数组
+    // 转换为字节数组（紧凑JSON文本，未修改的原始JSON消息体原样嵌入）
     QByteArray toByteArray() const;
     
     // 从字节数组解析
     static IpcMessage fromByteArray(const QByteArray& data);
 };
 
+/**
+ * @brief 请求/响应调用的结果
+ */
+struct IpcRequestResult {
+    bool success = false;       // 收到响应且响应未声明失败（body.success != false）
+    bool timed_out = false;     // 在截止时间内未收到响应
+    QString request_id;         // 请求消息的msg_id
+    QString error;              // 失败原因
+    IpcMessage response{};      // 响应消息（仅收到响应时有效）
+    qint64 latency_us = -1;     // 往返时延（微秒），未收到响应时为-1
+
+    QJsonObject toJson() const;
+};
+
 /**
  * @brief IPC通信连接状态枚举
  */
@@ -108,7 +129,7 @@ public:
 
     /**
      * @brief 发布消息到指定Topic
-     * @param topic 主题名称
+     * @param topic 主题名称，以 '.' 分段；订阅方可用 '*'（单段）和 '#'（末尾多段）通配
      * @param message 要发布的消息
      * @return 是否发布成功
      */
@@ -173,6 +194,30 @@ public:
      */
     virtual QString getClientIdBySenderId(const QString& sender_id) const = 0;
 
+    /**
+     * @brief 获取传输层运行统计（队列深度、丢弃计数等）
+     * @return 统计信息，未实现统计的策略返回空对象
+     */
+    virtual QJsonObject getStatistics() const { return QJsonObject(); }
+
+    /**
+     * @brief 客户端连接本策略所需的端点描述
+     *
+     * 如 {"transport": "local_socket", "server_name": "..."} 或
+     * {"transport": "tcp_socket", "host": "...", "port": 27500}，
+     * 策略迁移时原样下发给客户端。
+     * @return 端点描述，无法由客户端直接连接的策略返回空对象
+     */
+    virtual QJsonObject getEndpoint() const { return QJsonObject(); }
+
+    /**
+     * @brief 设置插件活跃度表，须在start()之前调用
+     *
+     * 支持的策略在传输层应答心跳并记录每个插件最近收到数据的时间，
+     * 心跳消息不再投递到上层；不支持的策略忽略该表，心跳照常以消息上报。
+     */
+    virtual void setLivenessTable(std::shared_ptr<IpcLivenessTable> table) { Q_UNUSED(table); }
+
 signals:
     /**
      * @brief 收到新消息信号
@@ -219,7 +264,9 @@ enum class IpcType {
     kLocalSocket = 0,    // 本地Socket
     kTcpSocket,          // TCP Socket
     kNamedPipe,          // 命名管道
-    kRabbitMQ            // RabbitMQ消息队列
+    kRabbitMQ,           // RabbitMQ消息队列
+    kSharedMemory,       // 共享内存环形缓冲区（本地socket握手）
+    kEpollLocal          // epoll原生本地socket（仅Linux）
 };
 
 /**
@@ -239,7 +286,7 @@ class IpcContext : public QObject {
 
 public:
     explicit IpcContext(QObject* parent = nullptr);
-    virtual ~IpcContext() = default;
+    ~IpcContext() override;
 
     /**
      * @brief 设置IPC通信策略
@@ -275,13 +322,33 @@ public:
     bool switchStrategy(IpcType type, const QJsonObject& config = QJsonObject());
 
     /**
-     * @brief 优雅地切换策略（先停止当前策略再启动新策略）
+     * @brief 不停机地切换策略（迁移模式）
+     *
+     * 新策略先启动监听并立即成为当前策略，随后经旧策略向已连接的客户端
+     * 发送 topic 为 "migrate_endpoint" 的kCommand（body为新策略的
+     * getEndpoint()），客户端以原逻辑ID重连到新端点并恢复订阅。迁移期间
+     * 旧策略继续收发，发往逻辑ID的消息优先走已迁移的新连接；客户端全部
+     * 迁走或 config.migration_drain_timeout_ms（默认10000）到期后旧策略才
+     * 停止，并发出strategyMigrationFinished。
+     *
+     * 新旧端点相同（无法同时监听）或任一方不提供端点时，退化为先停止旧策略
+     * 再启动新策略。
      * @param type 新的IPC类型
      * @param config 配置参数
-     * @return 是否切换成功
+     * @return 新策略是否已启动
      */
     bool gracefulSwitchStrategy(IpcType type, const QJsonObject& config = QJsonObject());
 
+    /**
+     * @brief 是否有旧策略正在排空
+     */
+    bool isMigrating() const { return m_draining_strategy != nullptr; }
+
+    /**
+     * @brief 插件活跃度表，所有策略共用，策略切换后保持不变
+     */
+    std::shared_ptr<const IpcLivenessTable> livenessTable() const { return m_liveness_table; }
+
     // === 代理IIpcCommunication接口的所有方法 ===
     
     /**
@@ -385,6 +452,30 @@ public:
     QString getLastError() const;
     
     QString getClientIdBySenderId(const QString& sender_id) const;
+
+    /**
+     * @brief 获取当前策略的传输层运行统计
+     * @return 统计信息
+     */
+    QJsonObject getStatistics() const;
+
+    /**
+     * @brief 发送请求并异步等待对应的kCommandResponse
+     *
+     * 响应通过 body.request_id（或与请求相同的msg_id）与请求关联。
+     * 需在IpcContext所在线程调用，future在该线程完成。目标客户端断开时请求
+     * 立即以“目标已断开”失败，不等待超时。
+     * @param request 请求消息，msg_id为空时自动生成
+     * @param timeout_ms 超时时间（毫秒）
+     * @param name 统计时延所用的命令名称，默认使用topic
+     * @return 调用结果
+     */
+    QFuture<IpcRequestResult> sendRequest(IpcMessage request, int timeout_ms, const QString& name = QString());
+
+    /**
+     * @brief 获取按命令名称统计的往返时延
+     */
+    QJsonObject getRequestStatistics() const;
 signals:
     /**
      * @brief 策略切换完成信号
@@ -394,6 +485,13 @@ signals:
      */
     void strategyChanged(const QString& old_type, const QString& new_type, bool success);
 
+    /**
+     * @brief 迁移结束，旧策略已停止
+     * @param old_type 旧策略类型
+     * @param stranded_clients 超时仍未迁走、被随旧策略断开的客户端数
+     */
+    void strategyMigrationFinished(const QString& old_type, int stranded_clients);
+
     // === 转发IIpcCommunication接口的所有信号 ===
     
     /**
@@ -436,11 +534,58 @@ signals:
 private:
     std::unique_ptr<IIpcCommunication> m_strategy;  // 当前策略
     QString m_current_strategy_type;                // 当前策略类型名称
+    std::unique_ptr<IpcRequestTracker> m_request_tracker;  // 等待响应的请求表
+    std::shared_ptr<IpcLivenessTable> m_liveness_table;    // 传输层记录的插件活跃时间
+
+    // ==================== 迁移模式 ====================
+    std::unique_ptr<IIpcCommunication> m_draining_strategy;  // 正在排空的旧策略
+    QString m_draining_strategy_type;
+    QJsonObject m_migration_endpoint;               // 下发给客户端的新端点
+    std::unique_ptr<QTimer> m_drain_timer;          // 定期检查旧策略上的剩余连接
+    QDeadlineTimer m_drain_deadline;
+
+    /**
+     * @brief 迁移期间按逻辑ID选择策略：已在新策略上握手的走新策略，否则走旧策略
+     */
+    IIpcCommunication* strategyForSender(const QString& sender_id) const;
+
+    /**
+     * @brief 迁移期间按内部客户端ID选择策略
+     */
+    IIpcCommunication* strategyForClient(const QString& client_id) const;
+
+    /**
+     * @brief 向旧策略上的客户端发送迁移命令
+     * @param client_id 内部客户端ID，为空时广播
+     */
+    void sendMigrationNotice(const QString& client_id);
+
+    void checkDrainProgress();
+
+    /**
+     * @brief 停止并释放旧策略
+     */
+    void finishMigration();
+
+    /**
+     * @brief 转发策略收到的消息，先尝试与等待中的请求关联
+     */
+    void onStrategyMessageReceived(const IpcMessage& message);
+
+    /**
+     * @brief 转发当前策略的客户端断开，先以失败结束发往该客户端的请求
+     */
+    void onStrategyClientDisconnected(const QString& client_id);
     
     /**
      * @brief 连接策略对象的信号
      */
     void connectStrategySignals();
+
+    /**
+     * @brief 连接正在排空的旧策略的信号（不转发其连接状态变化）
+     */
+    void connectDrainingSignals();
     
     /**
      * @brief 断开策略对象的信号
@@ -0,0 +1,73 @@
+#include "IpcAdmissionControl.h"
+#include <algorithm>
+
+IpcAdmissionConfig IpcAdmissionConfig::fromJson(const QJsonObject& section)
+{
+    IpcAdmissionConfig config;
+    config.max_connections = std::max(0, section["max_connections"].toInt(config.max_connections));
+    config.accept_rate_per_second =
+        std::max(0.0, section["accept_rate_per_second"].toDouble(config.accept_rate_per_second));
+    config.accept_burst = std::max(1, section["accept_burst"].toInt(config.accept_burst));
+    config.hello_timeout_ms = std::max(0, section["hello_timeout_ms"].toInt(config.hello_timeout_ms));
+    return config;
+}
+
+IpcAdmissionControl::IpcAdmissionControl(const IpcAdmissionConfig* config)
+    : config_(config)
+    , tokens_(config->accept_burst)
+{
+    clock_.start();
+}
+
+IpcAdmissionControl::Decision IpcAdmissionControl::admit(int current_connections)
+{
+    if (config_->max_connections > 0 && current_connections >= config_->max_connections) {
+        rejected_capacity_.fetch_add(1, std::memory_order_relaxed);
+        return Decision::kRejectCapacity;
+    }
+
+    if (config_->accept_rate_per_second > 0) {
+        // 按流逝时间补充令牌，最多补满桶容量
+        const qint64 now = nowMs();
+        tokens_ = std::min<double>(config_->accept_burst,
+                                   tokens_ + (now - last_refill_ms_) * config_->accept_rate_per_second / 1000.0);
+        last_refill_ms_ = now;
+        if (tokens_ < 1.0) {
+            rejected_rate_.fetch_add(1, std::memory_order_relaxed);
+            return Decision::kRejectRate;
+        }
+        tokens_ -= 1.0;
+    }
+
+    accepted_.fetch_add(1, std::memory_order_relaxed);
+    return Decision::kAccept;
+}
+
+bool IpcAdmissionControl::handshakeExpired(qint64 accepted_at_ms, qint64 now_ms) const
+{
+    return config_->hello_timeout_ms > 0 && now_ms - accepted_at_ms >= config_->hello_timeout_ms;
+}
+
+int IpcAdmissionControl::reapIntervalMs() const
+{
+    if (config_->hello_timeout_ms <= 0) {
+        return 0;
+    }
+    // 超时最多被推迟四分之一个周期
+    return std::clamp(config_->hello_timeout_ms / 4, 50, 1000);
+}
+
+QJsonObject IpcAdmissionControl::statistics() const
+{
+    QJsonObject stats;
+    stats["max_connections"] = config_->max_connections;
+    stats["accept_rate_per_second"] = config_->accept_rate_per_second;
+    stats["hello_timeout_ms"] = config_->hello_timeout_ms;
+    stats["accepted"] = static_cast<qint64>(accepted_.load(std::memory_order_relaxed));
+    stats["rejected_capacity"] = static_cast<qint64>(rejected_capacity_.load(std::memory_order_relaxed));
+    stats["rejected_rate"] = static_cast<qint64>(rejected_rate_.load(std::memory_order_relaxed));
+    stats["handshake_timeouts"] = static_cast<qint64>(handshake_timeouts_.load(std::memory_order_relaxed));
+    stats["handshake_overflows"] = static_cast<qint64>(handshake_overflows_.load(std::memory_order_relaxed));
+    stats["handshake_violations"] = static_cast<qint64>(handshake_violations_.load(std::memory_order_relaxed));
+    return stats;
+}
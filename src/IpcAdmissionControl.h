@@ -0,0 +1,89 @@
+#ifndef MASTER_SRC_IPCADMISSIONCONTROL_H_
+#define MASTER_SRC_IPCADMISSIONCONTROL_H_
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <atomic>
+
+/**
+ * @brief 连接准入配置，取自传输对应的配置段（如 ipc.local_socket）
+ *
+ * 配置项：
+ * - max_connections: 同时存在的连接数上限（含未完成握手的），0表示不限制
+ * - accept_rate_per_second: 接受新连接的平均速率（令牌桶补充速率），0表示不限制
+ * - accept_burst: 令牌桶容量，即允许的瞬时连接数
+ * - hello_timeout_ms: 连接建立后必须在该时间内发送kHello，否则断开，0表示不限制
+ */
+struct IpcAdmissionConfig {
+    int max_connections = 100;
+    double accept_rate_per_second = 50.0;
+    int accept_burst = 100;
+    int hello_timeout_ms = 5000;
+
+    static IpcAdmissionConfig fromJson(const QJsonObject& section);
+};
+
+/**
+ * @brief 连接准入控制：连接数上限、接受速率限制与握手超时
+ *
+ * 插件异常反复重启时，未完成握手的连接不会进入主线程（clientConnected
+ * 在收到kHello后才发出），超时未握手的连接由反应器定期回收，握手前的
+ * 接收缓冲也有上限，避免耗尽主控内存或冲击配置下发。
+ *
+ * admit() 与 reap 检查只在I/O线程调用；计数可在任意线程读取。
+ */
+class IpcAdmissionControl {
+public:
+    // 握手完成前单个连接允许缓存的字节数，kHello远小于该值
+    static constexpr qsizetype kMaxHandshakeBytes = 64 * 1024;
+
+    enum class Decision {
+        kAccept = 0,
+        kRejectCapacity,     // 连接数已达上限
+        kRejectRate          // 接受速率超限
+    };
+
+    explicit IpcAdmissionControl(const IpcAdmissionConfig* config);
+
+    /**
+     * @brief 判断是否接受一个新连接，接受时消耗一个令牌
+     * @param current_connections 当前连接数（含未完成握手的）
+     */
+    Decision admit(int current_connections);
+
+    /**
+     * @brief 单调时钟的当前毫秒数，用作连接的接受时间
+     */
+    qint64 nowMs() const { return clock_.elapsed(); }
+
+    /**
+     * @brief 在accepted_at_ms接受、尚未握手的连接是否已超时
+     */
+    bool handshakeExpired(qint64 accepted_at_ms, qint64 now_ms) const;
+
+    /**
+     * @brief 回收检查的间隔，0表示不需要检查
+     */
+    int reapIntervalMs() const;
+
+    void recordHandshakeTimeout() { handshake_timeouts_.fetch_add(1, std::memory_order_relaxed); }
+    void recordHandshakeOverflow() { handshake_overflows_.fetch_add(1, std::memory_order_relaxed); }
+    void recordHandshakeViolation() { handshake_violations_.fetch_add(1, std::memory_order_relaxed); }
+
+    QJsonObject statistics() const;
+
+private:
+    const IpcAdmissionConfig* config_;
+    QElapsedTimer clock_;
+    double tokens_ = 0.0;
+    qint64 last_refill_ms_ = 0;
+
+    std::atomic<quint64> accepted_{0};
+    std::atomic<quint64> rejected_capacity_{0};
+    std::atomic<quint64> rejected_rate_{0};
+    std::atomic<quint64> handshake_timeouts_{0};
+    std::atomic<quint64> handshake_overflows_{0};
+    std::atomic<quint64> handshake_violations_{0};  // 握手前发送了kHello以外的帧
+};
+
+#endif // MASTER_SRC_IPCADMISSIONCONTROL_H_
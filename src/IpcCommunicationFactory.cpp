@@ -1,7 +1,13 @@
 #include "IIpcCommunication.h"
 #include "LocalSocketIpcCommunication.h"
+#include "SharedMemoryIpcCommunication.h"
+#include "TcpSocketIpcCommunication.h"
 #include <QDebug>
 
+#ifdef MASTER_HAS_EPOLL_IPC
+#include "EpollIpcCommunication.h"
+#endif
+
 // 静态成员初始化
 QMap<IpcType, IpcCommunicationFactory::StrategyCreator> IpcCommunicationFactory::s_creators;
 
@@ -24,6 +30,63 @@ namespace {
         }
     };
     static LocalSocketRegistrar registrar;
+
+    // 与s_creators位于同一编译单元，保证注册时映射表已完成初始化
+    struct SharedMemoryRegistrar {
+        SharedMemoryRegistrar() {
+            IpcCommunicationFactory::registerIpcType(
+                IpcType::kSharedMemory,
+                [](const QJsonObject& config) -> std::unique_ptr<IIpcCommunication> {
+                    auto ipc = std::make_unique<SharedMemoryIpcCommunication>();
+                    if (!ipc->initialize(config)) {
+                        qCritical() << "[IpcCommunicationFactory] SharedMemory IPC 初始化失败";
+                        return nullptr;
+                    }
+                    return ipc;
+                }
+            );
+            qDebug() << "[IpcCommunicationFactory] SharedMemory IPC 类型已注册";
+        }
+    };
+    static SharedMemoryRegistrar shared_memory_registrar;
+
+    struct TcpSocketRegistrar {
+        TcpSocketRegistrar() {
+            IpcCommunicationFactory::registerIpcType(
+                IpcType::kTcpSocket,
+                [](const QJsonObject& config) -> std::unique_ptr<IIpcCommunication> {
+                    auto ipc = std::make_unique<TcpSocketIpcCommunication>();
+                    if (!ipc->initialize(config)) {
+                        qCritical() << "[IpcCommunicationFactory] TcpSocket IPC 初始化失败";
+                        return nullptr;
+                    }
+                    return ipc;
+                }
+            );
+            qDebug() << "[IpcCommunicationFactory] TcpSocket IPC 类型已注册";
+        }
+    };
+    static TcpSocketRegistrar tcp_socket_registrar;
+
+#ifdef MASTER_HAS_EPOLL_IPC
+    struct EpollLocalRegistrar {
+        EpollLocalRegistrar() {
+            IpcCommunicationFactory::registerIpcType(
+                IpcType::kEpollLocal,
+                [](const QJsonObject& config) -> std::unique_ptr<IIpcCommunication> {
+                    auto ipc = std::make_unique<EpollIpcCommunication>();
+                    if (!ipc->initialize(config)) {
+                        qCritical() << "[IpcCommunicationFactory] EpollLocal IPC 初始化失败";
+                        return nullptr;
+                    }
+                    return ipc;
+                }
+            );
+            qDebug() << "[IpcCommunicationFactory] EpollLocal IPC 类型已注册";
+        }
+    };
+    static EpollLocalRegistrar epoll_local_registrar;
+#endif
 }
 
 std::unique_ptr<IIpcCommunication> IpcCommunicationFactory::createIpcCommunication(
@@ -59,7 +122,10 @@ QList<IpcType> IpcCommunicationFactory::getRegisteredTypes()
 
 IpcType IpcCommunicationFactory::getIpcTypeFromString(const QString& type_str)
 {
-    if (type_str == "LocalSocket") return IpcType::kLocalSocket;
+    if (type_str == "LocalSocket" || type_str == "local_socket") return IpcType::kLocalSocket;
+    if (type_str == "TcpSocket" || type_str == "tcp_socket") return IpcType::kTcpSocket;
+    if (type_str == "SharedMemory" || type_str == "shared_memory") return IpcType::kSharedMemory;
+    if (type_str == "EpollLocal" || type_str == "epoll_local") return IpcType::kEpollLocal;
     // 添加其他IPC类型的映射
     return IpcType::kLocalSocket; // 默认值或错误处理
 }
@@ -68,6 +134,9 @@ QString IpcCommunicationFactory::getIpcTypeString(IpcType type)
 {
     switch (type) {
         case IpcType::kLocalSocket: return "LocalSocket";
+        case IpcType::kTcpSocket: return "TcpSocket";
+        case IpcType::kSharedMemory: return "SharedMemory";
+        case IpcType::kEpollLocal: return "EpollLocal";
         // 添加其他IPC类型的映射
         default: return "Unknown";
     }
@@ -0,0 +1,478 @@
+#include "IIpcCommunication.h"
+#include "IpcRequestTracker.h"
+#include "IpcLivenessTable.h"
+#include <QUuid>
+#include <QDebug>
+#include <QMetaObject>
+#include <QTimer>
+#include <QDateTime>
+#include <algorithm>
+
+namespace {
+// 迁移期间检查旧策略剩余连接的间隔
+constexpr int kDrainCheckIntervalMs = 100;
+constexpr int kDefaultDrainTimeoutMs = 10000;
+}
+
+// IIpcCommunication 构造函数实现
+IIpcCommunication::IIpcCommunication(QObject* parent) : QObject(parent) {}
+
+// ================== IpcContext 策略模式实现 ==================
+
+IpcContext::IpcContext(QObject* parent) 
+    : QObject(parent), m_strategy(nullptr), m_current_strategy_type("none"),
+      m_request_tracker(std::make_unique<IpcRequestTracker>()),
+      m_liveness_table(std::make_shared<IpcLivenessTable>()) {
+}
+
+IpcContext::~IpcContext() {
+    if (m_draining_strategy) {
+        disconnect(m_draining_strategy.get(), nullptr, this, nullptr);
+        m_draining_strategy->stop();
+    }
+}
+
+bool IpcContext::setIpcStrategy(std::unique_ptr<IIpcCommunication> strategy) {
+    if (!strategy) {
+        qWarning() << "Cannot set null strategy";
+        return false;
+    }
+    
+    QString old_type = m_current_strategy_type;
+    
+    // 断开旧策略的信号连接
+    if (m_strategy) {
+        disconnectStrategySignals();
+        m_strategy->stop();
+    }
+    
+    // 设置新策略
+    m_strategy = std::move(strategy);
+    m_strategy->setLivenessTable(m_liveness_table);
+    m_current_strategy_type = "custom"; // 可以通过参数传入具体类型
+    
+    // 连接新策略的信号
+    connectStrategySignals();
+    
+    emit strategyChanged(old_type, m_current_strategy_type, true);
+    qDebug() << "IPC strategy changed from" << old_type << "to" << m_current_strategy_type;
+    
+    return true;
+}
+
+IIpcCommunication* IpcContext::getCurrentStrategy() const {
+    return m_strategy.get();
+}
+
+QString IpcContext::getCurrentStrategyType() const {
+    return m_current_strategy_type;
+}
+
+bool IpcContext::hasStrategy() const {
+    return m_strategy != nullptr;
+}
+
+bool IpcContext::switchStrategy(IpcType type, const QJsonObject& config) {
+    auto new_strategy = IpcCommunicationFactory::createIpcCommunication(type, config);
+    if (!new_strategy) {
+        qWarning() << "Failed to create strategy for type:" << IpcCommunicationFactory::getIpcTypeString(type);
+        return false;
+    }
+    
+    QString old_type = m_current_strategy_type;
+    m_current_strategy_type = IpcCommunicationFactory::getIpcTypeString(type);
+    
+    return setIpcStrategy(std::move(new_strategy));
+}
+
+bool IpcContext::gracefulSwitchStrategy(IpcType type, const QJsonObject& config) {
+    const QString old_type = m_current_strategy_type;
+    const QString new_type = IpcCommunicationFactory::getIpcTypeString(type);
+
+    auto new_strategy = IpcCommunicationFactory::createIpcCommunication(type, config);
+    if (!new_strategy) {
+        qWarning() << "[IpcContext] 创建新策略失败:" << new_type;
+        emit strategyChanged(old_type, new_type, false);
+        return false;
+    }
+    new_strategy->setLivenessTable(m_liveness_table);
+
+    // 上一次迁移尚未排空时直接收尾，同一时刻最多只有一个旧策略
+    if (m_draining_strategy) {
+        finishMigration();
+    }
+
+    const QJsonObject old_endpoint = m_strategy ? m_strategy->getEndpoint() : QJsonObject();
+    const QJsonObject new_endpoint = new_strategy->getEndpoint();
+    const bool can_migrate = m_strategy && m_strategy->getConnectedClientCount() > 0 &&
+                             !old_endpoint.isEmpty() && !new_endpoint.isEmpty() &&
+                             old_endpoint != new_endpoint;
+
+    if (!can_migrate) {
+        // 新旧策略无法同时监听（或没有客户端需要迁移）：先停止旧策略再启动新策略
+        qDebug() << "[IpcContext] 停止当前策略后切换:" << old_type << "->" << new_type;
+        if (m_strategy) {
+            disconnectStrategySignals();
+            m_strategy->stop();
+        }
+        m_strategy = std::move(new_strategy);
+        m_current_strategy_type = new_type;
+        connectStrategySignals();
+        const bool started = m_strategy->start();
+        if (!started) {
+            qWarning() << "[IpcContext] 新策略启动失败:" << m_strategy->getLastError();
+        }
+        emit strategyChanged(old_type, new_type, started);
+        return started;
+    }
+
+    // 迁移模式：新策略先监听，失败时保持当前策略不变
+    if (!new_strategy->start()) {
+        qWarning() << "[IpcContext] 新策略启动失败，保持当前策略:" << new_strategy->getLastError();
+        emit strategyChanged(old_type, new_type, false);
+        return false;
+    }
+
+    disconnectStrategySignals();
+    m_draining_strategy = std::move(m_strategy);
+    m_draining_strategy_type = old_type;
+    m_strategy = std::move(new_strategy);
+    m_current_strategy_type = new_type;
+    connectStrategySignals();
+    connectDrainingSignals();
+
+    m_migration_endpoint = m_strategy->getEndpoint();
+    const int drain_timeout_ms = config["migration_drain_timeout_ms"].toInt(kDefaultDrainTimeoutMs);
+    m_drain_deadline = QDeadlineTimer(std::max(0, drain_timeout_ms));
+    if (!m_drain_timer) {
+        m_drain_timer = std::make_unique<QTimer>();
+        m_drain_timer->setInterval(kDrainCheckIntervalMs);
+        connect(m_drain_timer.get(), &QTimer::timeout, this, &IpcContext::checkDrainProgress);
+    }
+    m_drain_timer->start();
+
+    qDebug() << "[IpcContext] 开始迁移:" << old_type << "->" << new_type
+             << "待迁移客户端:" << m_draining_strategy->getConnectedClientCount();
+    emit strategyChanged(old_type, new_type, true);
+    sendMigrationNotice(QString());
+    return true;
+}
+
+void IpcContext::sendMigrationNotice(const QString& client_id) {
+    if (!m_draining_strategy) return;
+
+    IpcMessage notice;
+    notice.type = MessageType::kCommand;
+    notice.topic = "migrate_endpoint";
+    notice.msg_id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    notice.timestamp = QDateTime::currentMSecsSinceEpoch();
+    notice.sender_id = "IpcContext";
+    notice.receiver_id = client_id;
+    notice.body = m_migration_endpoint;
+
+    const bool sent = client_id.isEmpty() ? m_draining_strategy->broadcastMessage(notice)
+                                          : m_draining_strategy->sendMessage(client_id, notice);
+    if (!sent) {
+        qWarning() << "[IpcContext] 迁移命令发送失败:" << m_draining_strategy->getLastError();
+    }
+}
+
+void IpcContext::checkDrainProgress() {
+    if (!m_draining_strategy) {
+        m_drain_timer->stop();
+        return;
+    }
+    if (m_draining_strategy->getConnectedClientCount() == 0 || m_drain_deadline.hasExpired()) {
+        finishMigration();
+    }
+}
+
+void IpcContext::finishMigration() {
+    if (m_drain_timer) {
+        m_drain_timer->stop();
+    }
+    if (!m_draining_strategy) return;
+
+    // 停止后才断开信号，stop()期间发出的clientDisconnected照常转发给上层清理
+    std::unique_ptr<IIpcCommunication> draining = std::move(m_draining_strategy);
+    const QString old_type = m_draining_strategy_type;
+    const int stranded_clients = draining->getConnectedClientCount();
+    if (stranded_clients > 0) {
+        qWarning() << "[IpcContext] 旧策略停止时仍有" << stranded_clients << "个客户端未迁移";
+    }
+    draining->stop();
+    disconnect(draining.get(), nullptr, this, nullptr);
+    draining.reset();
+
+    m_draining_strategy_type.clear();
+    m_migration_endpoint = QJsonObject();
+    qDebug() << "[IpcContext] 迁移结束，旧策略已停止:" << old_type;
+    emit strategyMigrationFinished(old_type, stranded_clients);
+}
+
+IIpcCommunication* IpcContext::strategyForSender(const QString& sender_id) const {
+    if (m_draining_strategy && m_strategy->getClientIdBySenderId(sender_id).isEmpty() &&
+        !m_draining_strategy->getClientIdBySenderId(sender_id).isEmpty()) {
+        return m_draining_strategy.get();
+    }
+    return m_strategy.get();
+}
+
+IIpcCommunication* IpcContext::strategyForClient(const QString& client_id) const {
+    if (m_draining_strategy && !m_strategy->isClientOnline(client_id) &&
+        m_draining_strategy->isClientOnline(client_id)) {
+        return m_draining_strategy.get();
+    }
+    return m_strategy.get();
+}
+
+void IpcContext::connectStrategySignals() {
+    if (!m_strategy) return;
+    
+    // 转发所有策略信号
+    connect(m_strategy.get(), &IIpcCommunication::messageReceived,
+            this, &IpcContext::onStrategyMessageReceived);
+    connect(m_strategy.get(), &IIpcCommunication::clientConnected,
+            this, &IpcContext::clientConnected);
+    connect(m_strategy.get(), &IIpcCommunication::clientDisconnected,
+            this, &IpcContext::onStrategyClientDisconnected);
+    connect(m_strategy.get(), &IIpcCommunication::connectionStateChanged,
+            this, &IpcContext::connectionStateChanged);
+    connect(m_strategy.get(), &IIpcCommunication::errorOccurred,
+            this, &IpcContext::errorOccurred);
+    connect(m_strategy.get(), &IIpcCommunication::topicSubscriptionChanged,
+            this, &IpcContext::topicSubscriptionChanged);
+}
+
+void IpcContext::connectDrainingSignals() {
+    if (!m_draining_strategy) return;
+
+    // 旧策略的连接状态变化不代表当前策略，不转发
+    connect(m_draining_strategy.get(), &IIpcCommunication::messageReceived,
+            this, &IpcContext::onStrategyMessageReceived);
+    connect(m_draining_strategy.get(), &IIpcCommunication::clientConnected,
+            this, [this](const QString& client_id) {
+                emit clientConnected(client_id);
+                // 迁移开始后才完成握手的客户端错过了广播，单独补发
+                sendMigrationNotice(client_id);
+            });
+    connect(m_draining_strategy.get(), &IIpcCommunication::clientDisconnected,
+            this, &IpcContext::clientDisconnected);
+    connect(m_draining_strategy.get(), &IIpcCommunication::errorOccurred,
+            this, &IpcContext::errorOccurred);
+    connect(m_draining_strategy.get(), &IIpcCommunication::topicSubscriptionChanged,
+            this, &IpcContext::topicSubscriptionChanged);
+}
+
+void IpcContext::onStrategyMessageReceived(const IpcMessage& message) {
+    if (message.type == MessageType::kCommandResponse) {
+        m_request_tracker->complete(message);
+    }
+    emit messageReceived(message);
+}
+
+void IpcContext::onStrategyClientDisconnected(const QString& client_id) {
+    // 旧策略上的断开多为迁移重连，响应会经新连接到达，只处理当前策略
+    m_request_tracker->failReceiver(client_id, "目标已断开");
+    emit clientDisconnected(client_id);
+}
+
+void IpcContext::disconnectStrategySignals() {
+    if (!m_strategy) return;
+    
+    // 断开所有信号连接
+    disconnect(m_strategy.get(), nullptr, this, nullptr);
+}
+
+// === 代理所有IIpcCommunication接口方法 ===
+
+bool IpcContext::initialize(const QJsonObject& config) {
+    if (!m_strategy) {
+        qWarning() << "No strategy set, cannot initialize";
+        return false;
+    }
+    return m_strategy->initialize(config);
+}
+
+bool IpcContext::start() {
+    if (!m_strategy) {
+        qWarning() << "No strategy set, cannot start";
+        return false;
+    }
+    return m_strategy->start();
+}
+
+void IpcContext::stop() {
+    finishMigration();
+    if (m_strategy) {
+        m_strategy->stop();
+    }
+}
+
+ConnectionState IpcContext::getConnectionState() const {
+    if (!m_strategy) {
+        return ConnectionState::kDisconnected;
+    }
+    return m_strategy->getConnectionState();
+}
+
+bool IpcContext::sendMessage(const IpcMessage& message) {
+    if (!m_strategy) {
+        qWarning() << "No strategy set, cannot send message";
+        return false;
+    }
+    return strategyForSender(message.receiver_id)->sendMessage(message);
+}
+
+bool IpcContext::broadcastMessage(const IpcMessage& message) {
+    if (!m_strategy) {
+        qWarning() << "No strategy set, cannot broadcast message";
+        return false;
+    }
+    const bool sent = m_strategy->broadcastMessage(message);
+    if (m_draining_strategy) {
+        return m_draining_strategy->broadcastMessage(message) || sent;
+    }
+    return sent;
+}
+
+bool IpcContext::publishToTopic(const QString& topic, const IpcMessage& message) {
+    if (!m_strategy) {
+        qWarning() << "No strategy set, cannot publish to topic";
+        return false;
+    }
+    const bool published = m_strategy->publishToTopic(topic, message);
+    if (m_draining_strategy) {
+        return m_draining_strategy->publishToTopic(topic, message) || published;
+    }
+    return published;
+}
+
+bool IpcContext::subscribeToTopic(const QString& topic) {
+    if (!m_strategy) {
+        qWarning() << "No strategy set, cannot subscribe to topic";
+        return false;
+    }
+    return m_strategy->subscribeToTopic(topic);
+}
+
+bool IpcContext::unsubscribeFromTopic(const QString& topic) {
+    if (!m_strategy) {
+        qWarning() << "No strategy set, cannot unsubscribe from topic";
+        return false;
+    }
+    return m_strategy->unsubscribeFromTopic(topic);
+}
+
+QStringList IpcContext::getSubscribedTopics() const {
+    if (!m_strategy) {
+        return QStringList();
+    }
+    return m_strategy->getSubscribedTopics();
+}
+
+int IpcContext::getConnectedClientCount() const {
+    if (!m_strategy) {
+        return 0;
+    }
+    const int count = m_strategy->getConnectedClientCount();
+    if (m_draining_strategy) {
+        return count + m_draining_strategy->getConnectedClientCount();
+    }
+    return count;
+}
+
+QStringList IpcContext::getConnectedClientIds() const {
+    if (!m_strategy) {
+        return QStringList();
+    }
+    QStringList client_ids = m_strategy->getConnectedClientIds();
+    if (m_draining_strategy) {
+        client_ids += m_draining_strategy->getConnectedClientIds();
+    }
+    return client_ids;
+}
+
+bool IpcContext::disconnectClient(const QString& client_id) {
+    if (!m_strategy) {
+        qWarning() << "No strategy set, cannot disconnect client";
+        return false;
+    }
+    return strategyForClient(client_id)->disconnectClient(client_id);
+}
+
+bool IpcContext::isClientOnline(const QString& client_id) const {
+    if (!m_strategy) {
+        return false;
+    }
+    return strategyForClient(client_id)->isClientOnline(client_id);
+}
+
+QString IpcContext::getLastError() const {
+    if (!m_strategy) {
+        return "No strategy set";
+    }
+    return m_strategy->getLastError();
+}
+
+QString IpcContext::getClientIdBySenderId(const QString& sender_id) const {
+    if (!m_strategy) {
+        qDebug() << "[IpcContext] 没有策略，无法获取客户端ID";
+        return QString();
+    }
+    return strategyForSender(sender_id)->getClientIdBySenderId(sender_id);
+}
+
+QFuture<IpcRequestResult> IpcContext::sendRequest(IpcMessage request, int timeout_ms, const QString& name) {
+    if (request.msg_id.isEmpty()) {
+        request.msg_id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    }
+    const QString request_name = name.isEmpty() ? request.topic : name;
+
+    if (!m_strategy) {
+        QFuture<IpcRequestResult> future = m_request_tracker->track(request.msg_id, request_name, timeout_ms);
+        m_request_tracker->fail(request.msg_id, "IPC策略未设置");
+        return future;
+    }
+
+    // 按目标连接的内部ID登记，与clientDisconnected携带的ID一致，目标断开时立即失败
+    IIpcCommunication* strategy = strategyForSender(request.receiver_id);
+    const QString connection_id = request.receiver_id.isEmpty()
+        ? QString()
+        : strategy->getClientIdBySenderId(request.receiver_id);
+
+    // 先登记再发送，避免响应先于登记到达
+    QFuture<IpcRequestResult> future =
+        m_request_tracker->track(request.msg_id, request_name, timeout_ms, connection_id);
+    if (!strategy->sendMessage(request)) {
+        m_request_tracker->fail(request.msg_id, strategy->getLastError());
+    }
+    return future;
+}
+
+QJsonObject IpcContext::getRequestStatistics() const {
+    return m_request_tracker->statistics();
+}
+
+QJsonObject IpcContext::getStatistics() const {
+    if (!m_strategy) {
+        return QJsonObject();
+    }
+    QJsonObject stats = m_strategy->getStatistics();
+    if (m_draining_strategy) {
+        QJsonObject draining = m_draining_strategy->getStatistics();
+        draining["type"] = m_draining_strategy_type;
+        draining["remaining_clients"] = m_draining_strategy->getConnectedClientCount();
+        draining["remaining_ms"] = m_drain_deadline.remainingTime();
+        stats["draining"] = draining;
+    }
+    return stats;
+}
+
+bool IpcContext::sendMessage(const QString& client_id, const IpcMessage& message) {
+    if (!m_strategy) {
+        qWarning() << "No strategy set, cannot send message";
+        return false;
+    }
+    return strategyForClient(client_id)->sendMessage(client_id, message);
+}
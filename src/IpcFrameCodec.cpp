@@ -0,0 +1,306 @@
+#include "IpcFrameCodec.h"
+#include "IpcJsonText.h"
+#include <QDebug>
+#include <QJsonDocument>
+#include <QUuid>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+    constexpr const char* kCodecNameJson = "json";
+    constexpr const char* kCodecNameCbor = "cbor";
+    constexpr int kMaxFieldLength = 0xFFFF;
+    constexpr quint8 kCborMajorTypeMask = 0xE0;
+    constexpr quint8 kCborMajorTypeMap = 0xA0;
+}
+
+QByteArray IpcFrameCodec::encode(const IpcMessage& message, IpcCodecType codec)
+{
+    if (codec == IpcCodecType::kCbor) {
+        QByteArray frame = encodeBinary(message);
+        if (!frame.isEmpty()) {
+            return frame;
+        }
+        // 字段超长无法放入二进制头，退回JSON帧（解码端可混合处理）
+    }
+
+    QByteArray frame = message.toByteArray();
+    frame.append('\n');
+    return frame;
+}
+
+IpcFrameCodec::DecodeStatus IpcFrameCodec::decode(QByteArrayView data, IpcMessage* message, qsizetype* consumed)
+{
+    *consumed = 0;
+    if (data.isEmpty()) {
+        return DecodeStatus::kNeedMoreData;
+    }
+    if (static_cast<quint8>(data.at(0)) == kFrameMagic) {
+        return decodeBinary(data, message, consumed);
+    }
+    if (isHeartbeatFrame(data)) {
+        Heartbeat heartbeat;
+        const DecodeStatus status = decodeHeartbeat(data, &heartbeat, consumed);
+        if (status == DecodeStatus::kOk) {
+            *message = IpcMessage{};
+            message->type = heartbeat.ack ? MessageType::kHeartbeatAck : MessageType::kHeartbeat;
+            message->timestamp = heartbeat.timestamp;
+        }
+        return status;
+    }
+    return decodeJsonLine(data, message, consumed);
+}
+
+QByteArray IpcFrameCodec::encodeHeartbeat(const Heartbeat& heartbeat)
+{
+    QByteArray frame(kHeartbeatFrameSize, Qt::Uninitialized);
+    uchar* header = reinterpret_cast<uchar*>(frame.data());
+    header[0] = kHeartbeatMagic;
+    header[1] = kFrameVersion;
+    header[2] = heartbeat.ack ? 1 : 0;
+    header[3] = 0;
+    qToLittleEndian<quint32>(heartbeat.sequence, header + 4);
+    qToLittleEndian<qint64>(heartbeat.timestamp, header + 8);
+    return frame;
+}
+
+IpcFrameCodec::DecodeStatus IpcFrameCodec::decodeHeartbeat(QByteArrayView data, Heartbeat* heartbeat,
+                                                           qsizetype* consumed)
+{
+    *consumed = 0;
+    if (data.size() < kHeartbeatFrameSize) {
+        return DecodeStatus::kNeedMoreData;
+    }
+    *consumed = kHeartbeatFrameSize;
+
+    const uchar* header = reinterpret_cast<const uchar*>(data.data());
+    if (header[1] != kFrameVersion || header[2] > 1) {
+        qWarning() << "[IpcFrameCodec] 心跳帧无效，版本:" << header[1] << "类型:" << header[2];
+        return DecodeStatus::kError;
+    }
+    heartbeat->ack = header[2] == 1;
+    heartbeat->sequence = qFromLittleEndian<quint32>(header + 4);
+    heartbeat->timestamp = qFromLittleEndian<qint64>(header + 8);
+    return DecodeStatus::kOk;
+}
+
+IpcCodecType IpcFrameCodec::negotiate(const QJsonArray& offered)
+{
+    // 按主控优先级选择双方都支持的第一个编码
+    const QJsonArray supported = supportedCodecs();
+    for (const QJsonValue& candidate : supported) {
+        if (offered.contains(candidate)) {
+            return codecFromName(candidate.toString());
+        }
+    }
+    return IpcCodecType::kJson;
+}
+
+QJsonArray IpcFrameCodec::supportedCodecs()
+{
+    return QJsonArray{QString(kCodecNameCbor), QString(kCodecNameJson)};
+}
+
+QString IpcFrameCodec::codecName(IpcCodecType codec)
+{
+    switch (codec) {
+        case IpcCodecType::kCbor: return kCodecNameCbor;
+        case IpcCodecType::kJson:
+        default: return kCodecNameJson;
+    }
+}
+
+IpcCodecType IpcFrameCodec::codecFromName(const QString& name, IpcCodecType fallback)
+{
+    if (name == QLatin1String(kCodecNameCbor)) return IpcCodecType::kCbor;
+    if (name == QLatin1String(kCodecNameJson)) return IpcCodecType::kJson;
+    return fallback;
+}
+
+QByteArray IpcFrameCodec::encodeBinary(const IpcMessage& message)
+{
+    const QByteArray topic = message.topic.toUtf8();
+    const QByteArray sender = message.sender_id.toUtf8();
+    const QByteArray receiver = message.receiver_id.toUtf8();
+
+    // msg_id 是规范UUID时放入定长头，否则以文本放入变长区，保证往返一致
+    quint8 flags = 0;
+    const QUuid uuid = QUuid::fromString(message.msg_id);
+    QByteArray text_msg_id;
+    if (!message.msg_id.isEmpty() && uuid.toString(QUuid::WithoutBraces) != message.msg_id) {
+        flags |= kFlagTextMsgId;
+        text_msg_id = message.msg_id.toUtf8();
+    }
+
+    if (topic.size() > kMaxFieldLength || sender.size() > kMaxFieldLength ||
+        receiver.size() > kMaxFieldLength || text_msg_id.size() > kMaxFieldLength) {
+        return QByteArray();
+    }
+
+    // 未修改的CBOR消息体原样写出
+    const QByteArray body = message.body.toCbor();
+
+    const qsizetype payload_size = text_msg_id.size() + topic.size() + sender.size() +
+                                   receiver.size() + body.size();
+    if (payload_size > kMaxPayloadSize) {
+        qWarning() << "[IpcFrameCodec] 消息体过大，无法编码为二进制帧:" << payload_size;
+        return QByteArray();
+    }
+
+    QByteArray frame(kHeaderSize + payload_size, Qt::Uninitialized);
+    uchar* header = reinterpret_cast<uchar*>(frame.data());
+    header[0] = kFrameMagic;
+    header[1] = kFrameVersion;
+    header[2] = static_cast<quint8>(message.type);
+    header[3] = flags;
+    qToLittleEndian<quint32>(static_cast<quint32>(payload_size), header + 4);
+    qToLittleEndian<qint64>(message.timestamp, header + 8);
+    const QByteArray rfc4122 = (flags & kFlagTextMsgId) ? QUuid().toRfc4122() : uuid.toRfc4122();
+    std::memcpy(header + 16, rfc4122.constData(), 16);
+    qToLittleEndian<quint16>(static_cast<quint16>(topic.size()), header + 32);
+    qToLittleEndian<quint16>(static_cast<quint16>(sender.size()), header + 34);
+    qToLittleEndian<quint16>(static_cast<quint16>(receiver.size()), header + 36);
+    qToLittleEndian<quint16>(static_cast<quint16>(text_msg_id.size()), header + 38);
+
+    char* cursor = frame.data() + kHeaderSize;
+    const QByteArray* parts[] = {&text_msg_id, &topic, &sender, &receiver, &body};
+    for (const QByteArray* part : parts) {
+        if (!part->isEmpty()) {
+            std::memcpy(cursor, part->constData(), part->size());
+            cursor += part->size();
+        }
+    }
+    return frame;
+}
+
+IpcFrameCodec::DecodeStatus IpcFrameCodec::decodeBinary(QByteArrayView data, IpcMessage* message, qsizetype* consumed)
+{
+    if (data.size() < kHeaderSize) {
+        return DecodeStatus::kNeedMoreData;
+    }
+
+    const uchar* header = reinterpret_cast<const uchar*>(data.data());
+    const quint32 payload_size = qFromLittleEndian<quint32>(header + 4);
+    if (header[1] != kFrameVersion || payload_size > kMaxPayloadSize) {
+        // 无法确定帧边界，丢弃全部已缓存数据
+        qWarning() << "[IpcFrameCodec] 二进制帧头无效，版本:" << header[1] << "负载长度:" << payload_size;
+        *consumed = data.size();
+        return DecodeStatus::kError;
+    }
+
+    const qsizetype frame_size = kHeaderSize + payload_size;
+    if (data.size() < frame_size) {
+        return DecodeStatus::kNeedMoreData;
+    }
+    *consumed = frame_size;
+
+    const quint8 type = header[2];
+    const quint8 flags = header[3];
+    const quint16 topic_len = qFromLittleEndian<quint16>(header + 32);
+    const quint16 sender_len = qFromLittleEndian<quint16>(header + 34);
+    const quint16 receiver_len = qFromLittleEndian<quint16>(header + 36);
+    const quint16 msg_id_len = (flags & kFlagTextMsgId) ? qFromLittleEndian<quint16>(header + 38) : 0;
+    const qsizetype strings_size = qsizetype(msg_id_len) + topic_len + sender_len + receiver_len;
+
+    if (type > static_cast<quint8>(MessageType::kShutdown) || strings_size > payload_size) {
+        qWarning() << "[IpcFrameCodec] 二进制帧内容无效，类型:" << type;
+        return DecodeStatus::kError;
+    }
+
+    const char* cursor = data.data() + kHeaderSize;
+    message->type = static_cast<MessageType>(type);
+    message->timestamp = qFromLittleEndian<qint64>(header + 8);
+    if (flags & kFlagTextMsgId) {
+        message->msg_id = QString::fromUtf8(cursor, msg_id_len);
+        cursor += msg_id_len;
+    } else {
+        const QUuid uuid = QUuid::fromRfc4122(QByteArrayView(data.data() + 16, 16));
+        message->msg_id = uuid.isNull() ? QString() : uuid.toString(QUuid::WithoutBraces);
+    }
+    message->topic = QString::fromUtf8(cursor, topic_len);
+    cursor += topic_len;
+    message->sender_id = QString::fromUtf8(cursor, sender_len);
+    cursor += sender_len;
+    message->receiver_id = QString::fromUtf8(cursor, receiver_len);
+    cursor += receiver_len;
+
+    const qsizetype body_size = payload_size - strings_size;
+    message->body = IpcMessageBody();
+    // 消息体只保留原始字节，首次读取时再解析；非map的消息体按空处理
+    if (body_size > 0 && (static_cast<quint8>(*cursor) & kCborMajorTypeMask) == kCborMajorTypeMap) {
+        message->body = IpcMessageBody::fromRaw(QByteArray(cursor, body_size), IpcMessageBody::Encoding::kCbor);
+    }
+    return DecodeStatus::kOk;
+}
+
+IpcFrameCodec::DecodeStatus IpcFrameCodec::decodeJsonLine(QByteArrayView data, IpcMessage* message, qsizetype* consumed)
+{
+    const void* newline = std::memchr(data.data(), '\n', data.size());
+    if (!newline) {
+        return DecodeStatus::kNeedMoreData;
+    }
+
+    const qsizetype line_size = static_cast<const char*>(newline) - data.data();
+    *consumed = line_size + 1;
+    if (line_size == 0) {
+        return DecodeStatus::kSkipped;
+    }
+
+    const QByteArrayView line = data.first(line_size);
+    if (scanJsonEnvelope(line, message)) {
+        return DecodeStatus::kOk;
+    }
+
+    // 扫描失败（格式错误或键含转义）时退回完整解析，由QJsonDocument报告错误
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(QByteArray::fromRawData(line.data(), line.size()), &error);
+    if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+        qWarning() << "[IpcFrameCodec] JSON帧解析失败:" << error.errorString();
+        return DecodeStatus::kError;
+    }
+
+    *message = IpcMessage::fromJson(doc.object());
+    return DecodeStatus::kOk;
+}
+
+bool IpcFrameCodec::scanJsonEnvelope(QByteArrayView line, IpcMessage* message)
+{
+    IpcMessage scanned;
+    scanned.type = MessageType::kHello;
+    scanned.timestamp = 0;
+    bool valid = true;
+
+    const auto toText = [&valid](QByteArrayView value) {
+        const QJsonValue text = IpcJsonText::toValue(value);
+        if (text.isUndefined()) {
+            valid = false;
+        }
+        return text.toString();
+    };
+
+    const bool scanned_ok = IpcJsonText::forEachMember(line, [&](QByteArrayView key, QByteArrayView value) {
+        if (key == "type") {
+            scanned.type = static_cast<MessageType>(IpcJsonText::toValue(value).toInt());
+        } else if (key == "topic") {
+            scanned.topic = toText(value);
+        } else if (key == "msg_id") {
+            scanned.msg_id = toText(value);
+        } else if (key == "timestamp") {
+            scanned.timestamp = IpcJsonText::toValue(value).toVariant().toLongLong();
+        } else if (key == "sender_id") {
+            scanned.sender_id = toText(value);
+        } else if (key == "receiver_id") {
+            scanned.receiver_id = toText(value);
+        } else if (key == "body" && value.startsWith('{')) {
+            // 消息体保留原始JSON文本，首次读取时再解析
+            scanned.body = IpcMessageBody::fromRaw(value.toByteArray(), IpcMessageBody::Encoding::kJson);
+        }
+        return valid;
+    });
+
+    if (!scanned_ok || !valid) {
+        return false;
+    }
+    *message = std::move(scanned);
+    return true;
+}
@@ -0,0 +1,148 @@
+#ifndef MASTER_SRC_IPCFRAMECODEC_H_
+#define MASTER_SRC_IPCFRAMECODEC_H_
+
+#include "IIpcCommunication.h"
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QJsonArray>
+#include <QString>
+
+/**
+ * @brief IPC消息线上编码类型
+ */
+enum class IpcCodecType {
+    kJson = 0,           // 换行分隔的JSON文本（默认，兼容旧插件）
+    kCbor                // 定长二进制头 + CBOR消息体
+};
+
+/**
+ * @brief IPC帧编解码器
+ *
+ * 负责IpcMessage与字节流之间的转换，支持两种帧格式：
+ * - JSON帧：IpcMessage::toByteArray() + '\n'
+ * - 二进制帧：40字节定长头 + 变长区（msg_id文本、topic、sender_id、receiver_id）+ CBOR消息体
+ *
+ * 二进制帧头布局（小端序）：
+ *   [0]  magic (kFrameMagic)   [1]  version   [2]  type   [3]  flags
+ *   [4]  payload_length (u32，头之后的字节数)
+ *   [8]  timestamp (i64)
+ *   [16] msg_id (16字节RFC4122 UUID)
+ *   [32] topic_len (u16)  [34] sender_len (u16)  [36] receiver_len (u16)  [38] msg_id_len (u16)
+ *
+ * 解码只解析路由头，消息体以原始字节保存在 IpcMessageBody 中按需解析；
+ * 未修改的消息体以同一编码重新编码时原样写出。
+ *
+ * 两种帧可以在同一条连接上混合出现：二进制帧以 kFrameMagic 开头，
+ * JSON帧总是以 '{' 开头，解码时按首字节区分。
+ *
+ * 紧凑心跳帧：16字节定长，与编码协商无关，可与上述两种帧混合出现（小端序）：
+ *   [0]  magic (kHeartbeatMagic)   [1]  version   [2]  kind (0 心跳 / 1 应答)   [3]  保留
+ *   [4]  sequence (u32)   [8]  timestamp (i64，发送方毫秒时间)
+ * 应答原样回显序号与时间戳，发送方据此计算往返时延。插件在kHello消息体中携带
+ * "heartbeat": "compact"，主控在kHelloAck中回复相同字段表示支持。
+ *
+ * 编码协商：插件在kHello消息体中携带 "codecs": ["cbor", "json"]，主控在
+ * kHelloAck消息体中以 "codec" 字段回复选定的编码。kHelloAck本身总以JSON发送，
+ * 此后双方改用协商结果；未携带 "codecs" 的插件保持JSON。
+ */
+class IpcFrameCodec {
+public:
+    static constexpr quint8 kFrameMagic = 0xC5;
+    static constexpr quint8 kFrameVersion = 1;
+    static constexpr qsizetype kHeaderSize = 40;
+    static constexpr quint32 kMaxPayloadSize = 64 * 1024 * 1024;
+    static constexpr quint8 kHeartbeatMagic = 0xC6;
+    static constexpr qsizetype kHeartbeatFrameSize = 16;
+
+    /**
+     * @brief 紧凑心跳帧的内容
+     */
+    struct Heartbeat {
+        bool ack = false;        // 是否为应答
+        quint32 sequence = 0;    // 心跳序号
+        qint64 timestamp = 0;    // 发送方毫秒时间，应答时回显
+    };
+
+    /**
+     * @brief 二进制帧头标志位
+     */
+    enum FrameFlag : quint8 {
+        kFlagTextMsgId = 0x01    // msg_id不是规范UUID，以文本形式放在变长区
+    };
+
+    /**
+     * @brief 解码结果
+     */
+    enum class DecodeStatus {
+        kOk = 0,                 // 成功解出一帧
+        kNeedMoreData,           // 数据不足一帧，未消费任何数据
+        kSkipped,                // 空行等无内容数据，已消费
+        kError                   // 帧格式错误，已消费出错的数据
+    };
+
+    /**
+     * @brief 将消息编码为一个完整的帧
+     * @param message 要编码的消息
+     * @param codec 线上编码类型
+     * @return 帧字节
+     */
+    static QByteArray encode(const IpcMessage& message, IpcCodecType codec);
+
+    /**
+     * @brief 从数据开头解码一帧
+     * @param data 待解码数据
+     * @param message 输出的消息（仅在kOk时有效）
+     * @param consumed 输出本次消费的字节数
+     * @return 解码结果
+     */
+    static DecodeStatus decode(QByteArrayView data, IpcMessage* message, qsizetype* consumed);
+
+    /**
+     * @brief 编码一个紧凑心跳帧
+     */
+    static QByteArray encodeHeartbeat(const Heartbeat& heartbeat);
+
+    /**
+     * @brief 数据是否以紧凑心跳帧开头，传输层据此在完整解码之前分流
+     */
+    static bool isHeartbeatFrame(QByteArrayView data)
+    {
+        return !data.isEmpty() && static_cast<quint8>(data.at(0)) == kHeartbeatMagic;
+    }
+
+    /**
+     * @brief 从数据开头解码一个紧凑心跳帧
+     *
+     * decode() 遇到紧凑心跳帧时同样可以解出，得到type为kHeartbeat/kHeartbeatAck、
+     * 其余字段为空的消息，供不区分心跳的调用方使用。
+     */
+    static DecodeStatus decodeHeartbeat(QByteArrayView data, Heartbeat* heartbeat, qsizetype* consumed);
+
+    /**
+     * @brief 根据插件在kHello中提供的编码列表选择编码
+     * @param offered 插件支持的编码名称列表
+     * @return 选定的编码
+     */
+    static IpcCodecType negotiate(const QJsonArray& offered);
+
+    /**
+     * @brief 主控支持的编码名称列表（按优先级排序）
+     */
+    static QJsonArray supportedCodecs();
+
+    static QString codecName(IpcCodecType codec);
+    static IpcCodecType codecFromName(const QString& name, IpcCodecType fallback = IpcCodecType::kJson);
+
+private:
+    static QByteArray encodeBinary(const IpcMessage& message);
+    static DecodeStatus decodeBinary(QByteArrayView data, IpcMessage* message, qsizetype* consumed);
+    static DecodeStatus decodeJsonLine(QByteArrayView data, IpcMessage* message, qsizetype* consumed);
+
+    /**
+     * @brief 只扫描JSON帧的信封：路由头直接取值，消息体保留原始文本
+     * @return 扫描失败返回false，由调用方退回完整解析
+     */
+    static bool scanJsonEnvelope(QByteArrayView line, IpcMessage* message);
+};
+
+#endif // MASTER_SRC_IPCFRAMECODEC_H_
@@ -0,0 +1,159 @@
+#include "IpcJsonText.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QString>
+
+qsizetype IpcJsonText::skipWhitespace(QByteArrayView text, qsizetype pos)
+{
+    while (pos < text.size()) {
+        const char c = text.at(pos);
+        if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+            break;
+        }
+        ++pos;
+    }
+    return pos;
+}
+
+qsizetype IpcJsonText::skipValue(QByteArrayView text, qsizetype pos)
+{
+    if (pos >= text.size()) {
+        return -1;
+    }
+
+    const char first = text.at(pos);
+    if (first == '"') {
+        for (qsizetype i = pos + 1; i < text.size(); ++i) {
+            const char c = text.at(i);
+            if (c == '\\') {
+                ++i;
+            } else if (c == '"') {
+                return i + 1;
+            }
+        }
+        return -1;
+    }
+
+    if (first == '{' || first == '[') {
+        // 只数括号深度，字符串内的括号整体跳过
+        int depth = 0;
+        qsizetype i = pos;
+        while (i < text.size()) {
+            const char c = text.at(i);
+            if (c == '"') {
+                i = skipValue(text, i);
+                if (i < 0) {
+                    return -1;
+                }
+                continue;
+            }
+            if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (--depth == 0) {
+                    return i + 1;
+                }
+            }
+            ++i;
+        }
+        return -1;
+    }
+
+    // 数字、true、false、null
+    qsizetype i = pos;
+    while (i < text.size()) {
+        const char c = text.at(i);
+        if (c == ',' || c == '}' || c == ']' || c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            break;
+        }
+        ++i;
+    }
+    return i > pos ? i : -1;
+}
+
+bool IpcJsonText::isEmptyObject(QByteArrayView object_text)
+{
+    qsizetype pos = skipWhitespace(object_text, 0);
+    if (pos >= object_text.size() || object_text.at(pos) != '{') {
+        return false;
+    }
+    pos = skipWhitespace(object_text, pos + 1);
+    return pos < object_text.size() && object_text.at(pos) == '}';
+}
+
+QJsonValue IpcJsonText::toValue(QByteArrayView value_text)
+{
+    if (value_text.isEmpty()) {
+        return QJsonValue(QJsonValue::Undefined);
+    }
+
+    const char first = value_text.at(0);
+    if (first == '"' && value_text.size() >= 2 && !value_text.contains('\\')) {
+        return QString::fromUtf8(value_text.sliced(1, value_text.size() - 2));
+    }
+    if (value_text == "true") {
+        return true;
+    }
+    if (value_text == "false") {
+        return false;
+    }
+    if (value_text == "null") {
+        return QJsonValue(QJsonValue::Null);
+    }
+    if (first == '-' || (first >= '0' && first <= '9')) {
+        bool ok = false;
+        const bool is_integer = !value_text.contains('.') && !value_text.contains('e') &&
+                                !value_text.contains('E');
+        if (is_integer) {
+            const qint64 integer = value_text.toLongLong(&ok);
+            if (ok) {
+                return integer;
+            }
+        }
+        const double number = value_text.toDouble(&ok);
+        return ok ? QJsonValue(number) : QJsonValue(QJsonValue::Undefined);
+    }
+
+    // 对象、数组和带转义的字符串包进数组交给Qt解析
+    QByteArray wrapped;
+    wrapped.reserve(value_text.size() + 2);
+    wrapped.append('[').append(value_text).append(']');
+    const QJsonDocument doc = QJsonDocument::fromJson(wrapped);
+    if (!doc.isArray() || doc.array().isEmpty()) {
+        return QJsonValue(QJsonValue::Undefined);
+    }
+    return doc.array().first();
+}
+
+void IpcJsonText::appendString(QByteArray* out, QStringView text)
+{
+    static const char kHex[] = "0123456789abcdef";
+
+    const QByteArray utf8 = text.toUtf8();
+    out->append('"');
+    qsizetype run_start = 0;
+    for (qsizetype i = 0; i < utf8.size(); ++i) {
+        const uchar c = static_cast<uchar>(utf8.at(i));
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        out->append(utf8.constData() + run_start, i - run_start);
+        switch (c) {
+            case '"': out->append("\\\""); break;
+            case '\\': out->append("\\\\"); break;
+            case '\n': out->append("\\n"); break;
+            case '\r': out->append("\\r"); break;
+            case '\t': out->append("\\t"); break;
+            case '\b': out->append("\\b"); break;
+            case '\f': out->append("\\f"); break;
+            default:
+                out->append("\\u00");
+                out->append(kHex[c >> 4]);
+                out->append(kHex[c & 0x0F]);
+                break;
+        }
+        run_start = i + 1;
+    }
+    out->append(utf8.constData() + run_start, utf8.size() - run_start);
+    out->append('"');
+}
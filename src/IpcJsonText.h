@@ -0,0 +1,108 @@
+#ifndef MASTER_SRC_IPCJSONTEXT_H_
+#define MASTER_SRC_IPCJSONTEXT_H_
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QJsonValue>
+#include <QStringView>
+
+/**
+ * @brief JSON文本的轻量扫描与拼接
+ *
+ * 只做定位不建DOM：按顶层成员切出键和值的原始字节，供解码端只取
+ * 路由头、把消息体原样保留。扫描器不校验值的内部结构，调用方在
+ * 需要时再交给 QJsonDocument 完整解析。
+ */
+class IpcJsonText {
+public:
+    /**
+     * @brief 跳过空白字符
+     * @return 第一个非空白字符的下标（可能等于 text.size()）
+     */
+    static qsizetype skipWhitespace(QByteArrayView text, qsizetype pos);
+
+    /**
+     * @brief 跳过一个完整的JSON值（字符串、对象、数组或标量）
+     * @return 值结束后的下标，格式错误返回-1
+     */
+    static qsizetype skipValue(QByteArrayView text, qsizetype pos);
+
+    /**
+     * @brief 遍历JSON对象文本的顶层成员
+     * @param object_text 以 '{' 开头的对象文本
+     * @param visitor bool(QByteArrayView key, QByteArrayView value)，key不含引号，
+     *        value为原始字节；返回false提前结束遍历
+     * @return 扫描完成（或被提前结束）返回true；格式错误或键含转义字符返回false
+     */
+    template <typename Visitor>
+    static bool forEachMember(QByteArrayView object_text, Visitor&& visitor)
+    {
+        qsizetype pos = skipWhitespace(object_text, 0);
+        if (pos >= object_text.size() || object_text.at(pos) != '{') {
+            return false;
+        }
+        pos = skipWhitespace(object_text, pos + 1);
+        if (pos < object_text.size() && object_text.at(pos) == '}') {
+            return true;
+        }
+        while (pos < object_text.size()) {
+            if (object_text.at(pos) != '"') {
+                return false;
+            }
+            const qsizetype key_end = skipValue(object_text, pos);
+            if (key_end < 0) {
+                return false;
+            }
+            const QByteArrayView key = object_text.sliced(pos + 1, key_end - pos - 2);
+            if (key.contains('\\')) {
+                return false;
+            }
+
+            pos = skipWhitespace(object_text, key_end);
+            if (pos >= object_text.size() || object_text.at(pos) != ':') {
+                return false;
+            }
+            const qsizetype value_start = skipWhitespace(object_text, pos + 1);
+            const qsizetype value_end = skipValue(object_text, value_start);
+            if (value_end < 0) {
+                return false;
+            }
+            if (!visitor(key, object_text.sliced(value_start, value_end - value_start))) {
+                return true;
+            }
+
+            pos = skipWhitespace(object_text, value_end);
+            if (pos >= object_text.size()) {
+                return false;
+            }
+            if (object_text.at(pos) == '}') {
+                return true;
+            }
+            if (object_text.at(pos) != ',') {
+                return false;
+            }
+            pos = skipWhitespace(object_text, pos + 1);
+        }
+        return false;
+    }
+
+    /**
+     * @brief 判断对象文本是否为空对象 {}
+     */
+    static bool isEmptyObject(QByteArrayView object_text);
+
+    /**
+     * @brief 把一个值的原始字节转换为QJsonValue
+     *
+     * 不含转义的字符串、数字、布尔和null直接转换，其余交给 QJsonDocument。
+     * @return 格式错误时返回 QJsonValue::Undefined
+     */
+    static QJsonValue toValue(QByteArrayView value_text);
+
+    /**
+     * @brief 以JSON字符串字面量（带引号、按需转义）追加文本
+     */
+    static void appendString(QByteArray* out, QStringView text);
+};
+
+#endif // MASTER_SRC_IPCJSONTEXT_H_
@@ -0,0 +1,29 @@
+#include "IpcLivenessTable.h"
+#include <chrono>
+
+qint64 IpcLivenessTable::nowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::shared_ptr<IpcLivenessTable::Entry> IpcLivenessTable::acquire(const QString& logical_id)
+{
+    QMutexLocker locker(&mutex_);
+    std::shared_ptr<Entry>& entry = entries_[logical_id];
+    if (!entry) {
+        entry = std::make_shared<Entry>();
+    }
+    entry->touch();
+    return entry;
+}
+
+qint64 IpcLivenessTable::idleMs(const QString& logical_id) const
+{
+    QMutexLocker locker(&mutex_);
+    const auto it = entries_.constFind(logical_id);
+    if (it == entries_.constEnd()) {
+        return -1;
+    }
+    return nowMs() - it.value()->last_seen_ms.load(std::memory_order_relaxed);
+}
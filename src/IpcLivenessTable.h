@@ -0,0 +1,51 @@
+#ifndef MASTER_SRC_IPCLIVENESSTABLE_H_
+#define MASTER_SRC_IPCLIVENESSTABLE_H_
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief 插件活跃度表：逻辑ID -> 最近一次收到该插件任何数据的时间
+ *
+ * 由IpcContext持有并交给各传输策略。I/O线程在握手时为连接取得条目，
+ * 此后每次读到数据只做一次原子写，心跳本身不再进入主线程；
+ * 进程管理按该表判断心跳超时，有业务流量的插件可以不发显式心跳。
+ *
+ * 条目按逻辑ID保留，插件重连或策略迁移后沿用同一条目。
+ */
+class IpcLivenessTable {
+public:
+    /**
+     * @brief 单个插件的活跃时间，可在任意线程读写
+     */
+    struct Entry {
+        std::atomic<qint64> last_seen_ms{0};
+
+        void touch() { last_seen_ms.store(IpcLivenessTable::nowMs(), std::memory_order_relaxed); }
+    };
+
+    /**
+     * @brief 单调时钟的当前毫秒数
+     */
+    static qint64 nowMs();
+
+    /**
+     * @brief 取得（或创建）逻辑ID对应的条目，并记为此刻活跃
+     */
+    std::shared_ptr<Entry> acquire(const QString& logical_id);
+
+    /**
+     * @brief 距最近一次活跃的毫秒数
+     * @return 从未见过该逻辑ID时返回-1
+     */
+    qint64 idleMs(const QString& logical_id) const;
+
+private:
+    mutable QMutex mutex_;
+    QHash<QString, std::shared_ptr<Entry>> entries_;
+};
+
+#endif // MASTER_SRC_IPCLIVENESSTABLE_H_
@@ -0,0 +1,168 @@
+#include "IpcMessageBody.h"
+#include "IpcJsonText.h"
+#include <QCborMap>
+#include <QCborStreamReader>
+#include <QCborValue>
+#include <QDebug>
+#include <QJsonDocument>
+
+namespace {
+    constexpr uchar kCborEmptyMap = 0xA0;
+    constexpr uchar kCborIndefiniteMap = 0xBF;
+    constexpr uchar kCborBreak = 0xFF;
+}
+
+IpcMessageBody::IpcMessageBody(const QJsonObject& object) : object_(object) {}
+
+IpcMessageBody IpcMessageBody::fromRaw(const QByteArray& raw, Encoding encoding)
+{
+    IpcMessageBody body;
+    if (raw.isEmpty() || encoding == Encoding::kNone) {
+        return body;
+    }
+    body.raw_ = raw;
+    body.raw_encoding_ = encoding;
+    body.parsed_ = false;
+    return body;
+}
+
+bool IpcMessageBody::isEmpty() const
+{
+    if (parsed_) {
+        return object_.isEmpty();
+    }
+    if (raw_encoding_ == Encoding::kJson) {
+        return IpcJsonText::isEmptyObject(raw_);
+    }
+    const uchar first = static_cast<uchar>(raw_.at(0));
+    return first == kCborEmptyMap ||
+           (first == kCborIndefiniteMap && raw_.size() >= 2 && static_cast<uchar>(raw_.at(1)) == kCborBreak);
+}
+
+bool IpcMessageBody::contains(const QString& key) const
+{
+    ensureParsed();
+    return object_.contains(key);
+}
+
+QJsonValue IpcMessageBody::value(const QString& key) const
+{
+    ensureParsed();
+    return object_.value(key);
+}
+
+QJsonValue IpcMessageBody::peek(const QString& key) const
+{
+    if (parsed_) {
+        return object_.value(key);
+    }
+
+    if (raw_encoding_ == Encoding::kJson) {
+        const QByteArray key_utf8 = key.toUtf8();
+        QJsonValue found(QJsonValue::Undefined);
+        const bool scanned = IpcJsonText::forEachMember(raw_, [&](QByteArrayView name, QByteArrayView value) {
+            if (name != key_utf8) {
+                return true;
+            }
+            found = IpcJsonText::toValue(value);
+            return false;
+        });
+        if (scanned) {
+            return found;
+        }
+        // 键含转义或格式异常，退回完整解析
+        return value(key);
+    }
+
+    QCborStreamReader reader(raw_);
+    if (!reader.isMap() || !reader.enterContainer()) {
+        return value(key);
+    }
+    while (reader.lastError() == QCborError::NoError && reader.hasNext()) {
+        if (!reader.isString()) {
+            return value(key);
+        }
+        QString name;
+        auto chunk = reader.readString();
+        while (chunk.status == QCborStreamReader::Ok) {
+            name += chunk.data;
+            chunk = reader.readString();
+        }
+        if (chunk.status == QCborStreamReader::Error) {
+            return value(key);
+        }
+        if (name == key) {
+            return QCborValue::fromCbor(reader).toJsonValue();
+        }
+        reader.next();
+    }
+    return QJsonValue(QJsonValue::Undefined);
+}
+
+const QJsonObject& IpcMessageBody::object() const
+{
+    ensureParsed();
+    return object_;
+}
+
+QJsonValueRef IpcMessageBody::operator[](const QString& key)
+{
+    return mutableObject()[key];
+}
+
+QJsonObject& IpcMessageBody::mutableObject()
+{
+    ensureParsed();
+    detachRaw();
+    return object_;
+}
+
+QByteArray IpcMessageBody::toJson() const
+{
+    if (raw_encoding_ == Encoding::kJson) {
+        return raw_;
+    }
+    return QJsonDocument(object()).toJson(QJsonDocument::Compact);
+}
+
+QByteArray IpcMessageBody::toCbor() const
+{
+    if (raw_encoding_ == Encoding::kCbor) {
+        return raw_;
+    }
+    const QJsonObject& parsed = object();
+    return parsed.isEmpty() ? QByteArray() : QCborMap::fromJsonObject(parsed).toCborValue().toCbor();
+}
+
+void IpcMessageBody::ensureParsed() const
+{
+    if (parsed_) {
+        return;
+    }
+    parsed_ = true;
+
+    if (raw_encoding_ == Encoding::kJson) {
+        QJsonParseError error;
+        const QJsonDocument doc = QJsonDocument::fromJson(raw_, &error);
+        if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+            qWarning() << "[IpcMessageBody] JSON消息体解析失败:" << error.errorString();
+            return;
+        }
+        object_ = doc.object();
+        return;
+    }
+
+    QCborParserError error;
+    const QCborValue value = QCborValue::fromCbor(raw_, &error);
+    if (error.error != QCborError::NoError) {
+        qWarning() << "[IpcMessageBody] CBOR消息体解析失败:" << error.errorString();
+        return;
+    }
+    object_ = value.toMap().toJsonObject();
+}
+
+void IpcMessageBody::detachRaw()
+{
+    raw_.clear();
+    raw_encoding_ = Encoding::kNone;
+}
@@ -0,0 +1,83 @@
+#ifndef MASTER_SRC_IPCMESSAGEBODY_H_
+#define MASTER_SRC_IPCMESSAGEBODY_H_
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QString>
+
+/**
+ * @brief 按需解析的IPC消息体
+ *
+ * 解码端只解析路由头（类型、Topic、ID、时间戳），消息体保留线上的原始字节
+ * （JSON文本或CBOR），首次按键读取时才解析为 QJsonObject。未被修改的消息体
+ * 重新以同一编码发送时原样写出，转发不经过解析和再序列化。
+ *
+ * - value() / contains() / const operator[]：解析并缓存，原始字节保留
+ * - peek()：只取顶层的一个键，不建立DOM（心跳等只看一两个字段的消息）
+ * - 非const operator[] / mutableObject()：解析后丢弃原始字节，之后按对象重新编码
+ *
+ * 惰性解析会修改内部缓存，同一对象不要在多个线程中同时首次读取。
+ */
+class IpcMessageBody {
+public:
+    /**
+     * @brief 原始字节的编码
+     */
+    enum class Encoding : quint8 {
+        kNone = 0,           // 没有原始字节，内容在对象中
+        kJson,               // JSON对象文本
+        kCbor                // CBOR map
+    };
+
+    IpcMessageBody() = default;
+    IpcMessageBody(const QJsonObject& object);  // 允许 message.body = object
+
+    /**
+     * @brief 以线上原始字节构造，调用方保证 raw 是一个对象（JSON以 '{' 开头，CBOR为map）
+     */
+    static IpcMessageBody fromRaw(const QByteArray& raw, Encoding encoding);
+
+    bool isEmpty() const;
+    bool contains(const QString& key) const;
+    QJsonValue value(const QString& key) const;
+    QJsonValue operator[](const QString& key) const { return value(key); }
+
+    /**
+     * @brief 读取顶层的一个键而不解析整个消息体
+     * @return 键不存在时返回 QJsonValue::Undefined
+     */
+    QJsonValue peek(const QString& key) const;
+
+    /**
+     * @brief 解析后的完整对象
+     */
+    const QJsonObject& object() const;
+
+    QJsonValueRef operator[](const QString& key);
+    QJsonObject& mutableObject();
+
+    /**
+     * @brief 紧凑JSON文本，原始字节为未修改的JSON时直接返回
+     */
+    QByteArray toJson() const;
+
+    /**
+     * @brief CBOR编码，原始字节为未修改的CBOR时直接返回；空消息体返回空字节
+     */
+    QByteArray toCbor() const;
+
+    bool isParsed() const { return parsed_; }
+    Encoding rawEncoding() const { return raw_encoding_; }
+
+private:
+    void ensureParsed() const;
+    void detachRaw();
+
+    mutable QJsonObject object_;
+    mutable bool parsed_ = true;
+    QByteArray raw_;
+    Encoding raw_encoding_ = Encoding::kNone;
+};
+
+#endif // MASTER_SRC_IPCMESSAGEBODY_H_
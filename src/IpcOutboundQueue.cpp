@@ -0,0 +1,248 @@
+#include "IpcOutboundQueue.h"
+#include <QIODevice>
+#include <QJsonValue>
+#include <algorithm>
+
+QString ipcLaneName(IpcLane lane)
+{
+    return lane == IpcLane::kBulk ? QStringLiteral("bulk") : QStringLiteral("control");
+}
+
+IpcOutboundQueueConfig IpcOutboundQueueConfig::fromJson(const QJsonObject& local_socket)
+{
+    IpcOutboundQueueConfig config;
+    config.high_water_bytes = local_socket["outbound_high_water_bytes"].toInteger(config.high_water_bytes);
+    config.low_water_bytes = local_socket["outbound_low_water_bytes"].toInteger(config.low_water_bytes);
+    if (config.high_water_bytes <= 0) {
+        config.high_water_bytes = IpcOutboundQueueConfig().high_water_bytes;
+    }
+    config.low_water_bytes = std::clamp<qint64>(config.low_water_bytes, 1, config.high_water_bytes);
+    config.bulk_budget_bytes = std::clamp<qint64>(
+        local_socket["bulk_budget_bytes"].toInteger(config.bulk_budget_bytes), 1, config.low_water_bytes);
+
+    const QJsonObject policies = local_socket["topic_policies"].toObject();
+    for (auto it = policies.constBegin(); it != policies.constEnd(); ++it) {
+        const QString policy = it.value().toString();
+        if (policy == "never") {
+            config.topic_policies.insert(it.key(), IpcDropPolicy::kNever);
+        } else if (policy == "coalesce") {
+            config.topic_policies.insert(it.key(), IpcDropPolicy::kCoalesce);
+        } else if (policy == "drop_oldest") {
+            config.topic_policies.insert(it.key(), IpcDropPolicy::kDropOldest);
+        }
+    }
+
+    const QJsonObject lanes = local_socket["topic_lanes"].toObject();
+    for (auto it = lanes.constBegin(); it != lanes.constEnd(); ++it) {
+        const QString lane = it.value().toString();
+        if (lane == "control") {
+            config.topic_lanes.insert(it.key(), IpcLane::kControl);
+        } else if (lane == "bulk") {
+            config.topic_lanes.insert(it.key(), IpcLane::kBulk);
+        }
+    }
+    return config;
+}
+
+IpcLane IpcOutboundQueueConfig::laneFor(const IpcMessage& message) const
+{
+    if (!topic_lanes.isEmpty()) {
+        auto it = topic_lanes.constFind(message.topic);
+        if (it != topic_lanes.constEnd()) {
+            return it.value();
+        }
+    }
+    switch (message.type) {
+        case MessageType::kStatusReport:
+        case MessageType::kLogMessage:
+            return IpcLane::kBulk;
+        default:
+            return IpcLane::kControl;
+    }
+}
+
+IpcDropPolicy IpcOutboundQueueConfig::policyFor(const IpcMessage& message) const
+{
+    auto it = topic_policies.constFind(message.topic);
+    if (it != topic_policies.constEnd()) {
+        return it.value();
+    }
+    switch (message.type) {
+        case MessageType::kStatusReport: return IpcDropPolicy::kCoalesce;
+        case MessageType::kLogMessage: return IpcDropPolicy::kDropOldest;
+        default: return IpcDropPolicy::kNever;
+    }
+}
+
+IpcOutboundQueue::IpcOutboundQueue(const IpcOutboundQueueConfig* config)
+    : config_(config)
+{
+}
+
+bool IpcOutboundQueue::enqueue(const QByteArray& frame, const IpcMessage& message, qint64 in_flight_bytes)
+{
+    const IpcDropPolicy policy = config_->policyFor(message);
+    Lane& lane = lanes_[static_cast<int>(config_->laneFor(message))];
+    updateCongestion(in_flight_bytes);
+
+    QString coalesce_key;
+    if (policy == IpcDropPolicy::kCoalesce) {
+        // 队列中仍未写出的同一来源同类状态只保留最新一份，位置不变；
+        // 转发或发布的消息来自不同插件，不能互相覆盖
+        coalesce_key = QString::number(static_cast<int>(message.type)) + QLatin1Char(':') + message.sender_id +
+                       QLatin1Char(':') + message.topic;
+        auto it = lane.coalesce_index.constFind(coalesce_key);
+        if (it != lane.coalesce_index.constEnd()) {
+            Entry* entry = lane.entryAt(it.value());
+            const qint64 delta = frame.size() - entry->frame.size();
+            lane.queued_bytes += delta;
+            queued_bytes_ += delta;
+            entry->frame = frame;
+            ++coalesced_messages_;
+            return true;
+        }
+    }
+
+    if (policy != IpcDropPolicy::kNever && congested_) {
+        // 拥塞时先丢弃最旧的可丢弃消息为新消息腾出空间，仍放不下则丢弃新消息
+        while (in_flight_bytes + queued_bytes_ + frame.size() > config_->high_water_bytes && dropOldest()) {
+        }
+        if (in_flight_bytes + queued_bytes_ + frame.size() > config_->high_water_bytes) {
+            ++dropped_messages_;
+            return false;
+        }
+    }
+
+    const quint64 seq = lane.front_seq + lane.entries.size();
+    lane.entries.push_back(Entry{frame, policy, coalesce_key, false});
+    if (policy == IpcDropPolicy::kCoalesce) {
+        lane.coalesce_index.insert(coalesce_key, seq);
+    }
+    if (policy != IpcDropPolicy::kNever) {
+        lane.droppable_seqs.push_back(seq);
+    }
+    ++lane.queued_messages;
+    lane.queued_bytes += frame.size();
+    lane.peak_bytes = std::max(lane.peak_bytes, lane.queued_bytes);
+    ++queued_messages_;
+    queued_bytes_ += frame.size();
+    peak_bytes_ = std::max(peak_bytes_, queued_bytes_);
+    updateCongestion(in_flight_bytes);
+    return true;
+}
+
+qint64 IpcOutboundQueue::pump(QIODevice* device)
+{
+    // QIODevice的写缓冲无上限，写入总是整帧成功
+    class DeviceSink : public IpcFrameSink {
+    public:
+        explicit DeviceSink(QIODevice* device) : device_(device) {}
+        qint64 pendingBytes() const override { return device_->bytesToWrite(); }
+        qint64 writeFrame(const QByteArray& frame) override
+        {
+            const qint64 bytes_written = device_->write(frame);
+            return bytes_written == frame.size() ? bytes_written : -1;
+        }
+
+    private:
+        QIODevice* device_;
+    };
+
+    DeviceSink sink(device);
+    return pump(&sink);
+}
+
+qint64 IpcOutboundQueue::pump(IpcFrameSink* sink)
+{
+    // 控制帧只受低水位限制；批量帧受更小的预算限制，给后续控制帧留出插队空间
+    const qint64 control_written =
+        pumpLane(&lanes_[static_cast<int>(IpcLane::kControl)], sink, config_->low_water_bytes);
+    if (control_written < 0) {
+        return -1;
+    }
+    const qint64 bulk_written =
+        pumpLane(&lanes_[static_cast<int>(IpcLane::kBulk)], sink, config_->bulk_budget_bytes);
+    if (bulk_written < 0) {
+        return -1;
+    }
+    updateCongestion(sink->pendingBytes());
+    return control_written + bulk_written;
+}
+
+qint64 IpcOutboundQueue::pumpLane(Lane* lane, IpcFrameSink* sink, qint64 budget_bytes)
+{
+    qint64 written = 0;
+    while (!lane->entries.empty() && sink->pendingBytes() < budget_bytes) {
+        Entry& front = lane->entries.front();
+        if (!front.dropped) {
+            const qint64 bytes_written = sink->writeFrame(front.frame);
+            if (bytes_written < 0) {
+                return -1;
+            }
+            if (bytes_written == 0) {
+                break; // 目标暂时没有空间，保留在队首
+            }
+            release(lane, &front, lane->front_seq);
+            written += bytes_written;
+        }
+        lane->entries.pop_front();
+        ++lane->front_seq;
+    }
+
+    if (lane->entries.empty()) {
+        lane->droppable_seqs.clear();
+    }
+    return written;
+}
+
+bool IpcOutboundQueue::dropOldest()
+{
+    // 优先牺牲批量通道
+    return dropOldest(&lanes_[static_cast<int>(IpcLane::kBulk)]) ||
+           dropOldest(&lanes_[static_cast<int>(IpcLane::kControl)]);
+}
+
+bool IpcOutboundQueue::dropOldest(Lane* lane)
+{
+    while (!lane->droppable_seqs.empty()) {
+        const quint64 seq = lane->droppable_seqs.front();
+        lane->droppable_seqs.pop_front();
+        if (seq < lane->front_seq) {
+            continue; // 已写出
+        }
+        Entry* entry = lane->entryAt(seq);
+        if (entry->dropped) {
+            continue;
+        }
+        release(lane, entry, seq);
+        entry->frame.clear();
+        entry->dropped = true;
+        ++dropped_messages_;
+        return true;
+    }
+    return false;
+}
+
+void IpcOutboundQueue::release(Lane* lane, Entry* entry, quint64 seq)
+{
+    --lane->queued_messages;
+    lane->queued_bytes -= entry->frame.size();
+    --queued_messages_;
+    queued_bytes_ -= entry->frame.size();
+    if (!entry->coalesce_key.isEmpty()) {
+        auto it = lane->coalesce_index.find(entry->coalesce_key);
+        if (it != lane->coalesce_index.end() && it.value() == seq) {
+            lane->coalesce_index.erase(it);
+        }
+    }
+}
+
+void IpcOutboundQueue::updateCongestion(qint64 in_flight_bytes)
+{
+    const qint64 backlog = in_flight_bytes + queued_bytes_;
+    if (backlog >= config_->high_water_bytes) {
+        congested_ = true;
+    } else if (backlog <= config_->low_water_bytes) {
+        congested_ = false;
+    }
+}
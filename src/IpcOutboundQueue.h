@@ -0,0 +1,185 @@
+#ifndef MASTER_SRC_IPCOUTBOUNDQUEUE_H_
+#define MASTER_SRC_IPCOUTBOUNDQUEUE_H_
+
+#include "IIpcCommunication.h"
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QString>
+#include <array>
+#include <deque>
+
+class QIODevice;
+
+/**
+ * @brief 出站消息在拥塞时的处理策略
+ */
+enum class IpcDropPolicy {
+    kNever = 0,          // 从不丢弃（控制类消息）
+    kCoalesce,           // 队列中同Topic同类型的旧消息被新消息覆盖，拥塞时可丢弃
+    kDropOldest          // 拥塞时丢弃最旧的同类消息
+};
+
+/**
+ * @brief 消息的优先级通道
+ *
+ * 控制通道（握手、心跳、命令及响应、配置更新、关闭、错误报告）在写出和
+ * 主线程派发两侧都先于批量通道（日志、状态上报）处理，避免插件大量输出
+ * 日志时自身的心跳被拖到超时。
+ */
+enum class IpcLane {
+    kControl = 0,
+    kBulk,
+    kCount
+};
+
+constexpr int kIpcLaneCount = static_cast<int>(IpcLane::kCount);
+
+QString ipcLaneName(IpcLane lane);
+
+/**
+ * @brief 出站队列配置，取自 ipc.local_socket
+ *
+ * 配置项：
+ * - outbound_high_water_bytes: 积压（队列 + socket发送缓冲）达到该值进入拥塞状态
+ * - outbound_low_water_bytes: 积压回落到该值以下退出拥塞；socket发送缓冲低于该值时才继续写入控制帧
+ * - bulk_budget_bytes: socket发送缓冲低于该值时才写入批量帧，即控制帧之前最多排着这么多批量数据
+ * - topic_policies: { "<topic>": "never" | "coalesce" | "drop_oldest" }，覆盖按消息类型的默认策略
+ * - topic_lanes: { "<topic>": "control" | "bulk" }，覆盖按消息类型的默认通道
+ */
+struct IpcOutboundQueueConfig {
+    qint64 high_water_bytes = 4 * 1024 * 1024;
+    qint64 low_water_bytes = 1024 * 1024;
+    qint64 bulk_budget_bytes = 64 * 1024;
+    QHash<QString, IpcDropPolicy> topic_policies;
+    QHash<QString, IpcLane> topic_lanes;
+
+    static IpcOutboundQueueConfig fromJson(const QJsonObject& local_socket);
+
+    /**
+     * @brief 获取消息所属的通道
+     *
+     * 默认：kLogMessage 与 kStatusReport 走批量通道，其余走控制通道。
+     */
+    IpcLane laneFor(const IpcMessage& message) const;
+
+    /**
+     * @brief 获取消息适用的策略
+     *
+     * 默认：kStatusReport 合并，kLogMessage 丢弃最旧，其余（握手、心跳、命令、
+     * 配置更新、关闭等）从不丢弃。
+     */
+    IpcDropPolicy policyFor(const IpcMessage& message) const;
+};
+
+/**
+ * @brief 出站队列写出的目标（socket发送缓冲、共享内存环等）
+ */
+class IpcFrameSink {
+public:
+    virtual ~IpcFrameSink() = default;
+
+    /**
+     * @brief 已交给传输层但对端尚未取走的字节数
+     */
+    virtual qint64 pendingBytes() const = 0;
+
+    /**
+     * @brief 写出一帧
+     * @return 接受的字节数（必须为整帧或0）；0表示暂时没有空间，-1表示出错
+     */
+    virtual qint64 writeFrame(const QByteArray& frame) = 0;
+};
+
+/**
+ * @brief 单个连接的有界出站队列
+ *
+ * 目标（socket发送缓冲等）积压低于低水位时帧直接写出；否则在本队列中排队，
+ * 待目标腾出空间（如 bytesWritten）后由 pump() 续写。积压超过高水位时按策略合并或丢弃
+ * 可丢弃的消息，控制类消息始终保留并保持原有顺序。
+ *
+ * 队列分为控制和批量两个通道，各自保持FIFO。pump() 总是先写控制通道；批量帧只在
+ * 目标积压低于 bulk_budget_bytes 时写出，因此新的控制帧最多排在这么多批量数据之后。
+ *
+ * 非线程安全，由所属连接的I/O线程独占使用。
+ */
+class IpcOutboundQueue {
+public:
+    explicit IpcOutboundQueue(const IpcOutboundQueueConfig* config);
+
+    /**
+     * @brief 排入一帧
+     * @param frame 已编码的帧
+     * @param message 帧对应的消息，用于确定策略和通道
+     * @param in_flight_bytes 目标中尚未送达的字节数
+     * @return 帧被排入或合并返回true，因拥塞被丢弃返回false
+     */
+    bool enqueue(const QByteArray& frame, const IpcMessage& message, qint64 in_flight_bytes);
+
+    /**
+     * @brief 在socket发送缓冲低于低水位时把排队的帧写入设备
+     * @param device 目标设备
+     * @return 写入的字节数，写入失败返回-1
+     */
+    qint64 pump(QIODevice* device);
+
+    /**
+     * @brief 在目标积压低于低水位时把排队的帧写入目标
+     * @param sink 目标
+     * @return 写入的字节数，写入失败返回-1
+     */
+    qint64 pump(IpcFrameSink* sink);
+
+    bool isEmpty() const { return queued_messages_ == 0; }
+    bool isCongested() const { return congested_; }
+    qsizetype queuedMessages() const { return queued_messages_; }
+    qint64 queuedBytes() const { return queued_bytes_; }
+    quint64 droppedMessages() const { return dropped_messages_; }
+    quint64 coalescedMessages() const { return coalesced_messages_; }
+    qint64 peakBytes() const { return peak_bytes_; }
+
+    /**
+     * @brief 按通道的队列深度
+     */
+    qsizetype queuedMessages(IpcLane lane) const { return lanes_[static_cast<int>(lane)].queued_messages; }
+    qint64 queuedBytes(IpcLane lane) const { return lanes_[static_cast<int>(lane)].queued_bytes; }
+    qint64 peakBytes(IpcLane lane) const { return lanes_[static_cast<int>(lane)].peak_bytes; }
+
+private:
+    struct Entry {
+        QByteArray frame;
+        IpcDropPolicy policy = IpcDropPolicy::kNever;
+        QString coalesce_key;
+        bool dropped = false;        // 已丢弃，仅占位以保持序号连续
+    };
+
+    struct Lane {
+        std::deque<Entry> entries;
+        quint64 front_seq = 0;                   // entries.front() 的序号
+        QHash<QString, quint64> coalesce_index;  // 合并键 -> 排队中的序号
+        std::deque<quint64> droppable_seqs;      // 可丢弃消息的序号（FIFO，惰性清理）
+        qsizetype queued_messages = 0;
+        qint64 queued_bytes = 0;
+        qint64 peak_bytes = 0;
+
+        Entry* entryAt(quint64 seq) { return &entries[static_cast<size_t>(seq - front_seq)]; }
+    };
+
+    const IpcOutboundQueueConfig* config_;
+    std::array<Lane, kIpcLaneCount> lanes_;
+
+    qsizetype queued_messages_ = 0;
+    qint64 queued_bytes_ = 0;
+    qint64 peak_bytes_ = 0;
+    quint64 dropped_messages_ = 0;
+    quint64 coalesced_messages_ = 0;
+    bool congested_ = false;
+
+    qint64 pumpLane(Lane* lane, IpcFrameSink* sink, qint64 budget_bytes);
+    bool dropOldest();
+    bool dropOldest(Lane* lane);
+    void release(Lane* lane, Entry* entry, quint64 seq);
+    void updateCongestion(qint64 in_flight_bytes);
+};
+
+#endif // MASTER_SRC_IPCOUTBOUNDQUEUE_H_
@@ -0,0 +1,80 @@
+#include "IpcReceiveBuffer.h"
+#include <QIODevice>
+#include <algorithm>
+#include <cstring>
+
+IpcReceiveBuffer::IpcReceiveBuffer(qsizetype initial_capacity)
+    : storage_(initial_capacity, Qt::Uninitialized)
+{
+}
+
+qint64 IpcReceiveBuffer::readFrom(QIODevice* device)
+{
+    qint64 total = 0;
+    qint64 available = device->bytesAvailable();
+    while (available > 0) {
+        char* tail = reserveTail(available);
+        const qint64 bytes_read = device->read(tail, storage_.size() - write_pos_);
+        if (bytes_read < 0) {
+            return total > 0 ? total : -1;
+        }
+        if (bytes_read == 0) {
+            break;
+        }
+        write_pos_ += bytes_read;
+        total += bytes_read;
+        available = device->bytesAvailable();
+    }
+    return total;
+}
+
+void IpcReceiveBuffer::append(QByteArrayView data)
+{
+    if (data.isEmpty()) {
+        return;
+    }
+    char* tail = reserveTail(data.size());
+    std::memcpy(tail, data.data(), data.size());
+    write_pos_ += data.size();
+}
+
+void IpcReceiveBuffer::consume(qsizetype bytes)
+{
+    read_pos_ = std::min(read_pos_ + bytes, write_pos_);
+    if (read_pos_ == write_pos_) {
+        // 数据已读空，游标归零即可，无需移动内存
+        read_pos_ = 0;
+        write_pos_ = 0;
+    }
+}
+
+void IpcReceiveBuffer::clear()
+{
+    read_pos_ = 0;
+    write_pos_ = 0;
+    if (storage_.size() > kDefaultCapacity) {
+        storage_ = QByteArray(kDefaultCapacity, Qt::Uninitialized);
+    }
+}
+
+char* IpcReceiveBuffer::reserveTail(qsizetype bytes)
+{
+    const qsizetype tail_space = storage_.size() - write_pos_;
+    if (tail_space >= bytes) {
+        return storage_.data() + write_pos_;
+    }
+
+    // 已读部分占一半以上或前移后足够容纳时才compact，否则直接扩容
+    const qsizetype pending = write_pos_ - read_pos_;
+    if (read_pos_ > 0 && (read_pos_ >= storage_.size() / 2 || storage_.size() - pending >= bytes)) {
+        std::memmove(storage_.data(), storage_.constData() + read_pos_, pending);
+        read_pos_ = 0;
+        write_pos_ = pending;
+    }
+
+    if (storage_.size() - write_pos_ < bytes) {
+        const qsizetype required = write_pos_ + bytes;
+        storage_.resize(std::max(required, storage_.size() * 2));
+    }
+    return storage_.data() + write_pos_;
+}
@@ -0,0 +1,85 @@
+#ifndef MASTER_SRC_IPCRECEIVEBUFFER_H_
+#define MASTER_SRC_IPCRECEIVEBUFFER_H_
+
+#include <QByteArray>
+#include <QByteArrayView>
+
+class QIODevice;
+
+/**
+ * @brief 连接级接收缓冲区
+ *
+ * 一块连续内存加读写游标：socket数据直接读入写游标之后，解码器在
+ * readable() 视图上原地切出帧（零拷贝），consume() 只前移读游标。
+ * 仅在已读部分占大半或尾部空间不足时才整体前移（compact），
+ * 数据读空时游标直接归零，避免逐帧 QByteArray::remove 带来的二次复杂度。
+ *
+ * 非线程安全，由所属连接的I/O线程独占使用。
+ */
+class IpcReceiveBuffer {
+public:
+    explicit IpcReceiveBuffer(qsizetype initial_capacity = kDefaultCapacity);
+
+    /**
+     * @brief 从设备读取当前全部可用数据
+     * @param device 数据来源
+     * @return 本次读取的字节数，出错返回-1
+     */
+    qint64 readFrom(QIODevice* device);
+
+    /**
+     * @brief 追加数据（用于非QIODevice来源）
+     */
+    void append(QByteArrayView data);
+
+    /**
+     * @brief 为原生fd的read()预留写入空间
+     * @param bytes 至少需要的可写字节数
+     * @return 写入位置，实际可写 writableBytes() 字节；写入后以 commit() 确认
+     */
+    char* prepareWrite(qsizetype bytes) { return reserveTail(bytes); }
+    qsizetype writableBytes() const { return storage_.size() - write_pos_; }
+
+    /**
+     * @brief 确认已写入 prepareWrite() 返回位置的字节数
+     */
+    void commit(qsizetype bytes) { write_pos_ += bytes; }
+
+    /**
+     * @brief 尚未消费的数据视图，在下一次写入或consume之前有效
+     */
+    QByteArrayView readable() const
+    {
+        return QByteArrayView(storage_.constData() + read_pos_, write_pos_ - read_pos_);
+    }
+
+    /**
+     * @brief 标记已消费的字节数
+     * @param bytes 字节数，不得超过readable().size()
+     */
+    void consume(qsizetype bytes);
+
+    qsizetype size() const { return write_pos_ - read_pos_; }
+    bool isEmpty() const { return write_pos_ == read_pos_; }
+    qsizetype capacity() const { return storage_.size(); }
+
+    /**
+     * @brief 清空数据并在容量过大时收缩回默认大小
+     */
+    void clear();
+
+private:
+    static constexpr qsizetype kDefaultCapacity = 64 * 1024;
+
+    /**
+     * @brief 确保写游标之后至少有bytes字节可写
+     * @return 写入位置
+     */
+    char* reserveTail(qsizetype bytes);
+
+    QByteArray storage_;      // 底层连续内存，size()即容量
+    qsizetype read_pos_ = 0;  // 读游标
+    qsizetype write_pos_ = 0; // 写游标
+};
+
+#endif // MASTER_SRC_IPCRECEIVEBUFFER_H_
@@ -0,0 +1,166 @@
+#include "IpcRequestTracker.h"
+#include <QDebug>
+#include <algorithm>
+
+IpcRequestTracker::IpcRequestTracker(QObject* parent)
+    : QObject(parent), timer_wheel_(10, 512)
+{
+}
+
+IpcRequestTracker::~IpcRequestTracker()
+{
+    failAll("请求表已销毁");
+}
+
+QFuture<IpcRequestResult> IpcRequestTracker::track(const QString& request_id, const QString& name, int timeout_ms,
+                                                   const QString& receiver_id)
+{
+    auto request = std::make_unique<PendingRequest>();
+    request->name = name;
+    request->receiver_id = receiver_id;
+    request->elapsed.start();
+    request->promise.start();
+    QFuture<IpcRequestResult> future = request->promise.future();
+
+    auto existing = pending_.find(request_id);
+    if (existing != pending_.end()) {
+        qWarning() << "[IpcRequestTracker] 重复的请求ID，旧请求将被取消:" << request_id;
+        IpcRequestResult result;
+        result.request_id = request_id;
+        result.error = "请求ID重复";
+        Finish(existing, result);
+    }
+
+    request->timer_id = timer_wheel_.schedule(std::max(1, timeout_ms), [this, request_id]() {
+        auto it = pending_.find(request_id);
+        if (it == pending_.end()) {
+            return;
+        }
+        it->second->timer_id = 0;
+        qWarning() << "[IpcRequestTracker] 请求超时:" << it->second->name << request_id;
+        IpcRequestResult result;
+        result.request_id = request_id;
+        result.timed_out = true;
+        result.error = "等待响应超时";
+        Finish(it, result);
+    });
+    pending_.emplace(request_id, std::move(request));
+    if (!receiver_id.isEmpty()) {
+        pending_by_receiver_[receiver_id].insert(request_id);
+    }
+    return future;
+}
+
+bool IpcRequestTracker::complete(const IpcMessage& response)
+{
+    const QJsonValue request_id_value = response.body.value("request_id");
+    const QString request_id = request_id_value.isUndefined()
+        ? response.msg_id
+        : request_id_value.toString();
+    auto it = pending_.find(request_id);
+    if (it == pending_.end()) {
+        return false;
+    }
+
+    IpcRequestResult result;
+    result.request_id = request_id;
+    result.response = response;
+    result.latency_us = it->second->elapsed.nsecsElapsed() / 1000;
+    result.success = response.body.value("success").toBool(true);
+    if (!result.success) {
+        result.error = response.body.value("error").toString("插件返回失败");
+    }
+    Finish(it, result);
+    return true;
+}
+
+void IpcRequestTracker::fail(const QString& request_id, const QString& error)
+{
+    auto it = pending_.find(request_id);
+    if (it == pending_.end()) {
+        return;
+    }
+    IpcRequestResult result;
+    result.request_id = request_id;
+    result.error = error;
+    Finish(it, result);
+}
+
+void IpcRequestTracker::failAll(const QString& error)
+{
+    while (!pending_.empty()) {
+        IpcRequestResult result;
+        result.request_id = pending_.begin()->first;
+        result.error = error;
+        Finish(pending_.begin(), result);
+    }
+}
+
+int IpcRequestTracker::failReceiver(const QString& receiver_id, const QString& error)
+{
+    const QSet<QString> request_ids = pending_by_receiver_.take(receiver_id);
+    for (const QString& request_id : request_ids) {
+        fail(request_id, error);
+    }
+    if (!request_ids.isEmpty()) {
+        qWarning() << "[IpcRequestTracker] 接收方" << receiver_id << error << "结束等待中的请求:" << request_ids.size();
+    }
+    return static_cast<int>(request_ids.size());
+}
+
+QJsonObject IpcRequestTracker::statistics() const
+{
+    QJsonObject commands;
+    for (auto it = latency_.constBegin(); it != latency_.constEnd(); ++it) {
+        const LatencyStats& stats = it.value();
+        QJsonObject entry;
+        entry["completed"] = static_cast<qint64>(stats.completed);
+        entry["failed"] = static_cast<qint64>(stats.failed);
+        entry["timeouts"] = static_cast<qint64>(stats.timeouts);
+        entry["avg_latency_ms"] = stats.responses > 0 ? stats.total_us / 1000.0 / stats.responses : 0.0;
+        entry["max_latency_ms"] = stats.max_us / 1000.0;
+        entry["last_latency_ms"] = stats.last_us / 1000.0;
+        commands[it.key()] = entry;
+    }
+
+    QJsonObject stats;
+    stats["pending_requests"] = pendingCount();
+    stats["commands"] = commands;
+    return stats;
+}
+
+void IpcRequestTracker::Finish(PendingMap::iterator it, IpcRequestResult result)
+{
+    std::unique_ptr<PendingRequest> request = std::move(it->second);
+    pending_.erase(it);
+    if (!request->receiver_id.isEmpty()) {
+        auto receiver = pending_by_receiver_.find(request->receiver_id);
+        if (receiver != pending_by_receiver_.end()) {
+            receiver->remove(result.request_id);
+            if (receiver->isEmpty()) {
+                pending_by_receiver_.erase(receiver);
+            }
+        }
+    }
+    if (request->timer_id != 0) {
+        timer_wheel_.cancel(request->timer_id);
+    }
+
+    LatencyStats& stats = latency_[request->name];
+    if (result.timed_out) {
+        ++stats.timeouts;
+    } else if (result.success) {
+        ++stats.completed;
+    } else {
+        ++stats.failed;
+    }
+    if (result.latency_us >= 0) {
+        ++stats.responses;
+        stats.total_us += result.latency_us;
+        stats.max_us = std::max(stats.max_us, result.latency_us);
+        stats.last_us = result.latency_us;
+    }
+
+    request->promise.addResult(std::move(result));
+    request->promise.finish();
+}
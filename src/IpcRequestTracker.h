@@ -0,0 +1,102 @@
+#ifndef MASTER_SRC_IPCREQUESTTRACKER_H_
+#define MASTER_SRC_IPCREQUESTTRACKER_H_
+
+#include "IIpcCommunication.h"
+#include "TimerWheel.h"
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QHash>
+#include <QJsonObject>
+#include <QPromise>
+#include <QSet>
+#include <map>
+#include <memory>
+
+/**
+ * @brief 等待响应的请求表
+ *
+ * 以请求的msg_id为键登记请求，收到kCommandResponse时按 body.request_id
+ * （缺省时按响应自身的msg_id）找到请求并完成对应的QFuture；所有截止时间
+ * 由同一个TimerWheel管理。同时按命令名称统计往返时延、失败与超时次数。
+ * 请求可以登记接收方，接收方断开时通过failReceiver()立即结束它的全部请求，
+ * 不必等到截止时间。
+ *
+ * 非线程安全，只能在所属线程（IpcContext所在线程）使用。
+ */
+class IpcRequestTracker : public QObject {
+    Q_OBJECT
+
+public:
+    explicit IpcRequestTracker(QObject* parent = nullptr);
+    ~IpcRequestTracker() override;
+
+    /**
+     * @brief 登记请求
+     * @param request_id 请求msg_id
+     * @param name 命令名称（统计用）
+     * @param timeout_ms 超时时间（毫秒）
+     * @param receiver_id 接收方，用于断开时结束请求；为空表示不关联
+     * @return 请求结果，收到响应、超时或失败时完成
+     */
+    QFuture<IpcRequestResult> track(const QString& request_id, const QString& name, int timeout_ms,
+                                    const QString& receiver_id = QString());
+
+    /**
+     * @brief 用响应完成请求
+     * @return 响应与某个等待中的请求匹配时返回true
+     */
+    bool complete(const IpcMessage& response);
+
+    /**
+     * @brief 以失败结束请求（如发送失败）
+     */
+    void fail(const QString& request_id, const QString& error);
+
+    /**
+     * @brief 以失败结束全部等待中的请求
+     */
+    void failAll(const QString& error);
+
+    /**
+     * @brief 以失败结束发往某个接收方的全部等待中请求（如接收方已断开）
+     * @return 结束的请求数
+     */
+    int failReceiver(const QString& receiver_id, const QString& error);
+
+    int pendingCount() const { return static_cast<int>(pending_.size()); }
+
+    /**
+     * @brief 按命令名称的时延统计
+     */
+    QJsonObject statistics() const;
+
+private:
+    struct PendingRequest {
+        QString name;
+        QString receiver_id;
+        QElapsedTimer elapsed;
+        TimerWheel::TimerId timer_id = 0;
+        QPromise<IpcRequestResult> promise;
+    };
+
+    struct LatencyStats {
+        quint64 completed = 0;     // 收到成功响应
+        quint64 failed = 0;        // 响应声明失败或发送失败
+        quint64 timeouts = 0;      // 超时
+        quint64 responses = 0;     // 收到响应的次数（含声明失败的响应）
+        qint64 total_us = 0;       // 收到响应的往返时延之和
+        qint64 max_us = 0;
+        qint64 last_us = 0;
+    };
+
+    using PendingMap = std::map<QString, std::unique_ptr<PendingRequest>>;
+
+    TimerWheel timer_wheel_;
+    PendingMap pending_;
+    QHash<QString, QSet<QString>> pending_by_receiver_;   // 接收方 -> 等待中的请求ID
+    QHash<QString, LatencyStats> latency_;
+
+    void Finish(PendingMap::iterator it, IpcRequestResult result);
+};
+
+#endif // MASTER_SRC_IPCREQUESTTRACKER_H_
@@ -0,0 +1,276 @@
+#include "IpcStreamServer.h"
+#include <QDebug>
+#include <QJsonArray>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#if defined(Q_OS_WIN)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#elif defined(Q_OS_UNIX)
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
+
+// ================== LocalStreamServer 实现 ==================
+
+LocalStreamServer::LocalStreamServer(const QString& server_name, QObject* parent)
+    : IpcStreamServer(parent), server_name_(server_name)
+{
+}
+
+LocalStreamServer::~LocalStreamServer()
+{
+    close();
+}
+
+bool LocalStreamServer::listen(QString* error)
+{
+    server_ = std::make_unique<QLocalServer>();
+    connect(server_.get(), &QLocalServer::newConnection, this, &IpcStreamServer::newConnection);
+
+    // 移除之前的同名服务器（如果存在）
+    QLocalServer::removeServer(server_name_);
+
+    if (!server_->listen(server_name_)) {
+        *error = server_->errorString();
+        server_.reset();
+        return false;
+    }
+    return true;
+}
+
+void LocalStreamServer::close()
+{
+    if (!server_) {
+        return;
+    }
+    if (server_->isListening()) {
+        server_->close();
+        QLocalServer::removeServer(server_name_); // 确保移除服务器文件
+    }
+    server_.reset();
+}
+
+QString LocalStreamServer::serverName() const
+{
+    return server_name_;
+}
+
+QIODevice* LocalStreamServer::nextPendingConnection()
+{
+    if (!server_ || !server_->hasPendingConnections()) {
+        return nullptr;
+    }
+    QLocalSocket* socket = server_->nextPendingConnection();
+    if (!socket) {
+        return nullptr;
+    }
+    socket->setParent(nullptr);
+
+    connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+        emit socketDisconnected(socket);
+    });
+    connect(socket, &QLocalSocket::errorOccurred, this, [this, socket](QLocalSocket::LocalSocketError) {
+        emit socketError(socket, socket->errorString());
+    });
+    return socket;
+}
+
+bool LocalStreamServer::isConnected(QIODevice* socket) const
+{
+    return static_cast<QLocalSocket*>(socket)->state() == QLocalSocket::ConnectedState;
+}
+
+void LocalStreamServer::disconnectSocket(QIODevice* socket)
+{
+    static_cast<QLocalSocket*>(socket)->disconnectFromServer();
+}
+
+void LocalStreamServer::abortSocket(QIODevice* socket)
+{
+    QLocalSocket* local_socket = static_cast<QLocalSocket*>(socket);
+    QObject::disconnect(local_socket, nullptr, this, nullptr);
+    if (local_socket->state() != QLocalSocket::UnconnectedState) {
+        local_socket->abort();
+    }
+}
+
+void LocalStreamServer::flushSocket(QIODevice* socket)
+{
+    static_cast<QLocalSocket*>(socket)->flush();
+}
+
+// ================== TcpStreamServer 实现 ==================
+
+TcpStreamServerOptions TcpStreamServerOptions::fromJson(const QJsonObject& tcp_socket)
+{
+    TcpStreamServerOptions options;
+
+    // bind_addresses 支持数组或单个字符串，"any"/"0.0.0.0"/"::" 表示所有网卡
+    QJsonArray addresses = tcp_socket["bind_addresses"].toArray();
+    if (addresses.isEmpty() && tcp_socket["bind_address"].isString()) {
+        addresses.append(tcp_socket["bind_address"]);
+    }
+    if (!addresses.isEmpty()) {
+        options.bind_addresses.clear();
+        for (const QJsonValue& value : addresses) {
+            const QString text = value.toString().trimmed();
+            QHostAddress address;
+            if (text.compare("any", Qt::CaseInsensitive) == 0) {
+                address = QHostAddress(QHostAddress::Any);
+            } else if (!address.setAddress(text)) {
+                qWarning() << "[TcpStreamServer] 忽略无效的绑定地址:" << text;
+                continue;
+            }
+            options.bind_addresses.append(address);
+        }
+        if (options.bind_addresses.isEmpty()) {
+            options.bind_addresses.append(QHostAddress(QHostAddress::LocalHost));
+        }
+    }
+
+    options.port = static_cast<quint16>(tcp_socket["port"].toInt(options.port));
+    options.no_delay = tcp_socket["no_delay"].toBool(options.no_delay);
+    options.keepalive = tcp_socket["keepalive"].toBool(options.keepalive);
+    options.keepalive_idle_seconds = tcp_socket["keepalive_idle_seconds"].toInt(options.keepalive_idle_seconds);
+    options.keepalive_interval_seconds =
+        tcp_socket["keepalive_interval_seconds"].toInt(options.keepalive_interval_seconds);
+    options.keepalive_count = tcp_socket["keepalive_count"].toInt(options.keepalive_count);
+    return options;
+}
+
+TcpStreamServer::TcpStreamServer(const TcpStreamServerOptions& options, QObject* parent)
+    : IpcStreamServer(parent), options_(options)
+{
+}
+
+TcpStreamServer::~TcpStreamServer()
+{
+    close();
+}
+
+bool TcpStreamServer::listen(QString* error)
+{
+    for (const QHostAddress& address : std::as_const(options_.bind_addresses)) {
+        auto server = std::make_unique<QTcpServer>();
+        connect(server.get(), &QTcpServer::newConnection, this, &IpcStreamServer::newConnection);
+        if (!server->listen(address, options_.port)) {
+            *error = QString("%1:%2 %3").arg(address.toString()).arg(options_.port).arg(server->errorString());
+            close();
+            return false;
+        }
+        qDebug() << "[TcpStreamServer] 监听在" << address.toString() << ":" << server->serverPort();
+        servers_.push_back(std::move(server));
+    }
+    return true;
+}
+
+void TcpStreamServer::close()
+{
+    for (auto& server : servers_) {
+        server->close();
+    }
+    servers_.clear();
+}
+
+QString TcpStreamServer::serverName() const
+{
+    QStringList names;
+    for (const auto& server : servers_) {
+        names.append(QString("%1:%2").arg(server->serverAddress().toString()).arg(server->serverPort()));
+    }
+    return names.join(',');
+}
+
+QIODevice* TcpStreamServer::nextPendingConnection()
+{
+    for (auto& server : servers_) {
+        if (!server->hasPendingConnections()) {
+            continue;
+        }
+        QTcpSocket* socket = server->nextPendingConnection();
+        if (!socket) {
+            continue;
+        }
+        socket->setParent(nullptr);
+        ApplySocketOptions(socket);
+
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            emit socketDisconnected(socket);
+        });
+        connect(socket, &QTcpSocket::errorOccurred, this, [this, socket](QAbstractSocket::SocketError error) {
+            // 对端正常关闭也会报RemoteHostClosedError，交给disconnected处理
+            if (error != QAbstractSocket::RemoteHostClosedError) {
+                emit socketError(socket, socket->errorString());
+            }
+        });
+        return socket;
+    }
+    return nullptr;
+}
+
+bool TcpStreamServer::isConnected(QIODevice* socket) const
+{
+    return static_cast<QTcpSocket*>(socket)->state() == QAbstractSocket::ConnectedState;
+}
+
+void TcpStreamServer::disconnectSocket(QIODevice* socket)
+{
+    static_cast<QTcpSocket*>(socket)->disconnectFromHost();
+}
+
+void TcpStreamServer::abortSocket(QIODevice* socket)
+{
+    QTcpSocket* tcp_socket = static_cast<QTcpSocket*>(socket);
+    QObject::disconnect(tcp_socket, nullptr, this, nullptr);
+    if (tcp_socket->state() != QAbstractSocket::UnconnectedState) {
+        tcp_socket->abort();
+    }
+}
+
+void TcpStreamServer::flushSocket(QIODevice* socket)
+{
+    static_cast<QTcpSocket*>(socket)->flush();
+}
+
+void TcpStreamServer::ApplySocketOptions(QIODevice* socket) const
+{
+    QTcpSocket* tcp_socket = static_cast<QTcpSocket*>(socket);
+    tcp_socket->setSocketOption(QAbstractSocket::LowDelayOption, options_.no_delay ? 1 : 0);
+    tcp_socket->setSocketOption(QAbstractSocket::KeepAliveOption, options_.keepalive ? 1 : 0);
+    if (!options_.keepalive || options_.keepalive_idle_seconds <= 0) {
+        return;
+    }
+
+    // Qt未提供保活参数的调节接口，直接设置原生socket选项
+    const qintptr descriptor = tcp_socket->socketDescriptor();
+    const int idle = options_.keepalive_idle_seconds;
+    const int interval = options_.keepalive_interval_seconds;
+    const int count = options_.keepalive_count;
+#if defined(Q_OS_WIN) && defined(TCP_KEEPCNT)
+    // Windows 10 1709 及以上的SDK提供这些选项
+    const SOCKET handle = static_cast<SOCKET>(descriptor);
+    ::setsockopt(handle, IPPROTO_TCP, TCP_KEEPALIVE, reinterpret_cast<const char*>(&idle), sizeof(idle));
+    ::setsockopt(handle, IPPROTO_TCP, TCP_KEEPINTVL, reinterpret_cast<const char*>(&interval), sizeof(interval));
+    ::setsockopt(handle, IPPROTO_TCP, TCP_KEEPCNT, reinterpret_cast<const char*>(&count), sizeof(count));
+#elif defined(Q_OS_MACOS)
+    const int fd = static_cast<int>(descriptor);
+    ::setsockopt(fd, IPPROTO_TCP, TCP_KEEPALIVE, &idle, sizeof(idle));
+    ::setsockopt(fd, IPPROTO_TCP, TCP_KEEPINTVL, &interval, sizeof(interval));
+    ::setsockopt(fd, IPPROTO_TCP, TCP_KEEPCNT, &count, sizeof(count));
+#elif defined(Q_OS_UNIX)
+    const int fd = static_cast<int>(descriptor);
+    ::setsockopt(fd, IPPROTO_TCP, TCP_KEEPIDLE, &idle, sizeof(idle));
+    ::setsockopt(fd, IPPROTO_TCP, TCP_KEEPINTVL, &interval, sizeof(interval));
+    ::setsockopt(fd, IPPROTO_TCP, TCP_KEEPCNT, &count, sizeof(count));
+#else
+    Q_UNUSED(descriptor)
+    Q_UNUSED(idle)
+    Q_UNUSED(interval)
+    Q_UNUSED(count)
+#endif
+}
@@ -0,0 +1,141 @@
+#ifndef MASTER_SRC_IPCSTREAMSERVER_H_
+#define MASTER_SRC_IPCSTREAMSERVER_H_
+
+#include <QHostAddress>
+#include <QIODevice>
+#include <QJsonObject>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <memory>
+#include <vector>
+
+class QLocalServer;
+class QTcpServer;
+
+/**
+ * @brief 流式IPC服务端的传输适配接口
+ *
+ * 把QLocalServer/QTcpServer及其socket的差异收敛在这里，StreamIpcReactor
+ * 只通过QIODevice读写数据。接受的socket与服务端解除父子关系，
+ * 由反应器的连接表独占持有。所有方法只在I/O线程调用。
+ */
+class IpcStreamServer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit IpcStreamServer(QObject* parent = nullptr) : QObject(parent) {}
+    ~IpcStreamServer() override = default;
+
+    /**
+     * @brief 开始监听
+     * @param error 失败时的错误信息
+     * @return 是否成功
+     */
+    virtual bool listen(QString* error) = 0;
+
+    /**
+     * @brief 停止监听（不影响已接受的连接）
+     */
+    virtual void close() = 0;
+
+    /**
+     * @brief 服务端名称或地址，用于日志和派生资源命名
+     */
+    virtual QString serverName() const = 0;
+
+    /**
+     * @brief 取出一个待接受的连接
+     * @return socket，没有待接受的连接时返回nullptr
+     */
+    virtual QIODevice* nextPendingConnection() = 0;
+
+    virtual bool isConnected(QIODevice* socket) const = 0;
+
+    /**
+     * @brief 优雅断开（等待发送缓冲写完）
+     */
+    virtual void disconnectSocket(QIODevice* socket) = 0;
+
+    /**
+     * @brief 立即中断连接
+     */
+    virtual void abortSocket(QIODevice* socket) = 0;
+
+    /**
+     * @brief 把发送缓冲中的数据尽量写入内核（不阻塞）
+     */
+    virtual void flushSocket(QIODevice* socket) = 0;
+
+signals:
+    void newConnection();
+    void socketDisconnected(QIODevice* socket);
+    void socketError(QIODevice* socket, const QString& error_message);
+};
+
+/**
+ * @brief 基于QLocalServer的服务端
+ */
+class LocalStreamServer : public IpcStreamServer {
+    Q_OBJECT
+
+public:
+    explicit LocalStreamServer(const QString& server_name, QObject* parent = nullptr);
+    ~LocalStreamServer() override;
+
+    bool listen(QString* error) override;
+    void close() override;
+    QString serverName() const override;
+    QIODevice* nextPendingConnection() override;
+    bool isConnected(QIODevice* socket) const override;
+    void disconnectSocket(QIODevice* socket) override;
+    void abortSocket(QIODevice* socket) override;
+    void flushSocket(QIODevice* socket) override;
+
+private:
+    QString server_name_;
+    std::unique_ptr<QLocalServer> server_;
+};
+
+/**
+ * @brief TCP服务端选项，取自 ipc.tcp_socket
+ */
+struct TcpStreamServerOptions {
+    QList<QHostAddress> bind_addresses{QHostAddress(QHostAddress::LocalHost)};
+    quint16 port = 27500;
+    bool no_delay = true;                // TCP_NODELAY
+    bool keepalive = true;               // SO_KEEPALIVE
+    int keepalive_idle_seconds = 10;     // 空闲多久开始探测（<=0使用系统默认）
+    int keepalive_interval_seconds = 5;  // 探测间隔
+    int keepalive_count = 3;             // 判定断开前的探测次数
+
+    static TcpStreamServerOptions fromJson(const QJsonObject& tcp_socket);
+};
+
+/**
+ * @brief 基于QTcpServer的服务端，可同时监听多个绑定地址
+ */
+class TcpStreamServer : public IpcStreamServer {
+    Q_OBJECT
+
+public:
+    explicit TcpStreamServer(const TcpStreamServerOptions& options, QObject* parent = nullptr);
+    ~TcpStreamServer() override;
+
+    bool listen(QString* error) override;
+    void close() override;
+    QString serverName() const override;
+    QIODevice* nextPendingConnection() override;
+    bool isConnected(QIODevice* socket) const override;
+    void disconnectSocket(QIODevice* socket) override;
+    void abortSocket(QIODevice* socket) override;
+    void flushSocket(QIODevice* socket) override;
+
+private:
+    TcpStreamServerOptions options_;
+    std::vector<std::unique_ptr<QTcpServer>> servers_;
+
+    void ApplySocketOptions(QIODevice* socket) const;
+};
+
+#endif // MASTER_SRC_IPCSTREAMSERVER_H_
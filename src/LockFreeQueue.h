@@ -0,0 +1,86 @@
+#ifndef MASTER_SRC_LOCKFREEQUEUE_H_
+#define MASTER_SRC_LOCKFREEQUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/**
+ * @brief 无锁多生产者单消费者队列（Vyukov MPSC）
+ *
+ * 用于I/O线程与主线程之间传递消息：任意线程都可以push，只允许一个固定的
+ * 消费者线程调用tryPop。push是wait-free的（一次原子交换），tryPop不加锁。
+ *
+ * 生产者在交换head与链接next之间存在极短的中间态，此时tryPop可能暂时
+ * 看不到刚入队的元素；调用方应在push之后再触发消费者的唤醒，
+ * 消费者被唤醒后总能取到该元素。
+ */
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() : head_(new Node()), tail_(head_.load(std::memory_order_relaxed)) {}
+
+    ~MpscQueue()
+    {
+        T discarded;
+        while (tryPop(&discarded)) {
+        }
+        delete tail_;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /**
+     * @brief 入队（任意线程）
+     * @param value 要入队的元素
+     */
+    void push(T value)
+    {
+        Node* node = new Node(std::move(value));
+        size_.fetch_add(1, std::memory_order_relaxed);
+        Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    /**
+     * @brief 出队（仅消费者线程）
+     * @param out 输出元素
+     * @return 是否取到元素
+     */
+    bool tryPop(T* out)
+    {
+        Node* tail = tail_;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return false;
+        }
+        *out = std::move(next->value);
+        tail_ = next;
+        delete tail;
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief 近似的队列长度，仅用于统计
+     */
+    std::size_t approximateSize() const
+    {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Node {
+        Node() = default;
+        explicit Node(T v) : value(std::move(v)) {}
+        std::atomic<Node*> next{nullptr};
+        T value{};
+    };
+
+    alignas(64) std::atomic<Node*> head_;     // 生产者端
+    alignas(64) Node* tail_;                  // 消费者端（哨兵节点）
+    alignas(64) std::atomic<std::size_t> size_{0};
+};
+
+#endif // MASTER_SRC_LOCKFREEQUEUE_H_
@@ -5,7 +5,10 @@
 #include "IIpcCommunication.h"
 #include "update_checker.h"
 #include "PluginManager.h"
+#include "PeerChannelBroker.h"
+#include "ProcessStartupPlan.h"
 #include <QUuid>
+#include <QPromise>
 #include <QFile>
 #include <QDebug>
 #include <QCoreApplication>
@@ -13,7 +16,7 @@
 #include <QStandardPaths>
 #include <QThread>
 #include <QJsonArray>
-#include <QtConcurrent/QtConcurrent>
+#include <QEventLoop>
 
 #ifdef Q_OS_WIN
 #include <windows.h>
@@ -31,6 +34,7 @@ MainController::MainController(QObject* parent)
     , initialization_state_(kNotInitialized)
     , system_status_(kSystemIdle)
     , is_system_healthy_(false)
+    , shutdown_in_progress_(false)
     , startup_time_(QDateTime::currentDateTime())
     , health_check_interval_ms_(5000)      // 默认5秒健康检查
     , statistics_update_interval_ms_(10000) // 默认10秒统计更新
@@ -191,66 +195,125 @@ bool MainController::Start()
 
 bool MainController::Stop(int timeout_ms)
 {
+    {
+        QMutexLocker locker(&state_mutex_);
+        if (initialization_state_ != kStarted && !shutdown_in_progress_) {
+            qDebug() << "[MainController] 系统未启动，无需停止";
+            return true;
+        }
+    }
+
+    // 局部事件循环中子进程的应答、退出和各阶段期限照常处理
+    QEventLoop loop;
+    connect(this, &MainController::ShutdownFinished, &loop, &QEventLoop::quit);
+    BeginShutdown(timeout_ms);
+
     QMutexLocker locker(&state_mutex_);
-    
-    if (initialization_state_ != kStarted) {
-        qDebug() << "[MainController] 系统未启动，无需停止";
-        return true;
+    if (shutdown_in_progress_) {
+        locker.unlock();
+        loop.exec();
     }
-    
-    qDebug() << "[MainController] 开始停止系统服务";
-    UpdateInitializationState(kStopping);
-    UpdateSystemStatus(kSystemMaintenance);
-    
-    try {
-        // 1. 停止系统监控
-        StopSystemMonitoring();
-
-        // 1.1 优雅关闭提示：先通知子进程自行退出（通过IPC），给予短暂宽限
-        if (ipc_context_ && process_manager_) {
-            QJsonObject params; 
-            params["command"] = "graceful_shutdown";
-            BroadcastCommand("graceful_shutdown", params);
+    return true;
+}
+
+void MainController::BeginShutdown(int exit_timeout_ms)
+{
+    {
+        QMutexLocker locker(&state_mutex_);
+        if (shutdown_in_progress_) {
+            qDebug() << "[MainController] 停止流程已在进行";
+            return;
+        }
+        if (initialization_state_ != kStarted) {
+            qDebug() << "[MainController] 系统未启动，无需停止";
+            QMetaObject::invokeMethod(this, [this]() { emit ShutdownFinished(QJsonObject()); },
+                                      Qt::QueuedConnection);
+            return;
         }
 
-        QThread::msleep(200);
+        qDebug() << "[MainController] 开始停止系统服务";
+        shutdown_in_progress_ = true;
+        UpdateInitializationState(kStopping);
+        UpdateSystemStatus(kSystemMaintenance);
+    }
 
-        // 2. 停止IPC服务
-        if (ipc_context_)
-        {
-            ipc_context_->stop();
-            qDebug() << "[MainController] IPC服务已停止";
-        }
+    // 1. 停止系统监控和尚未完成的启动流程
+    StopSystemMonitoring();
+    startup_plan_.reset();
 
+    // 2. 读取各阶段等待时间
+    ProcessManager::ShutdownPolicy policy;
+    if (project_config_) {
+        const QJsonObject config = project_config_->getConfigValue("shutdown").toObject();
+        policy.ack_timeout_ms = config.value("ack_timeout_ms").toInt(policy.ack_timeout_ms);
+        policy.exit_timeout_ms = config.value("exit_timeout_ms").toInt(policy.exit_timeout_ms);
+        policy.terminate_timeout_ms = config.value("terminate_timeout_ms").toInt(policy.terminate_timeout_ms);
+        policy.kill_timeout_ms = config.value("kill_timeout_ms").toInt(policy.kill_timeout_ms);
+    }
+    if (exit_timeout_ms >= 0) {
+        policy.exit_timeout_ms = exit_timeout_ms;
+    }
 
-        // 4. 保存最终状态
-        if (data_store_)
-        {
-            // 保存关键状态信息
-            data_store_->setValue("system.shutdown_time", QDateTime::currentDateTime());
-            data_store_->setValue("system.shutdown_reason", "normal");
+    // 3. 通知插件自行退出，插件以topic为shutdown_ack的kShutdown应答；发不出去就直接terminate
+    bool notified = false;
+    if (ipc_context_) {
+        IpcMessage notice;
+        notice.type = MessageType::kShutdown;
+        notice.topic = "shutdown";
+        notice.msg_id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        notice.timestamp = QDateTime::currentMSecsSinceEpoch();
+        notice.sender_id = "main_controller";
+        notice.body["reason"] = "normal";
+        notice.body["deadline_ms"] = policy.ack_timeout_ms + policy.exit_timeout_ms;
+        notified = ipc_context_->broadcastMessage(notice);
+    }
+    if (!notified) {
+        qWarning() << "[MainController] 无法广播关闭通知，直接终止子进程";
+        policy.ack_timeout_ms = 0;
+    }
+
+    // 4. 等待子进程退出，ProcessManager::ShutdownFinished 时进入 FinishShutdown
+    if (!process_manager_) {
+        FinishShutdown(QJsonObject());
+    } else if (!process_manager_->BeginShutdown(policy)) {
+        qDebug() << "[MainController] 等待进行中的子进程停止流程结束";
+    }
+}
+
+void MainController::FinishShutdown(const QJsonObject& summary)
+{
+    {
+        QMutexLocker locker(&state_mutex_);
+        if (!shutdown_in_progress_) {
+            return;
         }
+    }
+
+    // 子进程都已退出，拆除插件间直连通道，然后停止IPC服务
+    if (peer_channel_broker_) {
+        peer_channel_broker_->closeAll("主控停止");
+    }
+    if (ipc_context_) {
+        ipc_context_->stop();
+        qDebug() << "[MainController] IPC服务已停止";
+    }
 
-        // // 5. 停止所有子进程（作为兜底）
-        // if (process_manager_)
-        // {
-        //     if (!process_manager_->StopAllProcesses(timeout_ms / 2)) {
-        //         qWarning() << "[MainController] 部分子进程停止超时";
-        //     }
-        // }
-        // qDebug() << "[MainController] 所有子进程已停止";
+    // 保存最终状态
+    if (data_store_) {
+        data_store_->setValue("system.shutdown_time", QDateTime::currentDateTime());
+        data_store_->setValue("system.shutdown_reason", "normal");
+        data_store_->setValue("system.shutdown_summary", summary);
+    }
 
-        
+    {
+        QMutexLocker locker(&state_mutex_);
+        shutdown_in_progress_ = false;
         UpdateInitializationState(kStopped);
         UpdateSystemStatus(kSystemIdle);
-        
-        qDebug() << "[MainController] 系统停止完成";
-        return true;
-        
-    } catch (const std::exception& e) {
-        HandleSystemError(QString("停止异常: %1").arg(e.what()), false);
-        return false;
     }
+
+    qDebug() << "[MainController] 系统停止完成" << summary;
+    emit ShutdownFinished(summary);
 }
 
 bool MainController::Restart(const QString& config_file_path)
@@ -308,6 +371,10 @@ bool MainController::IsSystemHealthy() const
 
 QJsonObject MainController::GetSystemStatistics() const
 {
+    // 传输层统计需要跨线程采集，在持有本地锁之前获取
+    const QJsonObject ipc_statistics = ipc_context_ ? ipc_context_->getStatistics() : QJsonObject();
+    const QJsonObject command_statistics = ipc_context_ ? ipc_context_->getRequestStatistics() : QJsonObject();
+
     QMutexLocker stat_locker(&statistics_mutex_);
     QMutexLocker state_locker(&state_mutex_);
     
@@ -330,6 +397,11 @@ QJsonObject MainController::GetSystemStatistics() const
     modules["data_store"] = (data_store_ != nullptr);
     modules["ipc_context"] = (ipc_context_ != nullptr);
     stats["modules"] = modules;
+    stats["ipc"] = ipc_statistics;
+    stats["command_latency"] = command_statistics;
+    if (peer_channel_broker_) {
+        stats["peer_channels"] = peer_channel_broker_->statistics();
+    }
     
     return stats;
 }
@@ -404,6 +476,7 @@ bool MainController::StartSubProcess(const QString& process_id, bool force_resta
     }
     QString working_dir = process_config_item["working_directory"].toString();
     
+    // 非阻塞启动，进入运行状态后由 SubProcessStarted 通知
     bool success = process_manager_->StartProcess(process_id, executable, arguments, working_dir);
     
     if (success) {
@@ -411,7 +484,7 @@ bool MainController::StartSubProcess(const QString& process_id, bool force_resta
         QMutexLocker locker(&statistics_mutex_);
         // 这里可能需要统计启动次数
         
-        qDebug() << "[MainController] 子进程启动成功:" << process_id;
+        qDebug() << "[MainController] 子进程启动请求已发出:" << process_id;
     } else {
         qWarning() << "[MainController] 子进程启动失败:" << process_id;
     }
@@ -419,6 +492,89 @@ bool MainController::StartSubProcess(const QString& process_id, bool force_resta
     return success;
 }
 
+quint64 MainController::StartSubProcesses(const QStringList& process_ids)
+{
+    if (!process_manager_) {
+        qWarning() << "[MainController] ProcessManager未初始化";
+        return 0;
+    }
+
+    const quint64 batch_id = process_manager_->StartProcesses(process_ids);
+    qDebug() << "[MainController] 并发启动子进程, 批次:" << batch_id << process_ids;
+    return batch_id;
+}
+
+bool MainController::StartProcessGraph(const QStringList& process_ids)
+{
+    if (!process_manager_ || !project_config_) {
+        qWarning() << "[MainController] ProcessManager或ProjectConfig未初始化";
+        return false;
+    }
+    if (startup_plan_ && !startup_plan_->isFinished()) {
+        qWarning() << "[MainController] 已有启动流程在进行中";
+        return false;
+    }
+
+    const QJsonObject processes_config = project_config_->getConfigValue("processes").toObject();
+    QStringList targets = process_ids;
+    if (targets.isEmpty()) {
+        for (auto it = processes_config.constBegin(); it != processes_config.constEnd(); ++it) {
+            if (it.value().toObject().value("auto_start").toBool(true)) {
+                targets.append(it.key());
+            }
+        }
+    }
+
+    QSet<QString> running;
+    for (const QString& process_id : process_manager_->GetProcessList()) {
+        if (process_manager_->GetProcessStatus(process_id) == ProcessManager::kRunning) {
+            running.insert(process_id);
+        }
+    }
+
+    auto plan = std::make_unique<ProcessStartupPlan>();
+    QString error_message;
+    if (!plan->build(processes_config, targets, running, &error_message)) {
+        qWarning() << "[MainController] 启动图无效:" << error_message;
+        return false;
+    }
+
+    // 进程事件反馈给启动图；连接以启动图为上下文，启动图替换后自动断开
+    ProcessStartupPlan* raw_plan = plan.get();
+    connect(raw_plan, &ProcessStartupPlan::launchRequested, this, [this](const QStringList& wave) {
+        if (process_manager_) {
+            process_manager_->StartProcesses(wave);
+        }
+    });
+    connect(raw_plan, &ProcessStartupPlan::processReady, this, &MainController::SubProcessReady);
+    connect(raw_plan, &ProcessStartupPlan::finished, this, &MainController::ProcessGraphStartFinished);
+    connect(process_manager_, &ProcessManager::ProcessStarted, raw_plan, &ProcessStartupPlan::markStarted);
+    connect(process_manager_, &ProcessManager::ProcessCrashed, raw_plan, &ProcessStartupPlan::markFailed);
+    connect(process_manager_, &ProcessManager::ProcessStopped, raw_plan,
+            [raw_plan](const QString& process_id, int exit_code) {
+                raw_plan->markFailed(process_id, QString("进程退出，退出码 %1").arg(exit_code));
+            });
+    connect(process_manager_, &ProcessManager::ProcessBatchStarted, raw_plan,
+            [raw_plan](quint64, const QStringList& started, const QStringList& failed) {
+                // 批次中已在运行的进程不会再发出ProcessStarted
+                for (const QString& process_id : started) {
+                    raw_plan->markStarted(process_id);
+                }
+                for (const QString& process_id : failed) {
+                    raw_plan->markFailed(process_id, "启动失败");
+                }
+            });
+
+    startup_plan_ = std::move(plan);
+    startup_plan_->start();
+    return true;
+}
+
+QJsonObject MainController::GetStartupReport() const
+{
+    return startup_plan_ ? startup_plan_->report() : QJsonObject();
+}
+
 bool MainController::StopSubProcess(const QString& process_id, int timeout_ms)
 {
     if (!process_manager_) {
@@ -712,12 +868,12 @@ void MainController::finishEmbeddingProcess(const QString& process_name)
 
 
 /**
- * @brief 发送命令到指定进程并等待响应
+ * @brief 发送命令到指定进程，响应通过CommandCompleted信号异步通知
  * @param process_id 目标进程ID
  * @param command 命令字符串
  * @param parameters 命令参数
  * @param timeout_ms 响应超时时间（毫秒）
- * @return 命令响应结果的JSON对象
+ * @return 发送结果的JSON对象，包含用于关联响应的request_id
  */
 QJsonObject MainController::SendCommandToProcess(const QString& process_id, 
                                                 const QString& command, 
@@ -734,7 +890,50 @@ QJsonObject MainController::SendCommandToProcess(const QString& process_id,
         response["error"] = "IPC未初始化";
         return response;
     }
-    
+
+    const QString request_id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    QFuture<IpcRequestResult> future = DispatchCommand(request_id, process_id, command, parameters, timeout_ms);
+    response["request_id"] = request_id;
+
+    // 发送失败时future已同步完成
+    if (future.isFinished()) {
+        response["error"] = future.result().error;
+        return response;
+    }
+
+    response["success"] = true;
+    response["pending"] = true;
+    response["message"] = "命令已发送，等待响应";
+    return response;
+}
+
+QFuture<IpcRequestResult> MainController::SendCommandAsync(const QString& process_id,
+                                                           const QString& command,
+                                                           const QJsonObject& parameters,
+                                                           int timeout_ms)
+{
+    if (!ipc_context_) {
+        IpcRequestResult result;
+        result.error = "IPC未初始化";
+        QPromise<IpcRequestResult> promise;
+        promise.start();
+        promise.addResult(result);
+        promise.finish();
+        return promise.future();
+    }
+    return DispatchCommand(QUuid::createUuid().toString(QUuid::WithoutBraces),
+                           process_id, command, parameters, timeout_ms);
+}
+
+/**
+ * @brief 构建发往指定进程的命令消息
+ * @param msg_id 消息ID，登记请求时同时作为请求ID
+ */
+IpcMessage MainController::BuildCommandMessage(const QString& msg_id,
+                                               const QString& process_id,
+                                               const QString& command,
+                                               const QJsonObject& parameters) const
+{
     // 1. 根据 command 字符串确定 IpcMessage::MessageType
     MessageType msg_type;
     if (command == "config_update") {
@@ -750,24 +949,43 @@ QJsonObject MainController::SendCommandToProcess(const QString& process_id,
     IpcMessage ipc_msg;
     ipc_msg.type = msg_type;
     ipc_msg.topic = "MainController";
-    ipc_msg.msg_id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    ipc_msg.msg_id = msg_id;
     ipc_msg.timestamp = QDateTime::currentMSecsSinceEpoch();
     ipc_msg.sender_id = "MainController";
     ipc_msg.receiver_id = process_id;
     ipc_msg.body = parameters;
-    if (ipc_context_) {
-        if (!ipc_context_->sendMessage(ipc_msg)) {
-            qWarning() << "[MainController] 发送命令失败到:" << ipc_msg.receiver_id;
-        }
+
+    return ipc_msg;
+}
+
+/**
+ * @brief 构建命令消息并交给IpcContext登记发送
+ * @param request_id 请求ID，同时作为消息的msg_id
+ * @return 在响应到达、超时或发送失败时完成的future
+ */
+QFuture<IpcRequestResult> MainController::DispatchCommand(const QString& request_id,
+                                                          const QString& process_id,
+                                                          const QString& command,
+                                                          const QJsonObject& parameters,
+                                                          int timeout_ms)
+{
+    // 登记并发送，截止时间由IpcContext的请求表统一管理
+    const IpcMessage ipc_msg = BuildCommandMessage(request_id, process_id, command, parameters);
+    QFuture<IpcRequestResult> future = ipc_context_->sendRequest(ipc_msg, timeout_ms, command);
+    if (future.isFinished()) {
+        qWarning() << "[MainController] 发送命令失败到:" << process_id << future.result().error;
+    } else {
+        QMutexLocker locker(&statistics_mutex_);
+        system_statistics_.total_commands_executed++;
     }
-    
-    // 更新统计信息
-    QMutexLocker locker(&statistics_mutex_);
-    system_statistics_.total_commands_executed++;
 
-    response["success"] = true;  // 临时设置
-    response["message"] = "命令已发送";
-    return response;
+    future.then(this, [this, request_id, process_id, command](const IpcRequestResult& result) {
+        if (result.timed_out) {
+            qWarning() << "[MainController] 命令" << command << "到" << process_id << "等待响应超时";
+        }
+        emit CommandCompleted(request_id, process_id, command, result.toJson());
+    });
+    return future;
 }
 
 QJsonObject MainController::BroadcastCommand(const QString& command, 
@@ -793,13 +1011,25 @@ QJsonObject MainController::BroadcastCommand(const QString& command,
     QJsonObject process_responses;
     int success_count = 0;
     
+    // 广播是通知，插件不会回复，直接发送而不登记请求，避免每个进程都等到超时
     for (const QString& process_id : running_processes) {
-        QJsonObject single_response = SendCommandToProcess(process_id, command, parameters);
-        process_responses[process_id] = single_response;
-        
+        const IpcMessage ipc_msg = BuildCommandMessage(QUuid::createUuid().toString(QUuid::WithoutBraces),
+                                                       process_id, command, parameters);
+        QJsonObject single_response;
+        single_response["process_id"] = process_id;
+        single_response["msg_id"] = ipc_msg.msg_id;
+        single_response["success"] = ipc_context_->sendMessage(ipc_msg);
         if (single_response["success"].toBool()) {
             success_count++;
+        } else {
+            qWarning() << "[MainController] 广播命令" << command << "发送失败到:" << process_id;
         }
+        process_responses[process_id] = single_response;
+    }
+
+    if (success_count > 0) {
+        QMutexLocker locker(&statistics_mutex_);
+        system_statistics_.total_commands_executed += success_count;
     }
     
     response["success"] = (success_count > 0);
@@ -977,6 +1207,18 @@ void MainController::HandleIpcMessage(const IpcMessage& message)
         case MessageType::kHeartbeat:
             HandleHeartbeatMessage(message);
             break;
+        case MessageType::kCommand:
+            // 插件发给主控的命令：目前只有直连通道的申请与关闭
+            if (!peer_channel_broker_ || !peer_channel_broker_->handleCommand(message)) {
+                qDebug() << "[MainController] 未处理的插件命令:" << message.topic << "来自:" << message.sender_id;
+            }
+            break;
+        case MessageType::kShutdown:
+            // 插件确认收到关闭通知，随后自行退出
+            if (message.topic == "shutdown_ack" && process_manager_) {
+                process_manager_->AcknowledgeShutdown(message.sender_id);
+            }
+            break;
         default:
             qDebug() << "[MainController] 未处理的消息类型:" << static_cast<int>(message.type);
             break;
@@ -1014,15 +1256,17 @@ void MainController::HandleIpcConnectionEvent(const QString& client_id, bool con
         ipc_msg.sender_id = "MainController";
         ipc_msg.receiver_id = client_id;
         ipc_msg.body = last_config_update_params_;
-        QtConcurrent::run([this, client_id, ipc_msg]() {
-            ipc_context_->sendMessage(client_id, ipc_msg);
-        });
+        // 发送接口只入队并唤醒I/O线程，可直接在主线程调用
+        ipc_context_->sendMessage(client_id, ipc_msg);
         qDebug() << "[MainController] 发送配置更新消息到客户端:" << client_id;
         
         emit IpcClientConnected(client_id, QJsonObject());
         
     } else {
         qDebug() << "[MainController] IPC连接断开:" << client_id;
+        if (peer_channel_broker_) {
+            peer_channel_broker_->handleClientDisconnected(client_id);
+        }
         
         // 更新DataStore
         if (data_store_) {
@@ -1143,8 +1387,9 @@ bool MainController::InitializeCoreModules()
             return false;
         }
         
-        // 5. 获取ProcessManager单例
+        // 5. 获取ProcessManager单例，心跳检查使用IPC传输层记录的活跃时间
         process_manager_ = &ProcessManager::GetInstance();
+        process_manager_->SetLivenessTable(ipc_context_->livenessTable());
         
         // 6. 从配置中注册所有进程到ProcessManager
         QJsonObject processes_config = project_config_->getFullConfig().value("processes").toObject();
@@ -1163,6 +1408,8 @@ bool MainController::InitializeCoreModules()
 
             if (!executable.isEmpty()) {
                 process_manager_->AddProcess(process_id, executable, arguments, workdir);
+                process_manager_->SetRestartPolicy(
+                    process_id, ProcessManager::RestartPolicy::fromJson(process_details.value("restart")));
             } else {
                 qWarning() << "[MainController] 进程配置错误: 进程" << process_id << "缺少 'executable' 字段";
             }
@@ -1318,7 +1565,9 @@ void MainController::CleanupSystemResources()
         statistics_timer_->stop();
     }
     
-    // 清理模块（智能指针会自动清理）
+    // 清理模块（智能指针会自动清理）；代理持有ipc_context_的裸指针，先释放
+    startup_plan_.reset();
+    peer_channel_broker_.reset();
     ipc_context_.reset();
     // data_store_和project_config_是单例，不需要清理
     // process_manager_不需要清理，因为它是单例
@@ -1369,10 +1618,13 @@ bool MainController::InitializeIpcFromConfig()
     qDebug() << "[MainController] 开始从配置中初始化IPC";
 
     // 创建IpcContext实例
+    peer_channel_broker_.reset();
     ipc_context_ = std::make_unique<IpcContext>();
 
     // IPC的具体初始化需要根据策略进行
     QJsonObject ipc_config = project_config_->getConfigValue("ipc").toObject();
+    peer_channel_broker_ = std::make_unique<PeerChannelBroker>(ipc_context_.get());
+    peer_channel_broker_->configure(ipc_config["peer_channels"].toObject());
     QString ipc_type_str = ipc_config["type"].toString("LocalSocket"); // 默认使用LocalSocket
     IpcType ipc_type = IpcCommunicationFactory::getIpcTypeFromString(ipc_type_str);
 
@@ -1396,6 +1648,44 @@ void MainController::ConnectModuleSignals()
                 this, &MainController::HandleProcessStatusChanged);
         connect(process_manager_, &ProcessManager::HeartbeatTimeout,
                 this, &MainController::HandleProcessHeartbeatTimeout);
+        connect(process_manager_, &ProcessManager::ProcessBatchStarted,
+                this, &MainController::SubProcessBatchStarted);
+        connect(process_manager_, &ProcessManager::ShutdownFinished,
+                this, &MainController::FinishShutdown);
+        connect(process_manager_, &ProcessManager::ProcessAutoRestarted,
+                this, [this](const QString& process_id, int restart_count) {
+                    {
+                        QMutexLocker locker(&statistics_mutex_);
+                        system_statistics_.total_process_restarts++;
+                    }
+                    emit SubProcessAutoRestarted(process_id, restart_count);
+                });
+        connect(process_manager_, &ProcessManager::ProcessRestartAbandoned,
+                this, [this](const QString& process_id, int restarts_in_window) {
+                    if (data_store_) {
+                        data_store_->setValue(QString("process.%1.restart_abandoned").arg(process_id),
+                                              QDateTime::currentDateTime());
+                    }
+                    TriggerEventCallback("process_restart_abandoned", {
+                        {"process_id", process_id},
+                        {"restarts_in_window", restarts_in_window},
+                        {"timestamp", QDateTime::currentDateTime().toString(Qt::ISODate)}
+                    });
+                });
+
+        // 进程退出时拆除它参与的插件间直连通道
+        connect(process_manager_, &ProcessManager::ProcessStopped,
+                this, [this](const QString& process_id, int exit_code) {
+                    if (peer_channel_broker_) {
+                        peer_channel_broker_->closeChannelsOf(process_id, QString("%1 已退出，退出码 %2").arg(process_id).arg(exit_code));
+                    }
+                });
+        connect(process_manager_, &ProcessManager::ProcessCrashed,
+                this, [this](const QString& process_id, const QString& error) {
+                    if (peer_channel_broker_) {
+                        peer_channel_broker_->closeChannelsOf(process_id, QString("%1 崩溃: %2").arg(process_id, error));
+                    }
+                });
     }
     
     
@@ -1453,6 +1743,10 @@ void MainController::TriggerEventCallback(const QString& event_type, const QJson
 void MainController::HandleHelloMessage(const IpcMessage& message)
 {
     qDebug() << "[MainController] 处理HELLO消息来自:" << message.sender_id;
+
+    if (startup_plan_) {
+        startup_plan_->markHello(message.sender_id);
+    }
     
     // 构造HELLO_ACK响应
     IpcMessage response;
@@ -1484,13 +1778,23 @@ void MainController::HandleHelloMessage(const IpcMessage& message)
 
 void MainController::HandleHeartbeatMessage(const IpcMessage& message)
 {
+    // 流式传输在I/O线程直接应答心跳并更新活跃度表，只把每条连接的首个心跳
+    // 转交过来（acknowledged为true，已应答）；其他策略的心跳都走到这里
+    // 心跳只取进程名，不解析整个消息体
+    const QString process_name = message.body.peek("process_name").toString();
+    if (startup_plan_) {
+        startup_plan_->markHeartbeat(process_name.isEmpty() ? message.sender_id : process_name);
+    }
+
     // 更新进程心跳
     if (process_manager_) {
-        QJsonObject body = message.body;
-        QString process_name = body["process_name"].toString();
         qDebug() << "[MainController] 更新心跳:" << process_name;
         process_manager_->UpdateHeartbeat(process_name);
     }
+
+    if (message.body.peek("acknowledged").toBool()) {
+        return;
+    }
     
     IpcMessage ack;
     ack.type = MessageType::kHeartbeatAck;
@@ -12,6 +12,7 @@
 #include <QStringList>
 #include <QDateTime>
 #include <QHash>
+#include <QFuture>
 #include <QQuickItem>
 #include <QQuickWindow>
 #include <QWindow>
@@ -25,8 +26,11 @@ class DataStore;
 class LogAggregator;
 class IpcContext;
 class UpdateChecker;
+class PeerChannelBroker;
+class ProcessStartupPlan;
 class PluginManager;
 struct IpcMessage;
+struct IpcRequestResult;
 struct LogEntry;
 
 /**
@@ -99,7 +103,20 @@ public:
      */
     Q_INVOKABLE bool Initialize(const QString& config_file_path = QString());
     Q_INVOKABLE bool Start();
-    Q_INVOKABLE bool Stop(int timeout_ms = 5000);
+    /**
+     * @brief 停止系统，在局部事件循环中等待BeginShutdown的流程结束
+     * @param timeout_ms 插件应答kShutdown后等待其自行退出的时间（毫秒），负数表示使用配置
+     */
+    Q_INVOKABLE bool Stop(int timeout_ms = -1);
+
+    /**
+     * @brief 开始异步停止系统，结束时发出ShutdownFinished
+     *
+     * 向所有插件广播kShutdown，各进程按配置shutdown段独立等待应答、自行退出，
+     * 超时后依次terminate、kill；全部进程退出后再停止IPC服务。
+     * @param exit_timeout_ms 覆盖配置中的exit_timeout_ms，负数表示使用配置
+     */
+    Q_INVOKABLE void BeginShutdown(int exit_timeout_ms = -1);
     Q_INVOKABLE bool Restart(const QString& config_file_path = QString());
     
     Q_INVOKABLE InitializationState GetInitializationState() const;
@@ -123,17 +140,64 @@ public:
     
     
     Q_INVOKABLE bool StartSubProcess(const QString& process_id, bool force_restart = false);
+
+    /**
+     * @brief 并发启动一组已注册的子进程（非阻塞）
+     * @param process_ids 进程ID列表
+     * @return 批次ID，全部有结果后通过 SubProcessBatchStarted 报告
+     */
+    Q_INVOKABLE quint64 StartSubProcesses(const QStringList& process_ids);
+
+    /**
+     * @brief 按processes配置中的depends_on/ready_on分波启动子进程
+     *
+     * 依赖全部就绪的进程成批并发启动，进程就绪后立即启动依赖它的下一批。
+     * 每个进程就绪时发出 SubProcessReady，全部完成后发出 ProcessGraphStartFinished。
+     * @param process_ids 要启动的进程（依赖自动加入），为空时启动所有auto_start的进程
+     * @return 启动图是否有效并已开始启动（同一时间只能有一个启动流程）
+     */
+    Q_INVOKABLE bool StartProcessGraph(const QStringList& process_ids = QStringList());
+
+    /**
+     * @brief 获取最近一次启动流程的报告（各进程波次、启动与就绪耗时）
+     */
+    Q_INVOKABLE QJsonObject GetStartupReport() const;
     
     Q_INVOKABLE bool StopSubProcess(const QString& process_id, int timeout_ms = 5000);
     
     
     Q_INVOKABLE QJsonObject GetAllProcessInfo() const;
     
+    /**
+     * @brief 发送命令到指定进程，不等待响应
+     *
+     * success 表示命令已交给目标进程的连接；响应（或超时）通过
+     * CommandCompleted 信号通知，结果中的 request_id 用于关联。
+     */
     Q_INVOKABLE QJsonObject SendCommandToProcess(const QString& process_id, 
                                    const QString& command, 
                                    const QJsonObject& parameters = QJsonObject(),
                                    int timeout_ms = 10000);
+
+    /**
+     * @brief 发送命令并返回可等待的结果（不阻塞事件循环）
+     * @param process_id 目标进程ID
+     * @param command 命令名称
+     * @param parameters 命令参数
+     * @param timeout_ms 等待响应的超时时间（毫秒）
+     * @return 收到kCommandResponse、超时或发送失败时完成
+     */
+    QFuture<IpcRequestResult> SendCommandAsync(const QString& process_id,
+                                               const QString& command,
+                                               const QJsonObject& parameters = QJsonObject(),
+                                               int timeout_ms = 10000);
     
+    /**
+     * @brief 向所有运行中的进程发送通知式命令，不登记请求、不等待响应
+     *
+     * 插件把广播当作通知处理，不会回复kCommandResponse；success_count为
+     * 已交给目标连接的进程数。
+     */
     Q_INVOKABLE QJsonObject BroadcastCommand(const QString& command, 
                                const QJsonObject& parameters = QJsonObject());
     Q_INVOKABLE QVariantList GetConfiguredProcessNames() const;
@@ -191,6 +255,40 @@ signals:
     void SubProcessStarted(const QString& process_id, const QJsonObject& process_info);
     void SubProcessStopped(const QString& process_id, int exit_code);
     void SubProcessCrashed(const QString& process_id, const QString& error_message);
+
+    /**
+     * @brief 子进程意外退出后按重启策略自动重启
+     * @param process_id 进程标识符
+     * @param restart_count 累计自动重启次数
+     */
+    void SubProcessAutoRestarted(const QString& process_id, int restart_count);
+
+    /**
+     * @brief 一批子进程全部启动完成
+     * @param batch_id StartSubProcesses 返回的批次ID
+     * @param started 启动成功的进程ID
+     * @param failed 启动失败的进程ID
+     */
+    void SubProcessBatchStarted(quint64 batch_id, const QStringList& started, const QStringList& failed);
+
+    /**
+     * @brief 子进程达到配置的就绪条件
+     * @param process_id 进程标识符
+     * @param time_to_ready_ms 从发起启动到就绪的毫秒数
+     */
+    void SubProcessReady(const QString& process_id, qint64 time_to_ready_ms);
+
+    /**
+     * @brief 启动流程结束，所有进程均已就绪或失败
+     * @param report 启动报告
+     */
+    void ProcessGraphStartFinished(const QJsonObject& report);
+
+    /**
+     * @brief 停止流程结束，子进程均已退出，IPC服务已停止
+     * @param summary 总耗时及每个进程的结束方式，系统未启动时为空
+     */
+    void ShutdownFinished(const QJsonObject& summary);
     
     // ==================== IPC通信信号 ====================
     
@@ -198,6 +296,16 @@ signals:
     
     void IpcClientDisconnected(const QString& client_id, const QString& reason);
     void IpcMessageReceived(const IpcMessage& message);
+
+    /**
+     * @brief 命令请求完成（收到响应、超时或发送失败）
+     * @param request_id SendCommandToProcess 返回的 request_id
+     * @param process_id 目标进程ID
+     * @param command 命令名称
+     * @param result 结果（success、timed_out、error、latency_ms、response）
+     */
+    void CommandCompleted(const QString& request_id, const QString& process_id,
+                          const QString& command, const QJsonObject& result);
     
     // ==================== 配置管理信号 ====================
     void ConfigurationFileChanged(const QString& config_path, const QString& change_type);
@@ -236,6 +344,11 @@ private:
     bool EmbedProcessWindowImpl(const QString& process_id, qulonglong container_window_id, const QRect& geometry);
     qulonglong FindProcessMainWindow(const QString& process_id, int max_retries = 10, int retry_delay_ms = 400);
     bool InitializeIpcFromConfig();
+    IpcMessage BuildCommandMessage(const QString& msg_id, const QString& process_id,
+                                   const QString& command, const QJsonObject& parameters) const;
+    QFuture<IpcRequestResult> DispatchCommand(const QString& request_id, const QString& process_id,
+                                              const QString& command, const QJsonObject& parameters,
+                                              int timeout_ms);
     void ConnectModuleSignals();
 
     void StartSystemMonitoring();
@@ -255,6 +368,12 @@ private:
 
     void HandleHeartbeatMessage(const IpcMessage& message);
 
+    /**
+     * @brief 子进程全部退出后停止IPC服务并发出ShutdownFinished
+     * @param summary ProcessManager的停止结果
+     */
+    void FinishShutdown(const QJsonObject& summary);
+
     void UpdateInitializationState(InitializationState new_state);
     void UpdateSystemStatus(SystemStatus new_status);
     void SyncConfigurationToDataStore();
@@ -295,12 +414,15 @@ private:
     DataStore* data_store_;           
     std::unique_ptr<IpcContext> ipc_context_;
     std::unique_ptr<UpdateChecker> update_checker_;
+    std::unique_ptr<PeerChannelBroker> peer_channel_broker_;  // 插件间直连通道的审批与生命周期
+    std::unique_ptr<ProcessStartupPlan> startup_plan_;        // 最近一次按依赖启动的流程
     
     // ==================== 状态管理 ====================
     mutable QMutex state_mutex_;
     InitializationState initialization_state_;
     SystemStatus system_status_;
     bool is_system_healthy_;
+    bool shutdown_in_progress_;        // BeginShutdown之后、FinishShutdown之前
     QString last_error_message_;
     QDateTime startup_time_;
     
@@ -0,0 +1,342 @@
+#include "PeerChannelBroker.h"
+#include <QDebug>
+#include <QFuture>
+#include <QJsonArray>
+#include <QLocalServer>
+#include <QUuid>
+
+namespace {
+    const QString kOpenPeerChannel = QStringLiteral("open_peer_channel");
+    const QString kClosePeerChannel = QStringLiteral("close_peer_channel");
+    const QString kPeerChannelOffer = QStringLiteral("peer_channel_offer");
+    const QString kPeerChannelClosed = QStringLiteral("peer_channel_closed");
+    const QString kTransportLocalSocket = QStringLiteral("local_socket");
+    const QString kTransportShm = QStringLiteral("shm");
+    const QString kBrokerSenderId = QStringLiteral("main_controller");
+}
+
+PeerChannelBroker::PeerChannelBroker(IpcContext* ipc_context, QObject* parent)
+    : QObject(parent)
+    , ipc_context_(ipc_context)
+{
+}
+
+PeerChannelBroker::~PeerChannelBroker() = default;
+
+void PeerChannelBroker::configure(const QJsonObject& config)
+{
+    enabled_ = config["enabled"].toBool(true);
+    max_channels_ = qMax(1, config["max_channels"].toInt(max_channels_));
+    offer_timeout_ms_ = qMax(100, config["offer_timeout_ms"].toInt(offer_timeout_ms_));
+    shm_ring_bytes_ = qMax<qint64>(4096, config["shm_ring_bytes"].toInteger(shm_ring_bytes_));
+
+    allow_.clear();
+    const QJsonObject allow = config["allow"].toObject();
+    for (auto it = allow.constBegin(); it != allow.constEnd(); ++it) {
+        QStringList peers;
+        for (const QJsonValue& peer : it.value().toArray()) {
+            peers.append(peer.toString());
+        }
+        allow_.insert(it.key(), peers);
+    }
+    qDebug() << "[PeerChannelBroker] 直连通道:" << (enabled_ ? "开启" : "关闭")
+             << "上限:" << max_channels_ << "审批规则数:" << allow_.size();
+}
+
+bool PeerChannelBroker::isBrokerCommand(const QString& topic)
+{
+    return topic == kOpenPeerChannel || topic == kClosePeerChannel;
+}
+
+bool PeerChannelBroker::handleCommand(const IpcMessage& message)
+{
+    if (message.type != MessageType::kCommand || !isBrokerCommand(message.topic)) {
+        return false;
+    }
+
+    if (message.topic == kOpenPeerChannel) {
+        openChannel(message);
+        return true;
+    }
+
+    const QString channel_id = message.body.value("channel_id").toString();
+    auto it = channels_.constFind(channel_id);
+    if (it == channels_.constEnd() ||
+        (it.value()->initiator != message.sender_id && it.value()->acceptor != message.sender_id)) {
+        respond(message, false, QJsonObject{{"channel_id", channel_id}}, "通道不存在或不属于请求方");
+        return true;
+    }
+    closeChannel(channel_id, "对端关闭", message.sender_id);
+    respond(message, true, QJsonObject{{"channel_id", channel_id}});
+    return true;
+}
+
+void PeerChannelBroker::openChannel(const IpcMessage& request)
+{
+    const QString initiator = request.sender_id;
+    const QString acceptor = request.body.value("peer").toString();
+    const QString transport = request.body.value("transport").toString(kTransportLocalSocket);
+
+    QString error;
+    if (!enabled_) {
+        error = "直连通道未启用";
+    } else if (acceptor.isEmpty() || acceptor == initiator) {
+        error = "peer无效";
+    } else if (transport != kTransportLocalSocket && transport != kTransportShm) {
+        error = QString("不支持的传输方式: %1").arg(transport);
+    } else if (channels_.size() >= max_channels_) {
+        error = "通道数量已达上限";
+    } else if (!isAllowed(initiator, acceptor)) {
+        error = QString("不允许 %1 与 %2 建立直连通道").arg(initiator, acceptor);
+    }
+
+    auto channel = std::make_shared<Channel>();
+    if (error.isEmpty()) {
+        channel->initiator_client_id = ipc_context_->getClientIdBySenderId(initiator);
+        channel->acceptor_client_id = ipc_context_->getClientIdBySenderId(acceptor);
+        if (channel->acceptor_client_id.isEmpty()) {
+            error = QString("插件 %1 未连接").arg(acceptor);
+        }
+    }
+    if (!error.isEmpty()) {
+        ++rejected_total_;
+        qWarning() << "[PeerChannelBroker] 拒绝直连通道申请:" << initiator << "->" << acceptor << error;
+        respond(request, false, QJsonObject{{"peer", acceptor}}, error);
+        return;
+    }
+
+    channel->id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    channel->initiator = initiator;
+    channel->acceptor = acceptor;
+    channel->transport = transport;
+    channel->server_name = QString("master_peer_%1").arg(channel->id);
+    channel->created_at = QDateTime::currentDateTime();
+
+    if (transport == kTransportShm) {
+        // 申请的环大小不能超过配置，否则任一插件都能让主控分配大量共享内存
+        const qint64 ring_bytes =
+            qBound<qint64>(0, request.body.value("ring_bytes").toInteger(shm_ring_bytes_), shm_ring_bytes_);
+        channel->shm = SharedMemoryChannel::create(channel->server_name + "_shm", ring_bytes, &error);
+        if (!channel->shm) {
+            ++rejected_total_;
+            qWarning() << "[PeerChannelBroker] 创建共享内存段失败:" << error;
+            respond(request, false, QJsonObject{{"peer", acceptor}}, QString("创建共享内存段失败: %1").arg(error));
+            return;
+        }
+    }
+
+    // 先登记，B在等待期间断开或进程退出时同样能拆除
+    channels_.insert(channel->id, channel);
+    qDebug() << "[PeerChannelBroker] 邀请" << acceptor << "接受来自" << initiator
+             << "的直连通道:" << channel->id << "传输:" << transport;
+
+    IpcMessage offer;
+    offer.type = MessageType::kCommand;
+    offer.topic = kPeerChannelOffer;
+    offer.msg_id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    offer.timestamp = QDateTime::currentMSecsSinceEpoch();
+    offer.sender_id = kBrokerSenderId;
+    offer.receiver_id = acceptor;
+    offer.body = describe(*channel, false);
+
+    const QString channel_id = channel->id;
+    ipc_context_->sendRequest(offer, offer_timeout_ms_, kPeerChannelOffer)
+        .then(this, [this, channel_id, request](const IpcRequestResult& result) {
+            completeOffer(channel_id, request, result);
+        });
+}
+
+void PeerChannelBroker::completeOffer(const QString& channel_id, const IpcMessage& request,
+                                      const IpcRequestResult& result)
+{
+    auto it = channels_.find(channel_id);
+    if (it == channels_.end()) {
+        // 等待期间已被拆除（对端断开或进程退出），申请方已收到关闭通知
+        respond(request, false, QJsonObject{{"channel_id", channel_id}}, "通道已被拆除");
+        return;
+    }
+    const std::shared_ptr<Channel> channel = it.value();
+
+    if (!result.success) {
+        ++rejected_total_;
+        const QString error = result.error.isEmpty() ? QString("对端拒绝") : result.error;
+        qWarning() << "[PeerChannelBroker] 直连通道未被接受:" << channel_id << error;
+        channels_.erase(it);
+        QLocalServer::removeServer(channel->server_name);
+        respond(request, false, QJsonObject{{"channel_id", channel_id}, {"peer", channel->acceptor}},
+                QString("%1 未接受通道: %2").arg(channel->acceptor, error));
+        return;
+    }
+
+    channel->state = ChannelState::kOpen;
+    ++opened_total_;
+    qDebug() << "[PeerChannelBroker] 直连通道已建立:" << channel->initiator << "<->"
+             << channel->acceptor << channel_id;
+    respond(request, true, describe(*channel, true));
+    emit PeerChannelOpened(channel_id, channel->initiator, channel->acceptor);
+}
+
+void PeerChannelBroker::closeChannel(const QString& channel_id, const QString& reason,
+                                     const QString& requested_by)
+{
+    auto it = channels_.find(channel_id);
+    if (it == channels_.end()) {
+        return;
+    }
+    const std::shared_ptr<Channel> channel = it.value();
+    channels_.erase(it);
+    ++closed_total_;
+
+    // 通知另一方（主动关闭或已退出的一方不再通知）
+    const QJsonObject body{{"channel_id", channel_id}, {"reason", reason}};
+    if (channel->initiator != requested_by) {
+        notify(channel->initiator, kPeerChannelClosed, body);
+    }
+    if (channel->acceptor != requested_by) {
+        notify(channel->acceptor, kPeerChannelClosed, body);
+    }
+
+    // 监听方异常退出时可能留下socket文件；共享内存段随channel释放
+    QLocalServer::removeServer(channel->server_name);
+    qDebug() << "[PeerChannelBroker] 拆除直连通道:" << channel_id << "原因:" << reason;
+    emit PeerChannelClosed(channel_id, reason);
+}
+
+int PeerChannelBroker::closeChannelsOf(const QString& process_id, const QString& reason)
+{
+    QStringList affected;
+    for (auto it = channels_.constBegin(); it != channels_.constEnd(); ++it) {
+        if (it.value()->initiator == process_id || it.value()->acceptor == process_id) {
+            affected.append(it.key());
+        }
+    }
+    for (const QString& channel_id : affected) {
+        closeChannel(channel_id, reason, process_id);
+    }
+    return static_cast<int>(affected.size());
+}
+
+void PeerChannelBroker::handleClientDisconnected(const QString& client_id)
+{
+    QStringList affected;
+    QString process_id;
+    for (auto it = channels_.constBegin(); it != channels_.constEnd(); ++it) {
+        Channel& channel = *it.value();
+        QString* bound_client_id = nullptr;
+        if (channel.initiator_client_id == client_id) {
+            bound_client_id = &channel.initiator_client_id;
+            process_id = channel.initiator;
+        } else if (channel.acceptor_client_id == client_id) {
+            bound_client_id = &channel.acceptor_client_id;
+            process_id = channel.acceptor;
+        } else {
+            continue;
+        }
+
+        // 直连通道不经过主控连接，进程仍在线时保留通道
+        const QString current_client_id = ipc_context_->getClientIdBySenderId(process_id);
+        if (!current_client_id.isEmpty() && current_client_id != client_id) {
+            qDebug() << "[PeerChannelBroker] 通道" << it.key() << "改绑到" << process_id << "的新连接";
+            *bound_client_id = current_client_id;
+            continue;
+        }
+        affected.append(it.key());
+    }
+    for (const QString& channel_id : affected) {
+        closeChannel(channel_id, QString("%1 连接断开").arg(process_id), process_id);
+    }
+}
+
+void PeerChannelBroker::closeAll(const QString& reason)
+{
+    const QStringList channel_ids = channels_.keys();
+    for (const QString& channel_id : channel_ids) {
+        closeChannel(channel_id, reason);
+    }
+}
+
+QJsonObject PeerChannelBroker::statistics() const
+{
+    QJsonArray channels;
+    for (const std::shared_ptr<Channel>& channel : channels_) {
+        channels.append(QJsonObject{
+            {"channel_id", channel->id},
+            {"initiator", channel->initiator},
+            {"acceptor", channel->acceptor},
+            {"transport", channel->transport},
+            {"state", channel->state == ChannelState::kOpen ? "open" : "pending"},
+            {"created_at", channel->created_at.toString(Qt::ISODate)}});
+    }
+
+    QJsonObject stats;
+    stats["enabled"] = enabled_;
+    stats["active_channels"] = static_cast<int>(channels_.size());
+    stats["opened_total"] = static_cast<qint64>(opened_total_);
+    stats["rejected_total"] = static_cast<qint64>(rejected_total_);
+    stats["closed_total"] = static_cast<qint64>(closed_total_);
+    stats["channels"] = channels;
+    return stats;
+}
+
+bool PeerChannelBroker::isAllowed(const QString& initiator, const QString& acceptor) const
+{
+    if (allow_.isEmpty()) {
+        return true;
+    }
+    const QStringList peers = allow_.value(initiator);
+    return peers.contains(acceptor) || peers.contains(QStringLiteral("*"));
+}
+
+QJsonObject PeerChannelBroker::describe(const Channel& channel, bool for_initiator) const
+{
+    QJsonObject body;
+    body["channel_id"] = channel.id;
+    body["peer"] = for_initiator ? channel.acceptor : channel.initiator;
+    body["role"] = for_initiator ? "connect" : "listen";
+    body["transport"] = channel.transport;
+    body["server_name"] = channel.server_name;
+    if (channel.shm) {
+        const QJsonObject description = channel.shm->describe();
+        for (auto it = description.constBegin(); it != description.constEnd(); ++it) {
+            body[it.key()] = it.value();
+        }
+        body["shm_side"] = for_initiator ? "a" : "b";
+    }
+    return body;
+}
+
+void PeerChannelBroker::respond(const IpcMessage& request, bool success, QJsonObject body,
+                                const QString& error)
+{
+    IpcMessage response;
+    response.type = MessageType::kCommandResponse;
+    response.topic = request.topic;
+    response.msg_id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    response.timestamp = QDateTime::currentMSecsSinceEpoch();
+    response.sender_id = kBrokerSenderId;
+    response.receiver_id = request.sender_id;
+    body["request_id"] = request.msg_id;
+    body["success"] = success;
+    if (!error.isEmpty()) {
+        body["error"] = error;
+    }
+    response.body = body;
+
+    if (!ipc_context_->sendMessage(response)) {
+        qWarning() << "[PeerChannelBroker] 应答发送失败到:" << request.sender_id;
+    }
+}
+
+void PeerChannelBroker::notify(const QString& receiver_id, const QString& topic, const QJsonObject& body)
+{
+    IpcMessage message;
+    message.type = MessageType::kCommand;
+    message.topic = topic;
+    message.msg_id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    message.timestamp = QDateTime::currentMSecsSinceEpoch();
+    message.sender_id = kBrokerSenderId;
+    message.receiver_id = receiver_id;
+    message.body = body;
+    // 对端可能已经退出，发送失败无需处理
+    ipc_context_->sendMessage(message);
+}
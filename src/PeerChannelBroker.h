@@ -0,0 +1,138 @@
+#ifndef MASTER_SRC_PEERCHANNELBROKER_H_
+#define MASTER_SRC_PEERCHANNELBROKER_H_
+
+#include "IIpcCommunication.h"
+#include "SharedMemoryChannel.h"
+#include <QDateTime>
+#include <QHash>
+#include <QJsonObject>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <memory>
+
+/**
+ * @brief 插件间直连通道的代理
+ *
+ * 大流量的插件间数据不经过主控：插件A向主控申请到插件B的通道，主控按策略
+ * 审批后分配专用的本地socket名称（可选再附带一个共享内存段），经现有IPC
+ * 分别告知双方，此后数据在A、B之间直接传输。主控只负责审批和生命周期：
+ * 任一方关闭、断开或进程退出时拆除通道并通知另一方。
+ *
+ * 协议（均为kCommand，以topic区分；响应为kCommandResponse，body.request_id为请求的msg_id）：
+ *   A -> 主控  open_peer_channel   {peer, transport: "local_socket" | "shm", ring_bytes?}
+ *   主控 -> B  peer_channel_offer  {channel_id, peer: A, role: "listen", server_name, ...}
+ *   B -> 主控  响应 {success}，B已在server_name上监听
+ *   主控 -> A  响应 {success, channel_id, peer: B, role: "connect", server_name, ...}
+ *   任一方 -> 主控  close_peer_channel  {channel_id}
+ *   主控 -> 双方    peer_channel_closed {channel_id, reason}（kCommand，无需响应）
+ *
+ * transport为shm时另带 shm_key / shm_native_key / shm_ring_bytes / shm_layout_version
+ * （布局同 SharedMemoryChannel）以及 shm_side：A为 "a"，写第一个环、读第二个环；
+ * B为 "b"，方向相反。本地socket连接此时只承载门铃字节。共享内存段由主控创建并
+ * 持有到通道拆除。
+ *
+ * 配置取自 ipc.peer_channels：
+ * - enabled: 是否允许申请通道（默认true）
+ * - max_channels: 同时存在的通道数上限
+ * - offer_timeout_ms: 等待B接受的时间
+ * - shm_ring_bytes: 共享内存通道每个方向的环大小，也是申请中ring_bytes的上限
+ * - allow: { "<A>": ["<B>", ...] | ["*"] }，为空时不限制
+ *
+ * 仅在主线程使用。
+ */
+class PeerChannelBroker : public QObject {
+    Q_OBJECT
+
+public:
+    explicit PeerChannelBroker(IpcContext* ipc_context, QObject* parent = nullptr);
+    ~PeerChannelBroker() override;
+
+    /**
+     * @brief 读取 ipc.peer_channels 配置
+     */
+    void configure(const QJsonObject& config);
+
+    /**
+     * @brief topic是否为代理处理的命令
+     */
+    static bool isBrokerCommand(const QString& topic);
+
+    /**
+     * @brief 处理插件发来的代理命令
+     * @return 消息属于代理命令返回true（已处理并应答）
+     */
+    bool handleCommand(const IpcMessage& message);
+
+    /**
+     * @brief 拆除某个插件参与的全部通道（进程退出时调用）
+     * @param process_id 进程标识符（即插件的逻辑ID）
+     * @param reason 通知给另一方的原因
+     * @return 拆除的通道数量
+     */
+    int closeChannelsOf(const QString& process_id, const QString& reason);
+
+    /**
+     * @brief IPC连接断开时拆除该连接参与的通道
+     *
+     * 策略迁移期间进程已以同一逻辑ID连上新策略时，只把通道改绑到新连接。
+     * @param client_id 内部客户端ID
+     */
+    void handleClientDisconnected(const QString& client_id);
+
+    /**
+     * @brief 拆除全部通道（系统停止时调用）
+     */
+    void closeAll(const QString& reason);
+
+    /**
+     * @brief 通道列表与累计计数
+     */
+    QJsonObject statistics() const;
+
+signals:
+    void PeerChannelOpened(const QString& channel_id, const QString& initiator, const QString& acceptor);
+    void PeerChannelClosed(const QString& channel_id, const QString& reason);
+
+private:
+    enum class ChannelState {
+        kPending = 0,        // 已发出邀请，等待B接受
+        kOpen                // 双方均已获知通道
+    };
+
+    struct Channel {
+        QString id;
+        QString initiator;            // A的逻辑ID
+        QString acceptor;             // B的逻辑ID
+        QString initiator_client_id;  // A的内部连接ID
+        QString acceptor_client_id;   // B的内部连接ID
+        QString transport;
+        QString server_name;
+        std::unique_ptr<SharedMemoryChannel> shm;
+        ChannelState state = ChannelState::kPending;
+        QDateTime created_at;
+    };
+
+    void openChannel(const IpcMessage& request);
+    void completeOffer(const QString& channel_id, const IpcMessage& request, const IpcRequestResult& result);
+    void closeChannel(const QString& channel_id, const QString& reason, const QString& requested_by = QString());
+    bool isAllowed(const QString& initiator, const QString& acceptor) const;
+    QJsonObject describe(const Channel& channel, bool for_initiator) const;
+    void respond(const IpcMessage& request, bool success, QJsonObject body, const QString& error = QString());
+    void notify(const QString& receiver_id, const QString& topic, const QJsonObject& body);
+
+    IpcContext* ipc_context_;
+    bool enabled_ = true;
+    int max_channels_ = 64;
+    int offer_timeout_ms_ = 5000;
+    qint64 shm_ring_bytes_ = 4 * 1024 * 1024;
+    QHash<QString, QStringList> allow_;    // A -> 允许的B，为空时不限制
+
+    QHash<QString, std::shared_ptr<Channel>> channels_;   // channel_id -> 通道
+
+    quint64 opened_total_ = 0;
+    quint64 rejected_total_ = 0;
+    quint64 closed_total_ = 0;
+};
+
+#endif // MASTER_SRC_PEERCHANNELBROKER_H_
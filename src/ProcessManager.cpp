@@ -1,24 +1,46 @@
 #include "ProcessManager.h"
+#include "DeadlineWheel.h"
+#include "IpcLivenessTable.h"
 #include <QStandardPaths>
 #include <QDir>
 #include <QDebug>
-#include <QCoreApplication>
-#include <QThread>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <cmath>
 
 // 静态成员初始化
 std::unique_ptr<ProcessManager> ProcessManager::instance_ = nullptr;
 QMutex ProcessManager::instance_mutex_;
 
+namespace {
+
+// 心跳截止时间的精度，超时在截止时间之后一个tick内发出
+constexpr int kHeartbeatDeadlineTickMs = 100;
+
+// 停止流程各阶段期限的精度
+constexpr int kShutdownDeadlineTickMs = 50;
+
+// 重启退避的精度
+constexpr int kRestartDeadlineTickMs = 50;
+
+} // namespace
+
 ProcessManager::ProcessManager(QObject* parent)
     : QObject(parent)
-    , heartbeat_timer_(nullptr)
+    , next_batch_id_(1)
+    , heartbeat_deadlines_(new DeadlineWheel(kHeartbeatDeadlineTickMs, this))
+    , shutdown_deadlines_(new DeadlineWheel(kShutdownDeadlineTickMs, this))
+    , shutting_down_(false)
+    , restart_deadlines_(new DeadlineWheel(kRestartDeadlineTickMs, this))
     , monitor_timer_(nullptr)
     , heartbeat_timeout_ms_(30000)      // 默认30秒心跳超时
-    , heartbeat_check_interval_ms_(10000)   // 默认10秒检查间隔
     , monitor_check_interval_ms_(5000)      // 默认5秒监控间隔
     , initialized_(false)
 {
     qDebug() << "[ProcessManager] 构造函数调用";
+    connect(heartbeat_deadlines_, &DeadlineWheel::expired, this, &ProcessManager::HandleHeartbeatDeadline);
+    connect(shutdown_deadlines_, &DeadlineWheel::expired, this, &ProcessManager::HandleShutdownDeadline);
+    connect(restart_deadlines_, &DeadlineWheel::expired, this, &ProcessManager::HandleRestartDeadline);
 }
 
 ProcessManager::~ProcessManager()
@@ -29,12 +51,6 @@ ProcessManager::~ProcessManager()
     // StopAllProcesses(5000);
     
     // 停止定时器
-    if (heartbeat_timer_) {
-        heartbeat_timer_->stop();
-        heartbeat_timer_->deleteLater();
-        heartbeat_timer_ = nullptr;
-    }
-    
     if (monitor_timer_) {
         monitor_timer_->stop();
         monitor_timer_->deleteLater();
@@ -51,6 +67,7 @@ ProcessManager::~ProcessManager()
         }
     }
     process_info_map_.clear();
+    qprocess_to_process_id_.clear();
 }
 
 ProcessManager& ProcessManager::GetInstance()
@@ -73,10 +90,7 @@ bool ProcessManager::Initialize()
     
     qDebug() << "[ProcessManager] 开始初始化";
     
-    // 启动心跳检查定时器
-    StartHeartbeatTimer();
-    
-    // 启动进程监控定时器
+    // 启动进程监控定时器（心跳截止时间在进程进入运行状态时设置）
     StartMonitorTimer();
     
     initialized_ = true;
@@ -115,59 +129,76 @@ bool ProcessManager::StartProcess(const QString& process_id,
                                 const QStringList& arguments,
                                 const QString& working_directory)
 {
-    QMutexLocker locker(&process_mutex_);
-    
-    
-    // 检查进程是否已存在
-    if (process_info_map_.contains(process_id)) {
-        ProcessInfo& info = process_info_map_[process_id];
-        if (info.status == kRunning || info.status == kStarting) {
-            qWarning() << "[ProcessManager] 进程" << process_id << "已在运行或启动中";
-            return false;
-        }
+    QProcess* process = nullptr;
+    {
+        QMutexLocker locker(&process_mutex_);
+        process = PrepareLaunch(process_id, executable_path, arguments, working_directory);
     }
-    
-    if(sender_id_to_process_id_.contains(process_id)){
-        qWarning() << "[ProcessManager] 进程" << process_id << "已存在";
+    if (!process) {
         return false;
     }
-    qDebug() << "[ProcessManager] 启动进程:" << process_id << "路径:" << executable_path;
-    
-    // 创建进程信息
-    ProcessInfo info;
-    info.process_id = process_id;
-    info.executable_path = executable_path;
-    info.arguments = arguments;
-    info.working_directory = working_directory.isEmpty() ? QDir::currentPath() : working_directory;
-    info.status = kStarting;
-    info.start_time = QDateTime::currentDateTime();
-    info.last_heartbeat = QDateTime::currentDateTime();
-    info.process = CreateQProcess(process_id);
-    
-    if (!info.process) {
-        qWarning() << "[ProcessManager] 创建QProcess失败:" << process_id;
-        return false;
+
+    // 不持锁启动，结果由started/errorOccurred信号异步报告
+    process->start();
+    return true;
+}
+
+quint64 ProcessManager::StartProcesses(const QStringList& process_ids)
+{
+    QList<QProcess*> launches;
+    quint64 batch_id = 0;
+    StartBatch settled_batch;
+    bool settled = false;
+    {
+        QMutexLocker locker(&process_mutex_);
+        batch_id = next_batch_id_++;
+
+        StartBatch batch;
+        for (const QString& process_id : process_ids) {
+            auto it = process_info_map_.find(process_id);
+            if (it == process_info_map_.end()) {
+                qWarning() << "[ProcessManager] 批量启动: 进程未注册" << process_id;
+                batch.failed.append(process_id);
+                continue;
+            }
+            if (it->status == kRunning) {
+                batch.started.append(process_id);
+                continue;
+            }
+            if (it->status == kStarting) {
+                batch.pending.insert(process_id);
+                continue;
+            }
+
+            // PrepareLaunch会覆盖进程信息，先取出注册的启动参数
+            const ProcessInfo registered = it.value();
+            QProcess* process = PrepareLaunch(process_id, registered.executable_path,
+                                              registered.arguments, registered.working_directory);
+            if (process) {
+                batch.pending.insert(process_id);
+                launches.append(process);
+            } else {
+                batch.failed.append(process_id);
+            }
+        }
+
+        if (batch.pending.isEmpty()) {
+            settled_batch = batch;
+            settled = true;
+        } else {
+            start_batches_.insert(batch_id, batch);
+        }
     }
-    
-    // 设置工作目录
-    info.process->setWorkingDirectory(info.working_directory);
-    
-    // 启动进程
-    info.process->start(executable_path, arguments);
-    
-    if (!info.process->waitForStarted(5000)) {
-        qWarning() << "[ProcessManager] 进程启动超时:" << process_id;
-        info.process->deleteLater();
-        UpdateProcessStatus(process_id, kError);
-        return false;
+
+    qInfo() << "[ProcessManager] 批量启动进程, 批次:" << batch_id << "数量:" << launches.size();
+    for (QProcess* process : launches) {
+        process->start();
     }
-    info.pid = info.process->processId();
-    // 保存进程信息
-    process_info_map_[process_id] = info;
-    
-    qDebug() << "[ProcessManager] 进程启动成功:" << process_id << "PID:" << info.pid << "status:" << info.status;
-    
-    return true;
+
+    if (settled) {
+        emit ProcessBatchStarted(batch_id, settled_batch.started, settled_batch.failed);
+    }
+    return batch_id;
 }
 
 bool ProcessManager::StopProcess(const QString& process_id, bool force_kill, int timeout_ms)
@@ -189,6 +220,10 @@ bool ProcessManager::StopProcess(const QString& process_id, bool force_kill, int
     
     qDebug() << "[ProcessManager] 停止进程:" << process_id << "强制杀死:" << force_kill;
     
+    auto restart = restart_states_.find(process_id);
+    if (restart != restart_states_.end()) {
+        restart->stop_requested = true;
+    }
     UpdateProcessStatus(process_id, kStopping);
     
     if (!info.process) {
@@ -270,58 +305,115 @@ bool ProcessManager::StopAllProcesses(int timeout_ms)
 {
     qDebug() << "[ProcessManager] 停止所有进程";
 
-    QStringList process_list;
-    QList<QProcess*> proc_ptrs;
+    // 不经IPC通知，直接terminate
+    ShutdownPolicy policy;
+    policy.ack_timeout_ms = 0;
+    policy.terminate_timeout_ms = timeout_ms;
+    return BeginShutdown(policy);
+}
 
-    // 1) 收集需要停止的进程，并发送 terminate（短锁）
+bool ProcessManager::BeginShutdown(const ShutdownPolicy& policy)
+{
     {
         QMutexLocker locker(&process_mutex_);
+        if (shutting_down_) {
+            qWarning() << "[ProcessManager] 已有停止流程在进行";
+            return false;
+        }
+        shutting_down_ = true;
+        shutdown_policy_ = policy;
+        shutdown_outcomes_ = QJsonObject();
+        shutdown_clock_.start();
+
+        // 停止流程中不再自动重启，尚未到期的重启一并取消
+        for (auto restart = restart_states_.begin(); restart != restart_states_.end(); ++restart) {
+            if (restart->restart_pending) {
+                restart->restart_pending = false;
+                restart_deadlines_->disarm(restart.key());
+            }
+        }
+
         for (auto it = process_info_map_.begin(); it != process_info_map_.end(); ++it) {
-            if (it->status == kRunning && it->process) {
-                process_list.append(it.key());
+            if (!it->process || it->process->state() == QProcess::NotRunning) {
+                continue;
+            }
+            UpdateProcessStatus(it.key(), kStopping);
+            if (policy.ack_timeout_ms > 0) {
+                stopping_.insert(it.key(), StopPhase::kAwaitingAck);
+                shutdown_deadlines_->arm(it.key(), policy.ack_timeout_ms);
+            } else {
                 it->process->terminate();
-                UpdateProcessStatus(it.key(), kStopping);
-                proc_ptrs.append(it->process);
+                stopping_.insert(it.key(), StopPhase::kTerminating);
+                shutdown_deadlines_->arm(it.key(), policy.terminate_timeout_ms);
             }
         }
+        qInfo() << "[ProcessManager] 开始停止进程:" << stopping_.keys();
     }
 
-    if (process_list.isEmpty()) return true;
-    qDebug() << "[ProcessManager] 停止所有进程列表:" << process_list;
+    // 没有运行中的进程时立即结束
+    FinishShutdownIfDone();
+    return true;
+}
 
-    // 2) 等待优雅退出（不持锁）
-    QElapsedTimer timer;
-    timer.start();
-    while (timer.elapsed() < timeout_ms) {
-        bool all_stopped = true;
-        for (const auto& proc : proc_ptrs) {
-            if (proc && proc->state() != QProcess::NotRunning) {
-                all_stopped = false;
-                break;
-            }
-        }
-        if (all_stopped) {
-            qDebug() << "[ProcessManager] 所有进程已优雅停止";
-            return true;
-        }
-        QCoreApplication::processEvents();
-        QThread::msleep(100);
+void ProcessManager::AcknowledgeShutdown(const QString& process_id)
+{
+    QMutexLocker locker(&process_mutex_);
+    auto it = stopping_.find(process_id);
+    if (it == stopping_.end() || it.value() != StopPhase::kAwaitingAck) {
+        return;
     }
+    qDebug() << "[ProcessManager] 进程已应答关闭通知:" << process_id;
+    it.value() = StopPhase::kAwaitingExit;
+    shutdown_deadlines_->arm(process_id, shutdown_policy_.exit_timeout_ms);
+}
 
-    // 3) 超时后强杀仍在运行的进程（短锁）
-    qWarning() << "[ProcessManager] 优雅停止超时，强制杀死剩余进程";
-    {
-        QMutexLocker locker(&process_mutex_);
-        for (const QString& process_id : process_list) {
-            auto it = process_info_map_.find(process_id);
-            if (it != process_info_map_.end() && it->process) {
-                if (it->process->state() != QProcess::NotRunning) {
-                    it->process->kill();
-                }
-            }
-        }
+bool ProcessManager::IsShuttingDown() const
+{
+    QMutexLocker locker(&process_mutex_);
+    return shutting_down_;
+}
+
+ProcessManager::RestartPolicy ProcessManager::RestartPolicy::fromJson(const QJsonValue& value)
+{
+    RestartPolicy policy;
+    const QJsonObject config = value.isObject() ? value.toObject() : QJsonObject{{"mode", value}};
+
+    const QString mode = config.value("mode").toString("never");
+    if (mode == "on_failure") {
+        policy.mode = Mode::kOnFailure;
+    } else if (mode == "always") {
+        policy.mode = Mode::kAlways;
+    } else if (mode != "never") {
+        qWarning() << "[ProcessManager] 未知的重启模式:" << mode << "按never处理";
+    }
+
+    policy.max_restarts = config.value("max_restarts").toInt(policy.max_restarts);
+    policy.window_ms = config.value("window_ms").toInt(policy.window_ms);
+    policy.initial_backoff_ms = config.value("initial_backoff_ms").toInt(policy.initial_backoff_ms);
+    policy.max_backoff_ms = config.value("max_backoff_ms").toInt(policy.max_backoff_ms);
+    policy.backoff_multiplier = config.value("backoff_multiplier").toDouble(policy.backoff_multiplier);
+    policy.jitter = std::clamp(config.value("jitter").toDouble(policy.jitter), 0.0, 1.0);
+    policy.healthy_uptime_ms = config.value("healthy_uptime_ms").toInt(policy.healthy_uptime_ms);
+    policy.restart_on_heartbeat_timeout =
+        config.value("restart_on_heartbeat_timeout").toBool(policy.restart_on_heartbeat_timeout);
+    return policy;
+}
+
+void ProcessManager::SetRestartPolicy(const QString& process_id, const RestartPolicy& policy)
+{
+    QMutexLocker locker(&process_mutex_);
+    RestartState& state = restart_states_[process_id];
+    state.policy = policy;
+    if (policy.mode == RestartPolicy::Mode::kNever && state.restart_pending) {
+        state.restart_pending = false;
+        restart_deadlines_->disarm(process_id);
     }
-    return true;
+}
+
+int ProcessManager::GetRestartCount(const QString& process_id) const
+{
+    QMutexLocker locker(&process_mutex_);
+    return restart_states_.value(process_id).restart_count;
 }
 
 void ProcessManager::UpdateHeartbeat(const QString& sender_id)
@@ -331,13 +423,28 @@ void ProcessManager::UpdateHeartbeat(const QString& sender_id)
     auto it = process_info_map_.find(sender_id);
     if (it != process_info_map_.end()) {
         it->last_heartbeat = QDateTime::currentDateTime();
+        it->last_heartbeat_ms = heartbeat_deadlines_->nowMs();
+        if (it->status == kRunning) {
+            heartbeat_deadlines_->arm(it.key(), heartbeat_timeout_ms_);
+        }
     }
 }
 
+void ProcessManager::SetLivenessTable(std::shared_ptr<const IpcLivenessTable> table)
+{
+    QMutexLocker locker(&process_mutex_);
+    liveness_table_ = std::move(table);
+}
+
 void ProcessManager::SetHeartbeatTimeout(int timeout_ms)
 {
     QMutexLocker locker(&process_mutex_);
     heartbeat_timeout_ms_ = timeout_ms;
+    for (auto it = process_info_map_.constBegin(); it != process_info_map_.constEnd(); ++it) {
+        if (it->status == kRunning) {
+            ArmHeartbeatDeadline(it.value());
+        }
+    }
     qDebug() << "[ProcessManager] 设置心跳超时时间:" << timeout_ms << "ms";
 }
 
@@ -354,7 +461,9 @@ void ProcessManager::CleanupStoppedProcesses()
     QStringList to_remove;
     for (auto it = process_info_map_.begin(); it != process_info_map_.end(); ++it) {
         if (it->status == kNotRunning && it->process) {
-            if (it->process->state() == QProcess::NotRunning) {
+            // 等待自动重启的进程保留启动参数
+            if (it->process->state() == QProcess::NotRunning
+                && !restart_states_.value(it.key()).restart_pending) {
                 to_remove.append(it.key());
             }
         }
@@ -373,15 +482,31 @@ void ProcessManager::HandleProcessStarted()
         return;
     }
     
-    QString process_id = GetProcessIdByQProcess(process);
-    if (process_id.isEmpty()) {
-        return;
+    QString process_id;
+    QList<std::tuple<quint64, QStringList, QStringList>> finished_batches;
+    {
+        QMutexLocker locker(&process_mutex_);
+        process_id = GetProcessIdByQProcess(process);
+        if (process_id.isEmpty()) {
+            return;
+        }
+
+        process_info_map_[process_id].pid = process->processId();
+        qDebug() << "[ProcessManager] 进程启动成功:" << process_id << "PID:" << process->processId();
+
+        auto restart = restart_states_.find(process_id);
+        if (restart != restart_states_.end()) {
+            restart->running_since_ms = restart_deadlines_->nowMs();
+        }
+
+        UpdateProcessStatus(process_id, kRunning);
+        SettleStart(process_id, true, &finished_batches);
     }
-    
-    qDebug() << "[ProcessManager] 进程启动成功:" << process_id << "PID:" << process->processId();
-    
-    UpdateProcessStatus(process_id, kRunning);
+
     emit ProcessStarted(process_id);
+    for (const auto& [batch_id, started, failed] : finished_batches) {
+        emit ProcessBatchStarted(batch_id, started, failed);
+    }
 }
 
 void ProcessManager::HandleProcessFinished(int exit_code, QProcess::ExitStatus exit_status)
@@ -399,14 +524,33 @@ void ProcessManager::HandleProcessFinished(int exit_code, QProcess::ExitStatus e
     qDebug() << "[ProcessManager] 进程结束:" << process_id << "退出码:" << exit_code 
              << "退出状态:" << (exit_status == QProcess::NormalExit ? "正常" : "崩溃");
     
-    QMutexLocker locker(&process_mutex_);
-    auto it = process_info_map_.find(process_id);
-    if (it == process_info_map_.end()) {
-        return;
+    QList<std::tuple<quint64, QStringList, QStringList>> finished_batches;
+    int abandoned_restarts = -1;
+    {
+        QMutexLocker locker(&process_mutex_);
+        auto it = process_info_map_.find(process_id);
+        if (it == process_info_map_.end()) {
+            return;
+        }
+        UpdateProcessStatus(process_id, kNotRunning);
+        SettleStart(process_id, false, &finished_batches);
+        SettleStop(process_id);
+
+        const bool failed = exit_status == QProcess::CrashExit || exit_code != 0;
+        abandoned_restarts = ScheduleRestart(process_id, failed,
+                                             exit_status == QProcess::CrashExit
+                                                 ? QString("崩溃")
+                                                 : QString("退出码 %1").arg(exit_code));
     }
-    UpdateProcessStatus(process_id, kNotRunning);
     
     emit ProcessStopped(process_id, exit_code);
+    for (const auto& [batch_id, started, failed] : finished_batches) {
+        emit ProcessBatchStarted(batch_id, started, failed);
+    }
+    if (abandoned_restarts >= 0) {
+        emit ProcessRestartAbandoned(process_id, abandoned_restarts);
+    }
+    FinishShutdownIfDone();
 }
 
 void ProcessManager::HandleProcessError(QProcess::ProcessError error)
@@ -416,7 +560,11 @@ void ProcessManager::HandleProcessError(QProcess::ProcessError error)
         return;
     }
     
-    QString process_id = GetProcessIdByQProcess(process);
+    QString process_id;
+    {
+        QMutexLocker locker(&process_mutex_);
+        process_id = GetProcessIdByQProcess(process);
+    }
     if (process_id.isEmpty()) {
         return;
     }
@@ -446,9 +594,33 @@ void ProcessManager::HandleProcessError(QProcess::ProcessError error)
     
     qWarning() << "[ProcessManager] 进程错误:" << process_id << error_string;
     
-    UpdateProcessStatus(process_id, kError);
+    QList<std::tuple<quint64, QStringList, QStringList>> finished_batches;
+    int abandoned_restarts = -1;
+    {
+        QMutexLocker locker(&process_mutex_);
+        const bool was_starting = process_info_map_.value(process_id).status == kStarting;
+        UpdateProcessStatus(process_id, kError);
+        if (was_starting) {
+            SettleStart(process_id, false, &finished_batches);
+        }
+        // 启动失败不会再发出finished
+        if (process->state() == QProcess::NotRunning) {
+            SettleStop(process_id);
+        }
+        // 崩溃随后还会发出finished，由那里安排重启
+        if (error == QProcess::FailedToStart) {
+            abandoned_restarts = ScheduleRestart(process_id, true, error_string);
+        }
+    }
+
     emit ProcessCrashed(process_id, error_string);
-    
+    for (const auto& [batch_id, started, failed] : finished_batches) {
+        emit ProcessBatchStarted(batch_id, started, failed);
+    }
+    if (abandoned_restarts >= 0) {
+        emit ProcessRestartAbandoned(process_id, abandoned_restarts);
+    }
+    FinishShutdownIfDone();
 }
 
 void ProcessManager::HandleProcessStandardOutput()
@@ -491,29 +663,121 @@ void ProcessManager::HandleProcessStandardError()
     }
 }
 
-void ProcessManager::CheckHeartbeat()
+void ProcessManager::HandleHeartbeatDeadline(const QString& process_id)
 {
-    QMutexLocker locker(&process_mutex_);
-    
-    QDateTime current_time = QDateTime::currentDateTime();
-    QStringList timeout_processes;
-    
-    for (auto it = process_info_map_.begin(); it != process_info_map_.end(); ++it) {
-        if (it->status == kRunning) {
-            qint64 elapsed_ms = it->last_heartbeat.msecsTo(current_time);
-            // qDebug() << "elapsed_ms:" << elapsed_ms;
-            // qDebug() << "heartbeat_timeout_ms_:" << heartbeat_timeout_ms_;
-            if (elapsed_ms > heartbeat_timeout_ms_) {
-                timeout_processes.append(it.key());
-            }
+    {
+        QMutexLocker locker(&process_mutex_);
+
+        auto it = process_info_map_.find(process_id);
+        if (it == process_info_map_.end() || it->status != kRunning) {
+            return;
+        }
+
+        // 传输层直接应答的心跳不经过UpdateHeartbeat，到期时才读取活跃度表并改期
+        if (HeartbeatIdleMs(it.value()) < heartbeat_timeout_ms_) {
+            ArmHeartbeatDeadline(it.value());
+            return;
+        }
+
+        // 仍未恢复时每个超时周期报告一次
+        heartbeat_deadlines_->arm(process_id, heartbeat_timeout_ms_);
+
+        // 配置了重启策略时杀死无响应的进程，退出后按策略重启
+        auto restart = restart_states_.constFind(process_id);
+        if (restart != restart_states_.constEnd()
+            && restart->policy.mode != RestartPolicy::Mode::kNever
+            && restart->policy.restart_on_heartbeat_timeout
+            && it->process) {
+            qWarning() << "[ProcessManager] 进程心跳超时，杀死后按策略重启:" << process_id;
+            it->process->kill();
         }
     }
-    
-    // 处理心跳超时的进程
-    for (const QString& process_id : timeout_processes) {
-        qWarning() << "[ProcessManager] 进程心跳超时:" << process_id;
-        emit HeartbeatTimeout(process_id);
+
+    qWarning() << "[ProcessManager] 进程心跳超时:" << process_id;
+    emit HeartbeatTimeout(process_id);
+}
+
+void ProcessManager::HandleRestartDeadline(const QString& process_id)
+{
+    QProcess* process = nullptr;
+    int restart_count = 0;
+    int abandoned_restarts = -1;
+    {
+        QMutexLocker locker(&process_mutex_);
+        auto restart = restart_states_.find(process_id);
+        if (restart == restart_states_.end() || !restart->restart_pending) {
+            return;
+        }
+        restart->restart_pending = false;
+
+        auto it = process_info_map_.find(process_id);
+        if (it == process_info_map_.end() || shutting_down_
+            || it->status == kRunning || it->status == kStarting) {
+            return;
+        }
+
+        // PrepareLaunch会覆盖进程信息，先取出上一次的启动参数
+        const ProcessInfo previous = it.value();
+        process = PrepareLaunch(process_id, previous.executable_path,
+                                previous.arguments, previous.working_directory);
+        if (!process) {
+            // 按启动失败重新退避，反复失败时最终放弃并发出ProcessRestartAbandoned
+            abandoned_restarts = ScheduleRestart(process_id, true, "启动失败");
+        } else {
+            restart_count = ++restart->restart_count;
+        }
     }
+
+    if (!process) {
+        if (abandoned_restarts >= 0) {
+            emit ProcessRestartAbandoned(process_id, abandoned_restarts);
+        }
+        return;
+    }
+
+    qInfo() << "[ProcessManager] 自动重启进程:" << process_id << "累计重启次数:" << restart_count;
+    process->start();
+    emit ProcessAutoRestarted(process_id, restart_count);
+}
+
+void ProcessManager::HandleShutdownDeadline(const QString& process_id)
+{
+    {
+        QMutexLocker locker(&process_mutex_);
+        auto it = stopping_.find(process_id);
+        if (it == stopping_.end()) {
+            return;
+        }
+        QProcess* process = process_info_map_.value(process_id).process;
+        if (!process) {
+            SettleStop(process_id);
+        } else {
+            switch (it.value()) {
+                case StopPhase::kAwaitingAck:
+                case StopPhase::kAwaitingExit:
+                    qWarning() << "[ProcessManager] 进程未在期限内退出，发送terminate:" << process_id
+                               << (it.value() == StopPhase::kAwaitingAck ? "（未应答关闭通知）" : "");
+                    process->terminate();
+                    it.value() = StopPhase::kTerminating;
+                    shutdown_deadlines_->arm(process_id, shutdown_policy_.terminate_timeout_ms);
+                    return;
+                case StopPhase::kTerminating:
+                    qWarning() << "[ProcessManager] 进程terminate后未退出，强制杀死:" << process_id;
+                    process->kill();
+                    it.value() = StopPhase::kKilling;
+                    shutdown_deadlines_->arm(process_id, shutdown_policy_.kill_timeout_ms);
+                    return;
+                case StopPhase::kKilling:
+                    qWarning() << "[ProcessManager] 进程强制杀死超时，放弃等待:" << process_id;
+                    shutdown_outcomes_[process_id] = QJsonObject{
+                        {"outcome", "abandoned"},
+                        {"elapsed_ms", shutdown_clock_.elapsed()}};
+                    stopping_.erase(it);
+                    break;
+            }
+        }
+    }
+    FinishShutdownIfDone();
 }
 
 void ProcessManager::MonitorProcesses()
@@ -528,7 +792,9 @@ void ProcessManager::MonitorProcesses()
             // 根据QProcess状态更新进程状态
             switch (state) {
                 case QProcess::NotRunning:
-                    if (current_status != kNotRunning && current_status != kStopping) {
+                    // kCrashed/kError由退出处理设置（含放弃自动重启），保留供界面展示
+                    if (current_status != kNotRunning && current_status != kStopping &&
+                        current_status != kCrashed && current_status != kError) {
                         qDebug() << "[ProcessManager] 检测到进程意外停止:" << it.key();
                         UpdateProcessStatus(it.key(), kNotRunning);
                     }
@@ -550,12 +816,7 @@ void ProcessManager::MonitorProcesses()
 
 QString ProcessManager::GetProcessIdByQProcess(QProcess* process) const
 {
-    for (auto it = process_info_map_.constBegin(); it != process_info_map_.constEnd(); ++it) {
-        if (it->process == process) {
-            return it.key();
-        }
-    }
-    return QString();
+    return qprocess_to_process_id_.value(process);
 }
 
 QProcess* ProcessManager::CreateQProcess(const QString& process_id)
@@ -575,15 +836,211 @@ QProcess* ProcessManager::CreateQProcess(const QString& process_id)
     return process;
 }
 
-void ProcessManager::StartHeartbeatTimer()
+QProcess* ProcessManager::PrepareLaunch(const QString& process_id,
+                                        const QString& executable_path,
+                                        const QStringList& arguments,
+                                        const QString& working_directory)
 {
-    if (!heartbeat_timer_) {
-        heartbeat_timer_ = new QTimer(this);
-        connect(heartbeat_timer_, &QTimer::timeout, this, &ProcessManager::CheckHeartbeat);
+    auto existing = process_info_map_.find(process_id);
+    if (existing != process_info_map_.end()
+        && (existing->status == kRunning || existing->status == kStarting)) {
+        qWarning() << "[ProcessManager] 进程" << process_id << "已在运行或启动中";
+        return nullptr;
+    }
+
+    if (shutting_down_) {
+        qWarning() << "[ProcessManager] 正在停止所有进程，拒绝启动:" << process_id;
+        return nullptr;
+    }
+    
+    if(sender_id_to_process_id_.contains(process_id)){
+        qWarning() << "[ProcessManager] 进程" << process_id << "已存在";
+        return nullptr;
+    }
+    qDebug() << "[ProcessManager] 启动进程:" << process_id << "路径:" << executable_path;
+    
+    // 创建进程信息
+    ProcessInfo info;
+    info.process_id = process_id;
+    info.executable_path = executable_path;
+    info.arguments = arguments;
+    info.working_directory = working_directory.isEmpty() ? QDir::currentPath() : working_directory;
+    info.status = existing != process_info_map_.end() ? existing->status : kNotRunning;
+    info.start_time = QDateTime::currentDateTime();
+    info.last_heartbeat = QDateTime::currentDateTime();
+    info.pid = 0;
+    info.process = CreateQProcess(process_id);
+    
+    if (!info.process) {
+        qWarning() << "[ProcessManager] 创建QProcess失败:" << process_id;
+        return nullptr;
+    }
+    
+    info.process->setWorkingDirectory(info.working_directory);
+    info.process->setProgram(executable_path);
+    info.process->setArguments(arguments);
+    
+    // 上一次运行的QProcess已经结束，替换后它的迟到信号不再能反查到进程ID
+    if (existing != process_info_map_.end()) {
+        if (existing->process) {
+            qprocess_to_process_id_.remove(existing->process);
+            existing->process->deleteLater();
+        }
+        existing.value() = info;
+    } else {
+        process_info_map_.insert(process_id, info);
+    }
+    qprocess_to_process_id_.insert(info.process, process_id);
+
+    // 手动启动取代尚未到期的自动重启
+    auto restart = restart_states_.find(process_id);
+    if (restart != restart_states_.end()) {
+        restart->stop_requested = false;
+        restart->restart_pending = false;
+        restart->running_since_ms = -1;
+        restart_deadlines_->disarm(process_id);
+        // 放弃重启后手动启动，重新开始统计崩溃循环
+        if (info.status == kCrashed) {
+            restart->recent_restarts_ms.clear();
+        }
     }
+    UpdateProcessStatus(process_id, kStarting);
     
-    heartbeat_timer_->start(heartbeat_check_interval_ms_);
-    qDebug() << "[ProcessManager] 启动心跳检查定时器，间隔:" << heartbeat_check_interval_ms_ << "ms";
+    return info.process;
+}
+
+void ProcessManager::SettleStop(const QString& process_id)
+{
+    auto it = stopping_.find(process_id);
+    if (it == stopping_.end()) {
+        return;
+    }
+
+    // 按退出时所处的阶段记录结束方式
+    QString outcome;
+    switch (it.value()) {
+        case StopPhase::kAwaitingAck:  outcome = "exited"; break;
+        case StopPhase::kAwaitingExit: outcome = "acknowledged"; break;
+        case StopPhase::kTerminating:  outcome = "terminated"; break;
+        case StopPhase::kKilling:      outcome = "killed"; break;
+    }
+    shutdown_outcomes_[process_id] = QJsonObject{
+        {"outcome", outcome},
+        {"elapsed_ms", shutdown_clock_.elapsed()}};
+    shutdown_deadlines_->disarm(process_id);
+    stopping_.erase(it);
+}
+
+int ProcessManager::ScheduleRestart(const QString& process_id, bool failed, const QString& reason)
+{
+    auto it = restart_states_.find(process_id);
+    if (it == restart_states_.end() || it->restart_pending) {
+        return -1;
+    }
+    RestartState& state = *it;
+    const qint64 running_since_ms = state.running_since_ms;
+    state.running_since_ms = -1;
+
+    const RestartPolicy& policy = state.policy;
+    if (policy.mode == RestartPolicy::Mode::kNever
+        || (policy.mode == RestartPolicy::Mode::kOnFailure && !failed)
+        || state.stop_requested || shutting_down_) {
+        return -1;
+    }
+
+    // 健康运行一段时间后退出视为偶发故障，退避清零
+    const qint64 now_ms = restart_deadlines_->nowMs();
+    if (running_since_ms >= 0 && now_ms - running_since_ms >= policy.healthy_uptime_ms) {
+        state.recent_restarts_ms.clear();
+    }
+    while (!state.recent_restarts_ms.isEmpty() && now_ms - state.recent_restarts_ms.first() >= policy.window_ms) {
+        state.recent_restarts_ms.removeFirst();
+    }
+
+    const int attempt = static_cast<int>(state.recent_restarts_ms.size());
+    if (attempt >= policy.max_restarts) {
+        qCritical() << "[ProcessManager] 进程陷入崩溃循环，放弃自动重启:" << process_id
+                    << policy.window_ms << "ms内已重启" << attempt << "次, 原因:" << reason;
+        UpdateProcessStatus(process_id, kCrashed);
+        return attempt;
+    }
+
+    const qint64 delay_ms = RestartBackoffMs(policy, attempt);
+    state.recent_restarts_ms.append(now_ms + delay_ms);
+    state.restart_pending = true;
+    qWarning() << "[ProcessManager] 进程意外退出:" << process_id << "原因:" << reason
+               << "将在" << delay_ms << "ms后重启";
+
+    if (delay_ms == 0) {
+        QMetaObject::invokeMethod(this, [this, process_id]() { HandleRestartDeadline(process_id); },
+                                  Qt::QueuedConnection);
+    } else {
+        restart_deadlines_->arm(process_id, delay_ms);
+    }
+    return -1;
+}
+
+qint64 ProcessManager::RestartBackoffMs(const RestartPolicy& policy, int attempt)
+{
+    // 窗口内第一次重启立即进行，之后按倍数增长
+    if (attempt <= 0) {
+        return 0;
+    }
+    const double base_ms = std::min<double>(
+        policy.max_backoff_ms, policy.initial_backoff_ms * std::pow(policy.backoff_multiplier, attempt - 1));
+    const double spread = policy.jitter * (QRandomGenerator::global()->generateDouble() * 2.0 - 1.0);
+    return std::max<qint64>(0, std::llround(base_ms * (1.0 + spread)));
+}
+
+void ProcessManager::FinishShutdownIfDone()
+{
+    QJsonObject summary;
+    {
+        QMutexLocker locker(&process_mutex_);
+        if (!shutting_down_ || !stopping_.isEmpty()) {
+            return;
+        }
+        shutting_down_ = false;
+        summary["elapsed_ms"] = shutdown_clock_.elapsed();
+        summary["processes"] = shutdown_outcomes_;
+    }
+
+    qInfo() << "[ProcessManager] 所有进程已停止, 耗时:" << summary.value("elapsed_ms").toInteger() << "ms";
+    emit ShutdownFinished(summary);
+}
+
+void ProcessManager::SettleStart(const QString& process_id, bool success,
+                                 QList<std::tuple<quint64, QStringList, QStringList>>* finished)
+{
+    for (auto it = start_batches_.begin(); it != start_batches_.end();) {
+        if (it->pending.remove(process_id)) {
+            (success ? it->started : it->failed).append(process_id);
+            if (it->pending.isEmpty()) {
+                finished->append(std::make_tuple(it.key(), it->started, it->failed));
+                it = start_batches_.erase(it);
+                continue;
+            }
+        }
+        ++it;
+    }
+}
+
+void ProcessManager::ArmHeartbeatDeadline(const ProcessInfo& info)
+{
+    const qint64 remaining_ms = heartbeat_timeout_ms_ - HeartbeatIdleMs(info);
+    heartbeat_deadlines_->arm(info.process_id, std::max<qint64>(0, remaining_ms));
+}
+
+qint64 ProcessManager::HeartbeatIdleMs(const ProcessInfo& info) const
+{
+    qint64 idle_ms = heartbeat_deadlines_->nowMs() - info.last_heartbeat_ms;
+    if (liveness_table_) {
+        const qint64 table_idle_ms = liveness_table_->idleMs(info.process_id);
+        if (table_idle_ms >= 0) {
+            idle_ms = std::min(idle_ms, table_idle_ms);
+        }
+    }
+    return idle_ms;
 }
 
 void ProcessManager::StartMonitorTimer()
@@ -604,6 +1061,15 @@ void ProcessManager::UpdateProcessStatus(const QString& process_id, ProcessStatu
         ProcessStatus old_status = it->status;
         if (old_status != new_status) {
             it->status = new_status;
+
+            // 只有运行中的进程参与心跳检测，进入运行状态时重新开始计时
+            if (new_status == kRunning) {
+                it->last_heartbeat = QDateTime::currentDateTime();
+                it->last_heartbeat_ms = heartbeat_deadlines_->nowMs();
+                heartbeat_deadlines_->arm(process_id, heartbeat_timeout_ms_);
+            } else if (old_status == kRunning) {
+                heartbeat_deadlines_->disarm(process_id);
+            }
             
             qDebug() << "[ProcessManager] 进程状态变化:" << process_id 
                      << "从" << old_status << "到" << new_status;
@@ -618,8 +1084,15 @@ void ProcessManager::CleanupProcessInfo(const QString& process_id)
     auto it = process_info_map_.find(process_id);
     if (it != process_info_map_.end()) {
         if (it->process) {
+            qprocess_to_process_id_.remove(it->process);
             it->process->deleteLater();
         }
+        heartbeat_deadlines_->disarm(process_id);
+        restart_deadlines_->disarm(process_id);
+        auto restart = restart_states_.find(process_id);
+        if (restart != restart_states_.end()) {
+            restart->restart_pending = false;
+        }
         process_info_map_.erase(it);
         qDebug() << "[ProcessManager] 清理进程信息:" << process_id;
     }
@@ -9,8 +9,16 @@
 #include <QMutex>
 #include <QMutexLocker>
 #include <QHash>
+#include <QSet>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QJsonValue>
 #include <memory>
+#include <tuple>
+
+class DeadlineWheel;
+class IpcLivenessTable;
 
 /**
  * @brief ProcessManager 进程生命周期管理类
@@ -21,6 +29,9 @@
  * 主要功能：
  * - 子进程启动、停止管理
  * - 进程状态监控和心跳检测
+ *
+ * 心跳检测不再周期扫描：每个运行中的进程在分层时间轮中有一个截止时间，
+ * 收到心跳时改期，到期时再结合传输层活跃度表确认是否真正超时。
  */
 class ProcessManager : public QObject
 {
@@ -49,11 +60,56 @@ public:
         QString working_directory;      ///< 工作目录
         ProcessStatus status;           ///< 进程状态
         QDateTime start_time;           ///< 启动时间
-        QDateTime last_heartbeat;       ///< 最后心跳时间
+        QDateTime last_heartbeat;       ///< 最后心跳时间（仅用于显示）
+        qint64 last_heartbeat_ms = 0;   ///< 最后心跳时间（单调时钟，毫秒），用于超时判断
         QProcess* process;              ///< QProcess对象指针
         int pid;                         ///< 进程ID
     };
 
+    /**
+     * @brief 关闭子进程时各阶段的等待时间
+     *
+     * 每个进程独立推进：等待kShutdown应答 -> 等待自行退出 -> terminate -> kill，
+     * 任一阶段进程退出即结束该进程的流程。
+     */
+    struct ShutdownPolicy {
+        int ack_timeout_ms = 2000;          ///< 等待kShutdown应答的时间，0表示不等待应答直接terminate
+        int exit_timeout_ms = 5000;         ///< 应答后等待进程自行退出的时间
+        int terminate_timeout_ms = 3000;    ///< terminate后等待退出的时间，超时kill
+        int kill_timeout_ms = 2000;         ///< kill后等待退出的时间，超时放弃等待
+    };
+
+    /**
+     * @brief 进程意外退出后的自动重启策略
+     *
+     * 健康运行超过healthy_uptime_ms后退出视为偶发故障，立即重启；短时间内反复
+     * 退出时按指数退避（带随机抖动）延迟重启，window_ms内重启达到max_restarts次
+     * 即判定为崩溃循环，不再重启。主动停止（StopProcess、停止流程）不会触发重启。
+     */
+    struct RestartPolicy {
+        enum class Mode {
+            kNever = 0,     ///< 不自动重启
+            kOnFailure,     ///< 崩溃、非零退出码、启动失败或心跳超时时重启
+            kAlways         ///< 任何意外退出都重启，包括正常退出
+        };
+
+        Mode mode = Mode::kNever;
+        int max_restarts = 5;               ///< window_ms内最多重启次数
+        int window_ms = 60000;              ///< 统计重启次数的时间窗口
+        int initial_backoff_ms = 1000;      ///< 第二次连续重启的延迟，第一次立即重启
+        int max_backoff_ms = 30000;         ///< 退避延迟上限
+        double backoff_multiplier = 2.0;    ///< 每次连续重启延迟的倍数
+        double jitter = 0.2;                ///< 延迟的随机浮动比例（±）
+        int healthy_uptime_ms = 30000;      ///< 运行超过该时长视为健康，退避清零
+        bool restart_on_heartbeat_timeout = true;  ///< 心跳超时时杀死进程并按策略重启
+
+        /**
+         * @brief 从processes配置项的restart字段读取
+         * @param value 模式字符串（"never" / "on_failure" / "always"）或含mode及上述同名字段的对象
+         */
+        static RestartPolicy fromJson(const QJsonValue& value);
+    };
+
 public: 
     static ProcessManager& GetInstance();
 
@@ -68,11 +124,28 @@ public:
                     const QStringList& arguments = QStringList(),
                     const QString& working_directory = QString());
 
+    /**
+     * @brief 启动进程（非阻塞）
+     *
+     * 只发起启动，不等待进程就绪：进程先处于kStarting，收到QProcess::started后
+     * 进入kRunning并发出ProcessStarted，启动失败时进入kError并发出ProcessCrashed。
+     * @return 启动请求是否已发出（进程已在运行或启动中时返回false）
+     */
     bool StartProcess(const QString& process_id, 
                      const QString& executable_path,
                      const QStringList& arguments = QStringList(),
                      const QString& working_directory = QString());
 
+    /**
+     * @brief 并发启动一组已注册（AddProcess）的进程
+     *
+     * 所有进程同时发起启动，全部有结果后发出ProcessBatchStarted，
+     * 总耗时取决于最慢的进程。已在运行的进程直接计入成功。
+     * @param process_ids 进程ID列表
+     * @return 批次ID，与ProcessBatchStarted中的batch_id对应
+     */
+    quint64 StartProcesses(const QStringList& process_ids);
+
 
     bool StopProcess(const QString& process_id, bool force_kill = false, int timeout_ms = 5000);
 
@@ -103,18 +176,63 @@ public:
     QStringList GetRunningProcessList() const;
 
     /**
-     * @brief 停止所有进程
-     * @param timeout_ms 超时时间（毫秒）
-     * @return 停止是否成功
+     * @brief 停止所有进程（非阻塞）
+     *
+     * 不经IPC通知，直接terminate，超时后kill；完成后发出ShutdownFinished。
+     * @param timeout_ms terminate后等待退出的时间（毫秒）
+     * @return 是否已开始停止（已有停止流程在进行时返回false）
      */
     bool StopAllProcesses(int timeout_ms = 10000);
 
+    /**
+     * @brief 开始异步关闭所有运行中的进程
+     *
+     * 调用方负责在调用前向插件发送kShutdown；插件的应答通过AcknowledgeShutdown
+     * 转交进来。各进程按policy独立升级，最后一个进程退出时发出ShutdownFinished。
+     * @param policy 各阶段等待时间
+     * @return 是否已开始关闭（已有停止流程在进行时返回false）
+     */
+    bool BeginShutdown(const ShutdownPolicy& policy);
+
+    /**
+     * @brief 插件已应答kShutdown，改为等待其自行退出
+     * @param process_id 进程标识符
+     */
+    void AcknowledgeShutdown(const QString& process_id);
+
+    /**
+     * @brief 是否有停止流程在进行
+     */
+    bool IsShuttingDown() const;
+
+    /**
+     * @brief 设置进程的自动重启策略，已有的重启计数保留
+     * @param process_id 进程标识符
+     * @param policy 重启策略
+     */
+    void SetRestartPolicy(const QString& process_id, const RestartPolicy& policy);
+
+    /**
+     * @brief 获取进程累计自动重启次数
+     * @param process_id 进程标识符
+     */
+    int GetRestartCount(const QString& process_id) const;
+
     /**
      * @brief 更新进程心跳
      * @param process_id 进程标识符
      */
     void UpdateHeartbeat(const QString& sender_id);
 
+    /**
+     * @brief 设置IPC传输层维护的插件活跃度表
+     *
+     * 心跳检查取 last_heartbeat 与表中最近活跃时间的较近者，
+     * 传输层直接应答的心跳与业务流量都能让进程保持存活。
+     * @param table 活跃度表，以进程ID（插件逻辑ID）为键
+     */
+    void SetLivenessTable(std::shared_ptr<const IpcLivenessTable> table);
+
     /**
      * @brief 设置心跳超时时间
      * @param timeout_ms 超时时间（毫秒）
@@ -147,6 +265,14 @@ signals:
      */
     void ProcessStarted(const QString& process_id);
 
+    /**
+     * @brief 一批进程全部启动完成（成功或失败）
+     * @param batch_id StartProcesses返回的批次ID
+     * @param started 启动成功的进程ID
+     * @param failed 启动失败的进程ID
+     */
+    void ProcessBatchStarted(quint64 batch_id, const QStringList& started, const QStringList& failed);
+
     /**
      * @brief 进程停止信号
      * @param process_id 进程标识符
@@ -168,6 +294,13 @@ signals:
      */
     void ProcessAutoRestarted(const QString& process_id, int restart_count);
 
+    /**
+     * @brief 进程陷入崩溃循环，放弃自动重启，进程状态置为kCrashed
+     * @param process_id 进程标识符
+     * @param restarts_in_window 时间窗口内已重启的次数
+     */
+    void ProcessRestartAbandoned(const QString& process_id, int restarts_in_window);
+
     /**
      * @brief 心跳超时信号
      * @param process_id 进程标识符
@@ -188,6 +321,12 @@ signals:
      */
     void ProcessErrorOutput(const QString& process_id, const QString& error_output);
 
+    /**
+     * @brief 停止流程结束，所有进程均已退出（或已放弃等待）
+     * @param summary 总耗时及每个进程的结束方式（exited / acknowledged / terminated / killed / abandoned）
+     */
+    void ShutdownFinished(const QJsonObject& summary);
+
 private slots:
     /**
      * @brief 处理进程启动
@@ -218,9 +357,25 @@ private slots:
     void HandleProcessStandardError();
 
     /**
-     * @brief 心跳检查定时器槽函数
+     * @brief 心跳截止时间到达
+     *
+     * 截止时间之后若有新的活动（传输层活跃度表）则按最近活动时间改期，
+     * 否则发出HeartbeatTimeout并以完整超时时间重新计时。
+     * @param process_id 进程标识符
+     */
+    void HandleHeartbeatDeadline(const QString& process_id);
+
+    /**
+     * @brief 进程当前停止阶段的期限到达，升级到下一阶段
+     * @param process_id 进程标识符
      */
-    void CheckHeartbeat();
+    void HandleShutdownDeadline(const QString& process_id);
+
+    /**
+     * @brief 退避延迟到达，重新启动进程
+     * @param process_id 进程标识符
+     */
+    void HandleRestartDeadline(const QString& process_id);
 
     /**
      * @brief 进程监控定时器槽函数
@@ -256,9 +411,63 @@ private:
     QProcess* CreateQProcess(const QString& process_id);
 
     /**
-     * @brief 启动心跳检查定时器
+     * @brief 准备启动进程：创建QProcess并登记为kStarting，调用方需持有process_mutex_
+     *
+     * 不调用QProcess::start()：启动失败的信号可能在start()内同步发出，
+     * 调用方须在释放锁之后再启动返回的QProcess。
+     * @return 待启动的QProcess，无法启动时返回nullptr
+     */
+    QProcess* PrepareLaunch(const QString& process_id,
+                            const QString& executable_path,
+                            const QStringList& arguments,
+                            const QString& working_directory);
+
+    /**
+     * @brief 记录进程的启动结果，取出因此全部完成的批次，调用方需持有process_mutex_
+     * @param process_id 进程标识符
+     * @param success 是否启动成功
+     * @param finished 输出全部完成的批次（批次ID，成功列表，失败列表）
+     */
+    void SettleStart(const QString& process_id, bool success,
+                     QList<std::tuple<quint64, QStringList, QStringList>>* finished);
+
+    /**
+     * @brief 按最近活动时间设置进程的心跳截止时间，调用方需持有process_mutex_
+     * @param info 进程信息
      */
-    void StartHeartbeatTimer();
+    void ArmHeartbeatDeadline(const ProcessInfo& info);
+
+    /**
+     * @brief 进程距最近一次活动的毫秒数（单调时钟），取心跳与传输层活跃度表的较近者
+     * @param info 进程信息
+     * @return 空闲时间（毫秒）
+     */
+    qint64 HeartbeatIdleMs(const ProcessInfo& info) const;
+
+    /**
+     * @brief 进程已退出，结束它的停止流程，调用方需持有process_mutex_
+     * @param process_id 进程标识符
+     */
+    void SettleStop(const QString& process_id);
+
+    /**
+     * @brief 所有进程都已结束时发出ShutdownFinished
+     */
+    void FinishShutdownIfDone();
+
+    /**
+     * @brief 进程退出后按重启策略安排重启，调用方需持有process_mutex_
+     * @param process_id 进程标识符
+     * @param failed 是否为异常退出
+     * @param reason 退出原因，用于日志
+     * @return 放弃重启时返回窗口内的重启次数，否则返回-1
+     */
+    int ScheduleRestart(const QString& process_id, bool failed, const QString& reason);
+
+    /**
+     * @brief 第 attempt 次连续重启的退避延迟（含抖动）
+     */
+    static qint64 RestartBackoffMs(const RestartPolicy& policy, int attempt);
 
     /**
      * @brief 启动进程监控定时器
@@ -286,12 +495,54 @@ private:
     mutable QMutex process_mutex_;                        ///< 进程信息访问互斥锁
     QHash<QString, ProcessInfo> process_info_map_;        ///< config文件中进程ID与ProcessInfo的映射表
     QHash<QString, QString> sender_id_to_process_id_;     ///< 发送者ID与进程ID的映射表
+    QHash<QProcess*, QString> qprocess_to_process_id_;    ///< QProcess对象与进程ID的映射表，供信号槽反查
+
+    /**
+     * @brief 一次StartProcesses的进度
+     */
+    struct StartBatch {
+        QSet<QString> pending;          ///< 尚无结果的进程
+        QStringList started;            ///< 启动成功的进程
+        QStringList failed;             ///< 启动失败的进程
+    };
+    QHash<quint64, StartBatch> start_batches_;            ///< 进行中的启动批次
+    quint64 next_batch_id_;                               ///< 下一个批次ID
 
-    QTimer* heartbeat_timer_;                             ///< 心跳检查定时器
+    std::shared_ptr<const IpcLivenessTable> liveness_table_; ///< IPC传输层记录的插件活跃时间
+    DeadlineWheel* heartbeat_deadlines_;                  ///< 各运行中进程的心跳截止时间
+
+    /**
+     * @brief 停止流程中单个进程所处的阶段
+     */
+    enum class StopPhase {
+        kAwaitingAck = 0,   ///< 已发送kShutdown，等待应答
+        kAwaitingExit,      ///< 已应答，等待自行退出
+        kTerminating,       ///< 已terminate
+        kKilling            ///< 已kill
+    };
+    QHash<QString, StopPhase> stopping_;                  ///< 停止流程中尚未退出的进程
+    DeadlineWheel* shutdown_deadlines_;                   ///< 各进程当前停止阶段的期限
+    ShutdownPolicy shutdown_policy_;                      ///< 当前停止流程的等待时间
+    QJsonObject shutdown_outcomes_;                       ///< 已结束进程的结束方式
+    QElapsedTimer shutdown_clock_;                        ///< 停止流程开始计时
+    bool shutting_down_;                                  ///< 是否有停止流程在进行
+
+    /**
+     * @brief 单个进程的自动重启状态
+     */
+    struct RestartState {
+        RestartPolicy policy;
+        QList<qint64> recent_restarts_ms;   ///< 时间窗口内的重启时间（restart_deadlines_时钟）
+        int restart_count = 0;              ///< 累计自动重启次数
+        qint64 running_since_ms = -1;       ///< 本次进入运行状态的时间，未运行时为-1
+        bool stop_requested = false;        ///< 已主动停止，退出时不重启
+        bool restart_pending = false;       ///< 已安排重启，等待退避延迟
+    };
+    QHash<QString, RestartState> restart_states_;         ///< 配置了重启策略的进程
+    DeadlineWheel* restart_deadlines_;                    ///< 各进程的重启退避期限
     QTimer* monitor_timer_;                               ///< 进程监控定时器
 
     int heartbeat_timeout_ms_;                            ///< 心跳超时时间（毫秒）
-    int heartbeat_check_interval_ms_;                     ///< 心跳检查间隔（毫秒）
     int monitor_check_interval_ms_;                       ///< 监控检查间隔（毫秒）
 
     bool initialized_;                                    ///< 是否已初始化
@@ -0,0 +1,386 @@
+#include "ProcessStartupPlan.h"
+#include <QDebug>
+#include <QJsonArray>
+#include <algorithm>
+
+namespace {
+
+// 未配置ready_timeout_ms时等待就绪的最长时间
+constexpr qint64 kDefaultReadyTimeoutMs = 30000;
+
+} // namespace
+
+ProcessStartupPlan::ProcessStartupPlan(QObject* parent)
+    : QObject(parent)
+    , timeouts_(new TimerWheel(100, 512, this))
+    , unsettled_(0)
+    , finished_at_ms_(-1)
+    , started_(false)
+    , finished_(false)
+{
+}
+
+bool ProcessStartupPlan::build(const QJsonObject& processes_config,
+                               const QStringList& targets,
+                               const QSet<QString>& running,
+                               QString* error_message)
+{
+    nodes_.clear();
+    order_.clear();
+
+    // 收集目标进程及其传递依赖
+    QStringList queue = targets;
+    while (!queue.isEmpty()) {
+        const QString process_id = queue.takeFirst();
+        if (nodes_.contains(process_id)) {
+            continue;
+        }
+        if (!processes_config.contains(process_id)) {
+            *error_message = QString("未配置的进程: %1").arg(process_id);
+            nodes_.clear();
+            return false;
+        }
+
+        const QJsonObject config = processes_config.value(process_id).toObject();
+        Node node;
+        node.process_id = process_id;
+
+        const QJsonValue depends_on = config.value("depends_on");
+        if (depends_on.isString()) {
+            node.depends_on.append(depends_on.toString());
+        } else {
+            for (const QJsonValue& dependency : depends_on.toArray()) {
+                node.depends_on.append(dependency.toString());
+            }
+        }
+        node.depends_on.removeAll(QString());
+        node.depends_on.removeDuplicates();
+
+        const QString ready_on = config.value("ready_on").toString("started");
+        if (ready_on == "hello") {
+            node.ready_on = ReadyOn::kHello;
+        } else if (ready_on == "first_heartbeat") {
+            node.ready_on = ReadyOn::kFirstHeartbeat;
+        } else if (ready_on != "started") {
+            qWarning() << "[ProcessStartupPlan] 未知的ready_on:" << ready_on << "进程:" << process_id << "按started处理";
+        }
+
+        node.ready_timeout_ms = config.value("ready_timeout_ms").toInteger(kDefaultReadyTimeoutMs);
+        node.already_running = running.contains(process_id);
+
+        queue.append(node.depends_on);
+        nodes_.insert(process_id, node);
+    }
+
+    // 拓扑排序，排不进去的进程处在依赖环中
+    QHash<QString, int> in_degree;
+    QStringList keys = nodes_.keys();
+    std::sort(keys.begin(), keys.end());
+    for (const QString& process_id : keys) {
+        const QStringList depends_on = nodes_.value(process_id).depends_on;
+        in_degree[process_id] = static_cast<int>(depends_on.size());
+        for (const QString& dependency : depends_on) {
+            nodes_[dependency].dependents.append(process_id);
+        }
+    }
+
+    QStringList ready_queue;
+    for (const QString& process_id : keys) {
+        if (in_degree.value(process_id) == 0) {
+            ready_queue.append(process_id);
+        }
+    }
+    while (!ready_queue.isEmpty()) {
+        const QString process_id = ready_queue.takeFirst();
+        order_.append(process_id);
+        for (const QString& dependent : nodes_[process_id].dependents) {
+            if (--in_degree[dependent] == 0) {
+                ready_queue.append(dependent);
+            }
+        }
+    }
+
+    if (order_.size() != nodes_.size()) {
+        QStringList cyclic;
+        for (const QString& process_id : keys) {
+            if (!order_.contains(process_id)) {
+                cyclic.append(process_id);
+            }
+        }
+        *error_message = QString("进程之间存在循环依赖: %1").arg(cyclic.join(", "));
+        nodes_.clear();
+        order_.clear();
+        return false;
+    }
+
+    // 已在运行的进程直接就绪，其余进程等待尚未就绪的依赖
+    unsettled_ = 0;
+    for (const QString& process_id : order_) {
+        Node& node = nodes_[process_id];
+        if (node.already_running) {
+            node.state = NodeState::kReady;
+            continue;
+        }
+        ++unsettled_;
+        for (const QString& dependency : node.depends_on) {
+            if (nodes_[dependency].state != NodeState::kReady) {
+                ++node.unready_dependencies;
+            }
+        }
+    }
+
+    qDebug() << "[ProcessStartupPlan] 启动顺序:" << order_;
+    return true;
+}
+
+void ProcessStartupPlan::start()
+{
+    if (started_) {
+        return;
+    }
+    started_ = true;
+    clock_.start();
+    LaunchReadyNodes();
+    Settle();
+}
+
+void ProcessStartupPlan::markStarted(const QString& process_id)
+{
+    auto it = nodes_.find(process_id);
+    if (!started_ || it == nodes_.end() || it->started) {
+        return;
+    }
+    it->started = true;
+    it->started_at_ms = clock_.elapsed();
+    CheckReady(*it);
+    Settle();
+}
+
+void ProcessStartupPlan::markHello(const QString& process_id)
+{
+    auto it = nodes_.find(process_id);
+    if (!started_ || it == nodes_.end() || it->hello) {
+        return;
+    }
+    it->hello = true;
+    it->hello_at_ms = clock_.elapsed();
+    CheckReady(*it);
+    Settle();
+}
+
+void ProcessStartupPlan::markHeartbeat(const QString& process_id)
+{
+    auto it = nodes_.find(process_id);
+    if (!started_ || it == nodes_.end() || it->heartbeat) {
+        return;
+    }
+    it->heartbeat = true;
+    CheckReady(*it);
+    Settle();
+}
+
+void ProcessStartupPlan::markFailed(const QString& process_id, const QString& reason)
+{
+    auto it = nodes_.find(process_id);
+    if (!started_ || it == nodes_.end()) {
+        return;
+    }
+    Fail(*it, reason);
+    Settle();
+}
+
+QJsonObject ProcessStartupPlan::report() const
+{
+    QJsonObject processes;
+    QString slowest;
+    qint64 slowest_ms = -1;
+
+    for (const QString& process_id : order_) {
+        const Node& node = nodes_[process_id];
+        QJsonObject entry;
+        entry["ready_on"] = readyOnName(node.ready_on);
+        entry["wave"] = node.wave;
+        if (!node.depends_on.isEmpty()) {
+            entry["depends_on"] = QJsonArray::fromStringList(node.depends_on);
+        }
+
+        switch (node.state) {
+            case NodeState::kWaiting:  entry["state"] = "waiting"; break;
+            case NodeState::kLaunched: entry["state"] = "launched"; break;
+            case NodeState::kReady:    entry["state"] = node.already_running ? "already_running" : "ready"; break;
+            case NodeState::kFailed:   entry["state"] = "failed"; break;
+        }
+
+        // 各阶段耗时均从发起启动算起
+        if (node.launched_at_ms >= 0) {
+            entry["launched_at_ms"] = node.launched_at_ms;
+            if (node.started_at_ms >= 0) {
+                entry["time_to_started_ms"] = node.started_at_ms - node.launched_at_ms;
+            }
+            if (node.hello_at_ms >= 0) {
+                entry["time_to_hello_ms"] = node.hello_at_ms - node.launched_at_ms;
+            }
+            if (node.ready_at_ms >= 0) {
+                const qint64 time_to_ready_ms = node.ready_at_ms - node.launched_at_ms;
+                entry["time_to_ready_ms"] = time_to_ready_ms;
+                if (time_to_ready_ms > slowest_ms) {
+                    slowest_ms = time_to_ready_ms;
+                    slowest = process_id;
+                }
+            }
+        }
+        if (!node.failure.isEmpty()) {
+            entry["error"] = node.failure;
+        }
+        processes[process_id] = entry;
+    }
+
+    QJsonObject report;
+    report["processes"] = processes;
+    report["finished"] = finished_;
+    if (finished_) {
+        report["total_ms"] = finished_at_ms_;
+    } else if (started_) {
+        report["elapsed_ms"] = clock_.elapsed();
+    }
+    if (!slowest.isEmpty()) {
+        report["slowest"] = slowest;
+        report["slowest_ms"] = slowest_ms;
+    }
+    return report;
+}
+
+QString ProcessStartupPlan::readyOnName(ReadyOn ready_on)
+{
+    switch (ready_on) {
+        case ReadyOn::kHello:          return QStringLiteral("hello");
+        case ReadyOn::kFirstHeartbeat: return QStringLiteral("first_heartbeat");
+        case ReadyOn::kStarted:
+        default:                       return QStringLiteral("started");
+    }
+}
+
+void ProcessStartupPlan::LaunchReadyNodes()
+{
+    QStringList wave;
+    for (const QString& process_id : order_) {
+        Node& node = nodes_[process_id];
+        if (node.state != NodeState::kWaiting || node.unready_dependencies > 0) {
+            continue;
+        }
+
+        node.state = NodeState::kLaunched;
+        node.launched_at_ms = clock_.elapsed();
+        node.wave = 1;
+        for (const QString& dependency : node.depends_on) {
+            node.wave = std::max(node.wave, nodes_[dependency].wave + 1);
+        }
+
+        if (node.ready_timeout_ms > 0) {
+            const qint64 timeout_ms = node.ready_timeout_ms;
+            node.timeout_id = timeouts_->schedule(timeout_ms, [this, process_id, timeout_ms]() {
+                auto it = nodes_.find(process_id);
+                if (it == nodes_.end() || it->state != NodeState::kLaunched) {
+                    return;
+                }
+                it->timeout_id = 0;
+                Fail(*it, QString("%1 毫秒内未就绪").arg(timeout_ms));
+                Settle();
+            });
+        }
+        wave.append(process_id);
+    }
+
+    if (wave.isEmpty()) {
+        return;
+    }
+
+    qInfo() << "[ProcessStartupPlan] 启动进程:" << wave;
+    emit launchRequested(wave);
+
+    // 在等待依赖期间已被手动启动的进程，标记可能早已满足就绪条件
+    for (const QString& process_id : wave) {
+        CheckReady(nodes_[process_id]);
+    }
+}
+
+void ProcessStartupPlan::CheckReady(Node& node)
+{
+    if (node.state != NodeState::kLaunched) {
+        return;
+    }
+
+    // 更晚的阶段蕴含更早的阶段：收到心跳说明进程必然已启动并发送过kHello
+    bool ready = false;
+    switch (node.ready_on) {
+        case ReadyOn::kStarted:
+            ready = node.started || node.hello || node.heartbeat;
+            break;
+        case ReadyOn::kHello:
+            ready = node.hello || node.heartbeat;
+            break;
+        case ReadyOn::kFirstHeartbeat:
+            ready = node.heartbeat;
+            break;
+    }
+    if (ready) {
+        MarkReady(node);
+    }
+}
+
+void ProcessStartupPlan::MarkReady(Node& node)
+{
+    node.state = NodeState::kReady;
+    node.ready_at_ms = clock_.elapsed();
+    if (node.timeout_id != 0) {
+        timeouts_->cancel(node.timeout_id);
+        node.timeout_id = 0;
+    }
+    --unsettled_;
+
+    const qint64 time_to_ready_ms = node.ready_at_ms - node.launched_at_ms;
+    qInfo() << "[ProcessStartupPlan] 进程就绪:" << node.process_id
+            << "条件:" << readyOnName(node.ready_on) << "耗时:" << time_to_ready_ms << "ms";
+    emit processReady(node.process_id, time_to_ready_ms);
+
+    for (const QString& dependent : node.dependents) {
+        --nodes_[dependent].unready_dependencies;
+    }
+    LaunchReadyNodes();
+}
+
+void ProcessStartupPlan::Fail(Node& node, const QString& reason)
+{
+    if (node.state == NodeState::kReady || node.state == NodeState::kFailed) {
+        return;
+    }
+    if (node.timeout_id != 0) {
+        timeouts_->cancel(node.timeout_id);
+        node.timeout_id = 0;
+    }
+    node.state = NodeState::kFailed;
+    node.failure = reason;
+    --unsettled_;
+
+    qWarning() << "[ProcessStartupPlan] 进程未能就绪:" << node.process_id << reason;
+    emit processFailed(node.process_id, reason);
+
+    for (const QString& dependent : node.dependents) {
+        Fail(nodes_[dependent], QString("依赖 %1 未就绪").arg(node.process_id));
+    }
+}
+
+void ProcessStartupPlan::Settle()
+{
+    if (finished_ || !started_ || unsettled_ > 0) {
+        return;
+    }
+    finished_ = true;
+    finished_at_ms_ = clock_.elapsed();
+
+    const QJsonObject summary = report();
+    qInfo() << "[ProcessStartupPlan] 启动完成, 总耗时:" << finished_at_ms_ << "ms"
+            << "最慢进程:" << summary.value("slowest").toString()
+            << summary.value("slowest_ms").toInteger() << "ms";
+    emit finished(summary);
+}
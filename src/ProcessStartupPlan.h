@@ -0,0 +1,155 @@
+#ifndef MASTER_SRC_PROCESSSTARTUPPLAN_H_
+#define MASTER_SRC_PROCESSSTARTUPPLAN_H_
+
+#include "TimerWheel.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief 按依赖关系分波启动子进程的启动图
+ *
+ * processes配置中每一项可以带以下可选字段：
+ * - depends_on：依赖的进程ID（字符串或数组），依赖全部就绪后才启动
+ * - ready_on：就绪条件，"started"（默认，进程已启动）、"hello"（已发送kHello）
+ *   或 "first_heartbeat"（已收到首个心跳）
+ * - ready_timeout_ms：可选，启动后等待就绪的最长时间，默认30秒，0表示不限
+ *
+ * 启动图本身不启动进程：依赖全部就绪的进程通过launchRequested成批发出，
+ * 由调用方交给ProcessManager并发启动；进程事件通过mark*()反馈回来。
+ * 某个进程失败或就绪超时时，所有（直接或间接）依赖它的进程都不再启动。
+ * 每个进程的启动耗时和就绪耗时记录在report()中，便于找出拖慢启动的插件。
+ *
+ * 只能在所属线程使用。
+ */
+class ProcessStartupPlan : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 就绪条件
+     */
+    enum class ReadyOn {
+        kStarted = 0,       ///< 进程已启动
+        kHello,             ///< 已发送kHello
+        kFirstHeartbeat     ///< 已收到首个心跳
+    };
+
+    explicit ProcessStartupPlan(QObject* parent = nullptr);
+
+    /**
+     * @brief 根据processes配置构建启动图
+     * @param processes_config processes配置段
+     * @param targets 需要启动的进程，它们的依赖自动加入
+     * @param running 已在运行的进程，直接视为就绪
+     * @param error_message 输出错误信息（未知进程、循环依赖）
+     * @return 构建是否成功
+     */
+    bool build(const QJsonObject& processes_config,
+               const QStringList& targets,
+               const QSet<QString>& running,
+               QString* error_message);
+
+    /**
+     * @brief 发出第一波启动请求
+     */
+    void start();
+
+    void markStarted(const QString& process_id);
+    void markHello(const QString& process_id);
+    void markHeartbeat(const QString& process_id);
+
+    /**
+     * @brief 进程在就绪之前失败（启动失败、崩溃、退出），已就绪的进程不受影响
+     */
+    void markFailed(const QString& process_id, const QString& reason);
+
+    bool isFinished() const { return finished_; }
+
+    /**
+     * @brief 启动报告：总耗时、最慢进程以及每个进程的波次与各阶段耗时（毫秒）
+     */
+    QJsonObject report() const;
+
+    static QString readyOnName(ReadyOn ready_on);
+
+signals:
+    /**
+     * @brief 一波依赖已全部就绪的进程可以启动
+     * @param process_ids 进程ID列表
+     */
+    void launchRequested(const QStringList& process_ids);
+
+    /**
+     * @brief 进程达到就绪条件
+     * @param process_id 进程标识符
+     * @param time_to_ready_ms 从发起启动到就绪的毫秒数
+     */
+    void processReady(const QString& process_id, qint64 time_to_ready_ms);
+
+    /**
+     * @brief 进程未能就绪，依赖它的进程随之放弃
+     * @param process_id 进程标识符
+     * @param reason 原因
+     */
+    void processFailed(const QString& process_id, const QString& reason);
+
+    /**
+     * @brief 所有进程都已就绪或失败
+     * @param report 启动报告，同report()
+     */
+    void finished(const QJsonObject& report);
+
+private:
+    enum class NodeState {
+        kWaiting = 0,       ///< 等待依赖就绪
+        kLaunched,          ///< 已请求启动，等待就绪
+        kReady,             ///< 已就绪
+        kFailed             ///< 失败或因依赖失败而放弃
+    };
+
+    struct Node {
+        QString process_id;
+        QStringList depends_on;
+        QStringList dependents;
+        ReadyOn ready_on = ReadyOn::kStarted;
+        qint64 ready_timeout_ms = 0;
+        NodeState state = NodeState::kWaiting;
+        bool already_running = false;
+        int unready_dependencies = 0;
+        int wave = 0;
+        bool started = false;
+        bool hello = false;
+        bool heartbeat = false;
+        qint64 launched_at_ms = -1;     ///< 以下时间均相对start()
+        qint64 started_at_ms = -1;
+        qint64 hello_at_ms = -1;
+        qint64 ready_at_ms = -1;
+        TimerWheel::TimerId timeout_id = 0;
+        QString failure;
+    };
+
+    QHash<QString, Node> nodes_;
+    QStringList order_;                 ///< 拓扑序，launchRequested按此顺序列出
+    QElapsedTimer clock_;
+    TimerWheel* timeouts_;
+    int unsettled_;                     ///< 尚未就绪或失败的进程数
+    qint64 finished_at_ms_;             ///< 全部进程有结果的时间（相对start()）
+    bool started_;
+    bool finished_;
+
+    /**
+     * @brief 启动依赖已全部就绪的等待中进程
+     */
+    void LaunchReadyNodes();
+    void CheckReady(Node& node);
+    void MarkReady(Node& node);
+    void Fail(Node& node, const QString& reason);
+    void Settle();
+};
+
+#endif // MASTER_SRC_PROCESSSTARTUPPLAN_H_
@@ -364,9 +364,43 @@ QJsonObject ProjectConfig::createDefaultConfig()
     // IPC配置
     QJsonObject ipcConfig;
     ipcConfig["type"] = "local_socket";
+    ipcConfig["migration_drain_timeout_ms"] = 10000;  // 不停机切换策略时旧策略的最长排空时间
     ipcConfig["local_socket"] = QJsonObject{
         {"server_name", "master_ipc_server"},
-        {"max_connections", 100}
+        {"max_connections", 100},
+        {"accept_rate_per_second", 50},
+        {"accept_burst", 100},
+        {"hello_timeout_ms", 5000},
+        {"outbound_high_water_bytes", 4 * 1024 * 1024},
+        {"outbound_low_water_bytes", 1024 * 1024},
+        {"bulk_budget_bytes", 64 * 1024},
+        {"topic_policies", QJsonObject()},
+        {"topic_lanes", QJsonObject()},
+        {"relay_enabled", true}
+    };
+    ipcConfig["tcp_socket"] = QJsonObject{
+        {"bind_addresses", QJsonArray{"127.0.0.1"}},
+        {"port", 27500},
+        {"max_connections", 100},
+        {"accept_rate_per_second", 50},
+        {"accept_burst", 100},
+        {"hello_timeout_ms", 5000},
+        {"no_delay", true},
+        {"keepalive", true},
+        {"keepalive_idle_seconds", 10},
+        {"keepalive_interval_seconds", 5},
+        {"keepalive_count", 3}
+    };
+    ipcConfig["shared_memory"] = QJsonObject{
+        {"enabled", true},
+        {"ring_bytes", 8 * 1024 * 1024}
+    };
+    ipcConfig["peer_channels"] = QJsonObject{
+        {"enabled", true},
+        {"max_channels", 64},
+        {"offer_timeout_ms", 5000},
+        {"shm_ring_bytes", 4 * 1024 * 1024},
+        {"allow", QJsonObject()}
     };
     defaultConfig["ipc"] = ipcConfig;
     
@@ -381,6 +415,14 @@ QJsonObject ProjectConfig::createDefaultConfig()
     masterProcessLogConfig["config"] = fileLogConfig;
     logStoragesConfig["master_process"] = masterProcessLogConfig;
     defaultConfig["log_storages"] = logStoragesConfig;
+
+    // 关闭子进程的各阶段等待时间（毫秒）
+    QJsonObject shutdownConfig;
+    shutdownConfig["ack_timeout_ms"] = 2000;
+    shutdownConfig["exit_timeout_ms"] = 5000;
+    shutdownConfig["terminate_timeout_ms"] = 3000;
+    shutdownConfig["kill_timeout_ms"] = 2000;
+    defaultConfig["shutdown"] = shutdownConfig;
     
     return defaultConfig;
 }
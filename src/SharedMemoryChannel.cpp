@@ -0,0 +1,208 @@
+#include "SharedMemoryChannel.h"
+#include "IpcReceiveBuffer.h"
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace {
+    constexpr quint64 kMinRingBytes = 64 * 1024;
+    constexpr quint64 kMaxRingBytes = 1024ULL * 1024 * 1024;
+
+    quint64 roundUpToPowerOfTwo(quint64 value)
+    {
+        quint64 result = kMinRingBytes;
+        while (result < value && result < kMaxRingBytes) {
+            result <<= 1;
+        }
+        return result;
+    }
+}
+
+SharedMemoryTransportConfig SharedMemoryTransportConfig::fromJson(const QJsonObject& shared_memory)
+{
+    SharedMemoryTransportConfig config;
+    config.enabled = shared_memory["enabled"].toBool(true);
+    config.ring_bytes = static_cast<qint64>(
+        roundUpToPowerOfTwo(static_cast<quint64>(shared_memory["ring_bytes"].toInteger(config.ring_bytes))));
+    return config;
+}
+
+// ================== SharedMemoryRing 实现 ==================
+
+void SharedMemoryRing::attach(void* memory, quint64 capacity, bool initialize)
+{
+    if (initialize) {
+        header_ = new (memory) Header();
+        header_->write_pos.store(0, std::memory_order_relaxed);
+        header_->read_pos.store(0, std::memory_order_relaxed);
+        header_->consumer_waiting.store(1, std::memory_order_relaxed);
+        header_->producer_waiting.store(0, std::memory_order_relaxed);
+        header_->capacity = capacity;
+    } else {
+        header_ = static_cast<Header*>(memory);
+    }
+    data_ = static_cast<char*>(memory) + sizeof(Header);
+    capacity_ = capacity;
+    corrupted_ = false;
+    // 本端只使用自己维护的位置，对端写入的计数每次读取后校验
+    write_pos_ = header_->write_pos.load(std::memory_order_relaxed);
+    read_pos_ = header_->read_pos.load(std::memory_order_relaxed);
+}
+
+qsizetype SharedMemoryRing::write(QByteArrayView data)
+{
+    if (corrupted_) {
+        return -1;
+    }
+    // 读位置由对端写入：只读取一次，不能后退，也不能超过本端已写入的位置
+    const quint64 read_pos = header_->read_pos.load(std::memory_order_acquire);
+    if (read_pos < read_pos_ || read_pos > write_pos_) {
+        corrupted_ = true;
+        return -1;
+    }
+    read_pos_ = read_pos;
+
+    const quint64 free_bytes = capacity_ - (write_pos_ - read_pos);
+    const quint64 bytes = std::min<quint64>(free_bytes, static_cast<quint64>(data.size()));
+    if (bytes == 0) {
+        return 0;
+    }
+
+    const quint64 index = write_pos_ & (capacity_ - 1);
+    const quint64 first = std::min(bytes, capacity_ - index);
+    std::memcpy(data_ + index, data.data(), first);
+    if (bytes > first) {
+        std::memcpy(data_, data.data() + first, std::min(bytes - first, index));
+    }
+    write_pos_ += bytes;
+    header_->write_pos.store(write_pos_, std::memory_order_release);
+    return static_cast<qsizetype>(bytes);
+}
+
+void SharedMemoryRing::armProducerWait()
+{
+    header_->producer_waiting.store(1, std::memory_order_seq_cst);
+}
+
+bool SharedMemoryRing::takeConsumerWaiting()
+{
+    // 与消费者的“置位后复查”配对，保证不会双方都错过对方的更新
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (header_->consumer_waiting.load(std::memory_order_relaxed) == 0) {
+        return false;
+    }
+    return header_->consumer_waiting.exchange(0, std::memory_order_acq_rel) == 1;
+}
+
+qsizetype SharedMemoryRing::readInto(IpcReceiveBuffer* buffer)
+{
+    if (corrupted_) {
+        return -1;
+    }
+    // 写位置由对端写入：只读取一次，不能后退，可读字节数也不能超过容量
+    const quint64 write_pos = header_->write_pos.load(std::memory_order_acquire);
+    if (write_pos < write_pos_ || write_pos - read_pos_ > capacity_) {
+        corrupted_ = true;
+        return -1;
+    }
+    write_pos_ = write_pos;
+
+    const quint64 bytes = write_pos - read_pos_;
+    if (bytes == 0) {
+        return 0;
+    }
+
+    const quint64 index = read_pos_ & (capacity_ - 1);
+    const quint64 first = std::min(bytes, capacity_ - index);
+    buffer->append(QByteArrayView(data_ + index, static_cast<qsizetype>(first)));
+    if (bytes > first) {
+        buffer->append(QByteArrayView(data_, static_cast<qsizetype>(std::min(bytes - first, index))));
+    }
+    read_pos_ = write_pos;
+    header_->read_pos.store(read_pos_, std::memory_order_release);
+    return static_cast<qsizetype>(bytes);
+}
+
+bool SharedMemoryRing::prepareConsumerWait()
+{
+    header_->consumer_waiting.store(1, std::memory_order_seq_cst);
+    const quint64 write_pos = header_->write_pos.load(std::memory_order_seq_cst);
+    if (write_pos != read_pos_) {
+        header_->consumer_waiting.store(0, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+bool SharedMemoryRing::takeProducerWaiting()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (header_->producer_waiting.load(std::memory_order_relaxed) == 0) {
+        return false;
+    }
+    return header_->producer_waiting.exchange(0, std::memory_order_acq_rel) == 1;
+}
+
+quint64 SharedMemoryRing::usedBytes() const
+{
+    // 对端的读位置只在校验范围内采用，异常值留给下一次write处理
+    const quint64 read_pos = header_->read_pos.load(std::memory_order_acquire);
+    if (read_pos < read_pos_ || read_pos > write_pos_) {
+        return write_pos_ - read_pos_;
+    }
+    return write_pos_ - read_pos;
+}
+
+// ================== SharedMemoryChannel 实现 ==================
+
+std::unique_ptr<SharedMemoryChannel> SharedMemoryChannel::create(const QString& key, qint64 ring_bytes, QString* error)
+{
+    const quint64 capacity = roundUpToPowerOfTwo(static_cast<quint64>(ring_bytes));
+    const qsizetype ring_size = SharedMemoryRing::requiredSize(capacity);
+    const qsizetype segment_size = sizeof(SegmentHeader) + 2 * ring_size;
+
+    std::unique_ptr<SharedMemoryChannel> channel(new SharedMemoryChannel());
+    channel->memory_.setKey(key);
+    if (!channel->memory_.create(segment_size)) {
+        if (channel->memory_.error() != QSharedMemory::AlreadyExists) {
+            *error = channel->memory_.errorString();
+            return nullptr;
+        }
+        // 上次异常退出残留的同名段：附加后分离以释放，再重新创建
+        qWarning() << "[SharedMemoryChannel] 发现残留的共享内存段，尝试回收:" << key;
+        if (channel->memory_.attach()) {
+            channel->memory_.detach();
+        }
+        if (!channel->memory_.create(segment_size)) {
+            *error = channel->memory_.errorString();
+            return nullptr;
+        }
+    }
+
+    char* base = static_cast<char*>(channel->memory_.data());
+    SegmentHeader* header = new (base) SegmentHeader();
+    header->magic = kSegmentMagic;
+    header->version = kSegmentVersion;
+    header->ring_capacity = capacity;
+    channel->outbound_.attach(base + sizeof(SegmentHeader), capacity, true);
+    channel->inbound_.attach(base + sizeof(SegmentHeader) + ring_size, capacity, true);
+    return channel;
+}
+
+SharedMemoryChannel::~SharedMemoryChannel()
+{
+    if (memory_.isAttached()) {
+        memory_.detach();
+    }
+}
+
+QJsonObject SharedMemoryChannel::describe() const
+{
+    QJsonObject description;
+    description["shm_key"] = memory_.key();
+    description["shm_native_key"] = memory_.nativeKey();
+    description["shm_ring_bytes"] = static_cast<qint64>(outbound_.capacity());
+    description["shm_layout_version"] = static_cast<int>(kSegmentVersion);
+    return description;
+}
@@ -0,0 +1,169 @@
+#ifndef MASTER_SRC_SHAREDMEMORYCHANNEL_H_
+#define MASTER_SRC_SHAREDMEMORYCHANNEL_H_
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QJsonObject>
+#include <QSharedMemory>
+#include <QString>
+#include <atomic>
+#include <memory>
+
+class IpcReceiveBuffer;
+
+/**
+ * @brief 共享内存传输配置，取自 ipc.shared_memory
+ */
+struct SharedMemoryTransportConfig {
+    bool enabled = false;                    // 是否允许插件在握手时升级到共享内存
+    qint64 ring_bytes = 8 * 1024 * 1024;     // 每个方向的环形缓冲区大小（向上取2的幂）
+
+    static SharedMemoryTransportConfig fromJson(const QJsonObject& shared_memory);
+};
+
+/**
+ * @brief 位于共享内存中的单生产者单消费者字节环
+ *
+ * 环内直接存放 IpcFrameCodec 编码后的帧字节流（帧自带边界），允许一帧跨越
+ * 环尾回绕，也允许生产者分多次写入同一帧。读写位置单调递增，下标取
+ * position & (capacity - 1)。
+ *
+ * 唤醒协议（双方对称）：消费者读空后置位 consumer_waiting 并再次检查，
+ * 生产者写入后若 consumer_waiting 由1变0则发送一个门铃字节；生产者因空间
+ * 不足暂停时置位 producer_waiting 并再尝试写一次，消费者读出数据后若其
+ * 由1变0则回送门铃。环创建时 consumer_waiting 为1，首次写入即发门铃。
+ *
+ * 对端可以任意改写共享内存中的计数，本端只信任自己维护的位置：对端的计数
+ * 每次读取一次并校验，后退或超出容量时环被标记为损坏，之后读写都返回-1。
+ */
+class SharedMemoryRing {
+public:
+    struct alignas(64) Header {
+        alignas(64) std::atomic<quint64> write_pos;         // 生产者写入
+        alignas(64) std::atomic<quint64> read_pos;          // 消费者写入
+        alignas(64) std::atomic<quint32> consumer_waiting;  // 消费者已读空并等待门铃
+        std::atomic<quint32> producer_waiting;              // 生产者因环满等待门铃
+        quint64 capacity;
+    };
+    static_assert(std::atomic<quint64>::is_always_lock_free, "共享内存中的原子量必须无锁");
+    static_assert(std::atomic<quint32>::is_always_lock_free, "共享内存中的原子量必须无锁");
+
+    /**
+     * @brief 一个方向的环在共享内存中占用的字节数
+     */
+    static qsizetype requiredSize(quint64 capacity) { return sizeof(Header) + capacity; }
+
+    SharedMemoryRing() = default;
+
+    /**
+     * @brief 绑定到共享内存中的一段区域
+     * @param memory 区域起始地址（需64字节对齐）
+     * @param capacity 数据区容量，必须是2的幂
+     * @param initialize 是否初始化头部（仅创建方调用）
+     */
+    void attach(void* memory, quint64 capacity, bool initialize);
+
+    // ==================== 生产者接口 ====================
+
+    /**
+     * @brief 尽可能多地写入数据
+     * @return 实际写入的字节数，环满时为0，对端破坏了读位置时为-1
+     */
+    qsizetype write(QByteArrayView data);
+
+    /**
+     * @brief 写不下时调用：置位producer_waiting，调用方随后必须再尝试写一次
+     */
+    void armProducerWait();
+
+    /**
+     * @brief 写入后调用：消费者是否在等待门铃
+     */
+    bool takeConsumerWaiting();
+
+    // ==================== 消费者接口 ====================
+
+    /**
+     * @brief 读出全部可读数据追加到接收缓冲区
+     * @return 读出的字节数（不超过容量），对端破坏了写位置时为-1
+     */
+    qsizetype readInto(IpcReceiveBuffer* buffer);
+
+    /**
+     * @brief 读空后调用：置位consumer_waiting并复查
+     * @return 复查时又有数据返回true（应继续读取），否则返回false
+     */
+    bool prepareConsumerWait();
+
+    /**
+     * @brief 读出后调用：生产者是否在等待门铃
+     */
+    bool takeProducerWaiting();
+
+    /**
+     * @brief 生产者侧已写入、对端尚未读出的字节数
+     */
+    quint64 usedBytes() const;
+    quint64 capacity() const { return capacity_; }
+
+    /**
+     * @brief 对端写入的计数曾未通过校验
+     */
+    bool isCorrupted() const { return corrupted_; }
+
+private:
+    Header* header_ = nullptr;
+    char* data_ = nullptr;
+    quint64 capacity_ = 0;
+    quint64 write_pos_ = 0;      // 生产者：本端位置；消费者：上次校验过的对端位置
+    quint64 read_pos_ = 0;       // 消费者：本端位置；生产者：上次校验过的对端位置
+    bool corrupted_ = false;
+};
+
+/**
+ * @brief 一个客户端的共享内存通道（两个方向各一个环）
+ *
+ * 段布局：[SegmentHeader][主控->插件环 Header+数据][插件->主控环 Header+数据]，
+ * 每个Header均按64字节对齐。主控创建并初始化段，插件按握手应答中的
+ * shm_key（QSharedMemory key）或 shm_native_key 附加。
+ */
+class SharedMemoryChannel {
+public:
+    static constexpr quint32 kSegmentMagic = 0x4D534852;  // "RHSM"
+    static constexpr quint32 kSegmentVersion = 1;
+    static constexpr quint8 kDoorbellByte = 0x00;        // 门铃字节，不可能是帧首字节
+
+    struct alignas(64) SegmentHeader {
+        quint32 magic;
+        quint32 version;
+        quint64 ring_capacity;
+    };
+
+    /**
+     * @brief 创建并初始化共享内存段
+     * @param key QSharedMemory key
+     * @param ring_bytes 每个方向的环容量
+     * @param error 失败时的错误信息
+     * @return 通道对象，失败返回nullptr
+     */
+    static std::unique_ptr<SharedMemoryChannel> create(const QString& key, qint64 ring_bytes, QString* error);
+
+    ~SharedMemoryChannel();
+
+    SharedMemoryRing& outbound() { return outbound_; }   // 主控 -> 插件
+    SharedMemoryRing& inbound() { return inbound_; }     // 插件 -> 主控
+
+    /**
+     * @brief 握手应答中告知插件的附加参数
+     */
+    QJsonObject describe() const;
+
+private:
+    SharedMemoryChannel() = default;
+
+    QSharedMemory memory_;
+    SharedMemoryRing outbound_;
+    SharedMemoryRing inbound_;
+};
+
+#endif // MASTER_SRC_SHAREDMEMORYCHANNEL_H_
@@ -0,0 +1,27 @@
+#include "SharedMemoryIpcCommunication.h"
+#include <QDebug>
+
+SharedMemoryIpcCommunication::SharedMemoryIpcCommunication(QObject *parent)
+    : LocalSocketIpcCommunication(parent) {}
+
+bool SharedMemoryIpcCommunication::initialize(const QJsonObject &config) {
+  // ipc.shared_memory 中的项覆盖 ipc.local_socket，握手socket共用同一套配置
+  const QJsonObject shared_memory = config["shared_memory"].toObject();
+  QJsonObject local_socket = config["local_socket"].toObject();
+  for (auto it = shared_memory.constBegin(); it != shared_memory.constEnd();
+       ++it) {
+    local_socket[it.key()] = it.value();
+  }
+  QJsonObject merged = config;
+  merged["local_socket"] = local_socket;
+
+  if (!LocalSocketIpcCommunication::initialize(merged)) {
+    return false;
+  }
+
+  shm_config_ = SharedMemoryTransportConfig::fromJson(shared_memory);
+  qDebug() << "[SharedMemoryIpcCommunication] 共享内存传输:"
+           << (shm_config_.enabled ? "启用" : "禁用")
+           << "环容量:" << shm_config_.ring_bytes;
+  return true;
+}
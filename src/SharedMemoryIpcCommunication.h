@@ -0,0 +1,31 @@
+#ifndef MASTER_SRC_SHAREDMEMORYIPCCOMMUNICATION_H_
+#define MASTER_SRC_SHAREDMEMORYIPCCOMMUNICATION_H_
+
+#include "LocalSocketIpcCommunication.h"
+
+/**
+ * @brief 基于共享内存环形缓冲区的IPC通信实现
+ *
+ * 插件仍通过QLocalSocket连接并完成kHello/kHelloAck握手；若插件在kHello中
+ * 声明 "transports": ["shm"]，主控为其创建一个QSharedMemory段（每个方向一个
+ * SPSC字节环），并在kHelloAck中返回 transport/shm_key/shm_ring_bytes。
+ * 此后帧数据直接写入环中，socket只承载单字节门铃（0x00）用于唤醒对方。
+ * 未声明shm的插件在同一服务器上继续使用socket收发，行为与
+ * LocalSocketIpcCommunication一致。
+ *
+ * 配置取自 ipc.shared_memory，其中未出现的项沿用 ipc.local_socket：
+ * - server_name: 握手所用的本地socket名称
+ * - ring_bytes: 每个方向的环容量（向上取2的幂）
+ * - enabled: 是否允许升级，默认true
+ */
+class SharedMemoryIpcCommunication : public LocalSocketIpcCommunication {
+  Q_OBJECT
+
+public:
+  explicit SharedMemoryIpcCommunication(QObject* parent = nullptr);
+  ~SharedMemoryIpcCommunication() override = default;
+
+  bool initialize(const QJsonObject& config) override;
+};
+
+#endif // MASTER_SRC_SHAREDMEMORYIPCCOMMUNICATION_H_
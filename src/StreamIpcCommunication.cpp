@@ -0,0 +1,1655 @@
+#include "StreamIpcCommunication.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QJsonArray>
+#include <QUuid>
+#include <array>
+
+namespace {
+// 每次主线程派发的事件上限，避免大量消息一次性占满GUI事件循环
+constexpr int kMaxInboundEventsPerDrain = 256;
+// 发布路由缓存的Topic数量上限，超出时整体清空，防止动态Topic无限增长
+constexpr int kMaxCachedTopicRoutes = 1024;
+// 每个连接缓存的转发路由数量上限，超出时清理从未转发过的条目
+constexpr int kMaxRelayRoutesPerConnection = 256;
+
+/**
+ * @brief 把出站队列写入共享内存环
+ *
+ * 环内是连续字节流，环满时一帧可以只写入一部分，剩余部分记录在连接上，
+ * 下次有空间时优先写完，保证帧不交错。
+ */
+class SharedMemoryFrameSink : public IpcFrameSink {
+public:
+  SharedMemoryFrameSink(SharedMemoryRing *ring, QByteArray *partial,
+                        qsizetype *partial_offset)
+      : ring_(ring), partial_(partial), partial_offset_(partial_offset) {}
+
+  qint64 pendingBytes() const override {
+    return static_cast<qint64>(ring_->usedBytes()) + partial_->size() -
+           *partial_offset_;
+  }
+
+  qint64 writeFrame(const QByteArray &frame) override {
+    if (!flushPartial()) {
+      return 0;
+    }
+    const qsizetype bytes = ring_->write(frame);
+    if (bytes <= 0) {
+      return bytes; // -1表示环已损坏
+    }
+    bytes_written_ += bytes;
+    if (bytes < frame.size()) {
+      *partial_ = frame;
+      *partial_offset_ = bytes;
+    }
+    return frame.size();
+  }
+
+  bool flushPartial() {
+    if (partial_->isEmpty()) {
+      return true;
+    }
+    const qsizetype bytes =
+        ring_->write(QByteArrayView(*partial_).sliced(*partial_offset_));
+    if (bytes < 0) {
+      return false;
+    }
+    bytes_written_ += bytes;
+    *partial_offset_ += bytes;
+    if (*partial_offset_ < partial_->size()) {
+      return false;
+    }
+    partial_->clear();
+    *partial_offset_ = 0;
+    return true;
+  }
+
+  qint64 bytesWritten() const { return bytes_written_; }
+
+private:
+  SharedMemoryRing *ring_;
+  QByteArray *partial_;
+  qsizetype *partial_offset_;
+  qint64 bytes_written_ = 0;
+};
+} // namespace
+
+StreamIpcCommunication::StreamIpcCommunication(QObject *parent)
+    : IIpcCommunication(parent),
+      connection_state_(ConnectionState::kDisconnected) {
+  qDebug() << "[StreamIpcCommunication] 构造函数调用";
+}
+
+StreamIpcCommunication::~StreamIpcCommunication() {
+  qDebug() << "[StreamIpcCommunication] 析构函数调用";
+  stop();
+}
+
+void StreamIpcCommunication::initializeStream(const QJsonObject &section) {
+  outbound_config_ = IpcOutboundQueueConfig::fromJson(section);
+  relay_enabled_ = section["relay_enabled"].toBool(true);
+  admission_config_ = IpcAdmissionConfig::fromJson(section);
+  qDebug() << "[StreamIpcCommunication] 出站高/低水位:"
+           << outbound_config_.high_water_bytes << "/"
+           << outbound_config_.low_water_bytes
+           << "插件间转发:" << relay_enabled_;
+  qDebug() << "[StreamIpcCommunication] 连接上限:"
+           << admission_config_.max_connections
+           << "接受速率:" << admission_config_.accept_rate_per_second << "/s"
+           << "握手超时:" << admission_config_.hello_timeout_ms << "ms";
+}
+
+bool StreamIpcCommunication::start() {
+  if (connection_state_ == ConnectionState::kConnected) {
+    SetLastError("服务器已启动");
+    return true;
+  }
+
+  QString error;
+  if (!StartReactor(&endpoint_, &error)) {
+    SetLastError(QString("启动失败: %1").arg(error));
+    SetConnectionState(ConnectionState::kError);
+    return false;
+  }
+
+  {
+    QWriteLocker locker(&reactor_lock_);
+    reactor_running_ = true;
+  }
+
+  SetConnectionState(ConnectionState::kConnected);
+  qDebug() << "[StreamIpcCommunication] 服务器已启动，监听在:" << endpoint_;
+  return true;
+}
+
+void StreamIpcCommunication::stop() {
+  qDebug() << "[StreamIpcCommunication] 停止服务器";
+  if (connection_state_ == ConnectionState::kDisconnected) {
+    qDebug() << "[StreamIpcCommunication] 服务器已停止";
+    return;
+  }
+
+  // 先禁止新的投递，再关闭反应器
+  bool running = false;
+  {
+    QWriteLocker locker(&reactor_lock_);
+    running = reactor_running_;
+    reactor_running_ = false;
+  }
+  if (running) {
+    StopReactor();
+  }
+
+  {
+    QMutexLocker locker(&directory_mutex_);
+    qDebug() << "[StreamIpcCommunication] 断开所有客户端连接";
+    client_slots_.assign(1, ClientSlot());
+    free_slots_.clear();
+    handle_by_internal_id_.clear();
+    handle_by_logical_id_.clear();
+    topic_subscriptions_.clear();
+    topic_routes_.clear();
+  }
+
+  // 丢弃尚未发出的命令和尚未派发的事件
+  IpcOutboundCommand pending_command;
+  while (outbound_queue_.tryPop(&pending_command)) {
+  }
+  outbound_drain_scheduled_.store(false);
+  IpcInboundEvent pending_event;
+  while (inbound_queue_.tryPop(&pending_event)) {
+  }
+  while (inbound_bulk_queue_.tryPop(&pending_event)) {
+  }
+
+  SetConnectionState(ConnectionState::kDisconnected);
+  qDebug() << "[StreamIpcCommunication] 服务器已停止";
+}
+
+bool StreamIpcCommunication::StartReactor(QString *endpoint, QString *error) {
+  // 启动I/O线程，服务端和所有客户端socket都归属该线程
+  io_thread_ = std::make_unique<QThread>();
+  io_thread_->setObjectName("StreamIpcIo");
+  StreamIpcReactor *reactor = new StreamIpcReactor(this);
+  reactor->moveToThread(io_thread_.get());
+  connect(io_thread_.get(), &QThread::finished, reactor,
+          &QObject::deleteLater);
+  io_thread_->start();
+
+  bool listening = false;
+  QMetaObject::invokeMethod(
+      reactor,
+      [reactor, &listening, endpoint, error]() {
+        listening = reactor->listen(error);
+        *endpoint = reactor->serverName();
+      },
+      Qt::BlockingQueuedConnection);
+
+  if (!listening) {
+    io_thread_->quit();
+    io_thread_->wait();
+    io_thread_.reset();
+    return false;
+  }
+
+  reactor_ = reactor;
+  return true;
+}
+
+void StreamIpcCommunication::StopReactor() {
+  // 在I/O线程中关闭服务器并断开所有客户端，然后结束线程
+  StreamIpcReactor *reactor = reactor_;
+  reactor_ = nullptr;
+  if (reactor) {
+    QMetaObject::invokeMethod(
+        reactor, [reactor]() { reactor->shutdown(); },
+        Qt::BlockingQueuedConnection);
+  }
+  if (io_thread_) {
+    io_thread_->quit();
+    io_thread_->wait();
+    io_thread_.reset();
+  }
+}
+
+void StreamIpcCommunication::WakeReactor() {
+  QMetaObject::invokeMethod(reactor_, &StreamIpcReactor::drainOutbound,
+                            Qt::QueuedConnection);
+}
+
+QJsonObject StreamIpcCommunication::ReactorStatistics() const {
+  StreamIpcReactor *reactor = reactor_;
+  QJsonObject reactor_stats;
+  if (reactor) {
+    QMetaObject::invokeMethod(
+        reactor,
+        [reactor, &reactor_stats]() { reactor_stats = reactor->statistics(); },
+        Qt::BlockingQueuedConnection);
+  }
+  return reactor_stats;
+}
+
+ConnectionState StreamIpcCommunication::getConnectionState() const {
+  return connection_state_;
+}
+
+bool StreamIpcCommunication::sendMessage(const IpcMessage &message) {
+  // 1. 将逻辑接收者ID转换为连接句柄
+  IpcClientHandle handle = 0;
+  {
+    QMutexLocker locker(&directory_mutex_);
+    handle = handle_by_logical_id_.value(message.receiver_id, 0);
+  }
+  if (handle == 0) {
+    SetLastError(QString("发送消息失败: 逻辑客户端ID '%1' 未映射到内部ID")
+                     .arg(message.receiver_id));
+    return false;
+  }
+
+  return PostToClient(handle, message);
+}
+
+bool StreamIpcCommunication::sendMessage(const QString &client_id,
+                                         const IpcMessage &message) {
+  IpcClientHandle handle = 0;
+  {
+    QMutexLocker locker(&directory_mutex_);
+    handle = handle_by_internal_id_.value(client_id, 0);
+  }
+  if (handle == 0) {
+    SetLastError(
+        QString("发送消息失败: 客户端 '%1' 不存在或未连接").arg(client_id));
+    return false;
+  }
+
+  return PostToClient(handle, message);
+}
+
+IpcMessage
+StreamIpcCommunication::HeartbeatAckFor(const IpcMessage &heartbeat) {
+  // 回显心跳的msg_id，不再为每次应答生成UUID
+  IpcMessage ack;
+  ack.type = MessageType::kHeartbeatAck;
+  ack.topic = heartbeat.topic;
+  ack.msg_id = heartbeat.msg_id;
+  ack.timestamp = QDateTime::currentMSecsSinceEpoch();
+  ack.sender_id = QStringLiteral("main_controller");
+  ack.receiver_id = heartbeat.sender_id;
+  return ack;
+}
+
+const IpcMessage &StreamIpcCommunication::CompactHeartbeatEnvelope() {
+  static const IpcMessage envelope = [] {
+    IpcMessage message{};
+    message.type = MessageType::kHeartbeatAck;
+    message.topic = QStringLiteral("heartbeat");
+    return message;
+  }();
+  return envelope;
+}
+
+IpcMessage
+StreamIpcCommunication::FirstHeartbeatNotice(const QString &sender_id) {
+  IpcMessage notice;
+  notice.type = MessageType::kHeartbeat;
+  notice.topic = QStringLiteral("heartbeat");
+  notice.timestamp = QDateTime::currentMSecsSinceEpoch();
+  notice.sender_id = sender_id;
+  notice.receiver_id = QStringLiteral("main_controller");
+  notice.body["process_name"] = sender_id;
+  notice.body["acknowledged"] = true;
+  return notice;
+}
+
+bool StreamIpcCommunication::PostToClient(IpcClientHandle handle,
+                                          const IpcMessage &message) {
+  IpcOutboundCommand command;
+  command.kind = IpcOutboundCommand::Kind::kUnicast;
+  command.handles.append(handle);
+  command.message = message;
+  return PostOutbound(std::move(command));
+}
+
+bool StreamIpcCommunication::broadcastMessage(const IpcMessage &message) {
+  {
+    QMutexLocker locker(&directory_mutex_);
+    if (handle_by_internal_id_.isEmpty()) {
+      qWarning() << "[StreamIpcCommunication] 广播消息: 没有连接的客户端";
+      return true; // 没有客户端连接，也算成功发送（但不实际发送）
+    }
+  }
+
+  IpcOutboundCommand command;
+  command.kind = IpcOutboundCommand::Kind::kBroadcast;
+  command.message = message;
+  bool posted = PostOutbound(std::move(command));
+  qDebug() << "[StreamIpcCommunication] 广播消息已提交，类型:"
+           << static_cast<int>(message.type);
+  return posted;
+}
+
+bool StreamIpcCommunication::publishToTopic(const QString &topic,
+                                            const IpcMessage &message) {
+  QList<IpcClientHandle> subscribers;
+  {
+    // 常用Topic的匹配结果缓存为句柄列表，命中时不再遍历订阅树
+    QMutexLocker locker(&directory_mutex_);
+    auto route = topic_routes_.constFind(topic);
+    if (route == topic_routes_.constEnd()) {
+      if (topic_routes_.size() >= kMaxCachedTopicRoutes) {
+        topic_routes_.clear();
+      }
+      route = topic_routes_.insert(topic, topic_subscriptions_.match(topic));
+    }
+    subscribers = route.value();
+  }
+  if (subscribers.isEmpty()) {
+    qWarning() << "[StreamIpcCommunication] 发布到Topic '" << topic
+               << "': 没有订阅者";
+    return true; // 没有订阅者，也算成功发布
+  }
+
+  IpcOutboundCommand command;
+  command.kind = IpcOutboundCommand::Kind::kMulticast;
+  command.handles = subscribers;
+  command.message = message;
+  bool posted = PostOutbound(std::move(command));
+  qDebug() << "[StreamIpcCommunication] 发布到Topic '" << topic
+           << "' 已提交，类型:" << static_cast<int>(message.type);
+  return posted;
+}
+
+bool StreamIpcCommunication::subscribeToTopic(const QString &topic) {
+  qDebug() << "[StreamIpcCommunication] 订阅Topic:" << topic
+           << " (服务器端操作)";
+  // 如果需要动态添加订阅者，需要在消息处理逻辑中实现。
+  return true;
+}
+
+bool StreamIpcCommunication::unsubscribeFromTopic(const QString &topic) {
+  qDebug() << "[StreamIpcCommunication] 取消订阅Topic:" << topic
+           << " (服务器端操作)";
+  // 同上，实际应由接收到的消息驱动或在客户端断开时清理。
+  return true;
+}
+
+QStringList StreamIpcCommunication::getSubscribedTopics() const {
+  QMutexLocker locker(&directory_mutex_);
+  return topic_subscriptions_.patterns();
+}
+
+int StreamIpcCommunication::getConnectedClientCount() const {
+  QMutexLocker locker(&directory_mutex_);
+  return handle_by_internal_id_.size();
+}
+
+QStringList StreamIpcCommunication::getConnectedClientIds() const {
+  QMutexLocker locker(&directory_mutex_);
+  return handle_by_internal_id_.keys();
+}
+
+bool StreamIpcCommunication::disconnectClient(const QString &client_id) {
+  IpcClientHandle handle = 0;
+  {
+    QMutexLocker locker(&directory_mutex_);
+    handle = handle_by_internal_id_.value(client_id, 0);
+  }
+  if (handle == 0) {
+    SetLastError(QString("断开客户端失败: '%1' 不存在").arg(client_id));
+    return false;
+  }
+
+  IpcOutboundCommand command;
+  command.kind = IpcOutboundCommand::Kind::kDisconnect;
+  command.handles.append(handle);
+  return PostOutbound(std::move(command));
+}
+
+bool StreamIpcCommunication::isClientOnline(
+    const QString &client_id) const {
+  QMutexLocker locker(&directory_mutex_);
+  return handle_by_internal_id_.contains(client_id);
+}
+
+QString StreamIpcCommunication::getLastError() const {
+  QMutexLocker locker(&error_mutex_);
+  return last_error_;
+}
+
+QString StreamIpcCommunication::getClientIdBySenderId(
+    const QString &sender_id) const {
+  QMutexLocker locker(&directory_mutex_);
+
+  const ClientSlot *slot = FindSlot(handle_by_logical_id_.value(sender_id, 0));
+  if (slot) {
+    return slot->internal_id;
+  }
+
+  qDebug() << "[StreamIpcCommunication] 未找到 " << sender_id
+           << " 对应的内部客户端ID";
+  return QString();
+}
+
+void StreamIpcCommunication::setLivenessTable(
+    std::shared_ptr<IpcLivenessTable> table) {
+  liveness_table_ = std::move(table);
+}
+
+QJsonObject StreamIpcCommunication::getStatistics() const {
+  QJsonObject stats;
+  const qint64 inbound_control =
+      static_cast<qint64>(inbound_queue_.approximateSize());
+  const qint64 inbound_bulk =
+      static_cast<qint64>(inbound_bulk_queue_.approximateSize());
+  stats["inbound_queue_depth"] = inbound_control + inbound_bulk;
+  stats["inbound_lanes"] = QJsonObject{
+      {ipcLaneName(IpcLane::kControl), inbound_control},
+      {ipcLaneName(IpcLane::kBulk), inbound_bulk}};
+  stats["outbound_command_queue_depth"] =
+      static_cast<qint64>(outbound_queue_.approximateSize());
+
+  QReadLocker locker(&reactor_lock_);
+  if (reactor_running_) {
+    const QJsonObject reactor_stats = ReactorStatistics();
+    for (auto it = reactor_stats.constBegin(); it != reactor_stats.constEnd();
+         ++it) {
+      stats.insert(it.key(), it.value());
+    }
+  }
+  return stats;
+}
+
+void StreamIpcCommunication::SetConnectionState(ConnectionState state) {
+  if (connection_state_ != state) {
+    connection_state_ = state;
+    emit connectionStateChanged(state);
+  }
+}
+
+void StreamIpcCommunication::SetLastError(const QString &error) {
+  {
+    QMutexLocker locker(&error_mutex_);
+    last_error_ = error;
+  }
+  emit errorOccurred(error);
+}
+
+IpcClientHandle
+StreamIpcCommunication::RegisterClient(const QString &client_id) {
+  QMutexLocker locker(&directory_mutex_);
+  quint32 slot = 0;
+  if (!free_slots_.empty()) {
+    slot = free_slots_.back();
+    free_slots_.pop_back();
+  } else if (client_slots_.size() <= kIpcHandleSlotMask) {
+    slot = static_cast<quint32>(client_slots_.size());
+    client_slots_.emplace_back();
+  } else {
+    return 0; // 槽位耗尽
+  }
+
+  ClientSlot &entry = client_slots_[slot];
+  ++entry.generation;
+  entry.handle = makeIpcClientHandle(slot, entry.generation);
+  entry.internal_id = client_id;
+  entry.logical_id.clear();
+  handle_by_internal_id_.insert(client_id, entry.handle);
+  return entry.handle;
+}
+
+void StreamIpcCommunication::RemoveClient(IpcClientHandle handle) {
+  QMutexLocker locker(&directory_mutex_);
+  ClientSlot *entry = FindSlot(handle);
+  if (!entry) {
+    return;
+  }
+  handle_by_internal_id_.remove(entry->internal_id);
+
+  // 清理ID映射（逻辑ID可能已被同名的新连接占用）
+  if (!entry->logical_id.isEmpty()) {
+    auto it = handle_by_logical_id_.find(entry->logical_id);
+    if (it != handle_by_logical_id_.end() && it.value() == handle) {
+      handle_by_logical_id_.erase(it);
+      logical_ids_version_.fetch_add(1, std::memory_order_release);
+    }
+    qDebug() << "[StreamIpcCommunication] 清理ID映射: " << entry->logical_id
+             << "->" << entry->internal_id;
+  }
+
+  // 按反向索引只清理该客户端自己的订阅
+  if (topic_subscriptions_.removeSubscriber(handle) > 0) {
+    topic_routes_.clear();
+  }
+
+  entry->handle = 0;
+  entry->internal_id.clear();
+  entry->logical_id.clear();
+  free_slots_.push_back(ipcHandleSlot(handle));
+}
+
+bool StreamIpcCommunication::establishIdMapping(IpcClientHandle handle,
+                                                const IpcMessage &message) {
+  if (message.sender_id.isEmpty()) {
+    return false;
+  }
+  QMutexLocker locker(&directory_mutex_);
+  ClientSlot *entry = FindSlot(handle);
+  if (!entry || handle_by_logical_id_.contains(message.sender_id)) {
+    return false;
+  }
+  qDebug() << "[StreamIpcCommunication] 建立新的ID映射: " << message.sender_id
+           << "->" << entry->internal_id;
+  handle_by_logical_id_.insert(message.sender_id, handle);
+  entry->logical_id = message.sender_id;
+  logical_ids_version_.fetch_add(1, std::memory_order_release);
+  return true;
+}
+
+bool StreamIpcCommunication::handleSubscriptionMessage(
+    IpcClientHandle handle, const IpcMessage &message) {
+  // 这个函数只处理订阅和取消订阅消息，订阅关系以连接句柄记录
+  const QString topic = message.body.value("topic").toString();
+  if (topic.isEmpty() || handle == 0) {
+    return false;
+  }
+
+  QMutexLocker locker(&directory_mutex_);
+  if (message.topic == "subscribe_topic") {
+    if (!TopicTrie::isValidPattern(topic)) {
+      qWarning() << "[StreamIpcCommunication] 客户端 '" << message.sender_id
+                 << "' 订阅模式非法:" << topic;
+      return false;
+    }
+    if (!topic_subscriptions_.subscribe(topic, handle)) {
+      return false;
+    }
+    topic_routes_.clear();
+    qDebug() << "[StreamIpcCommunication] 客户端 '" << message.sender_id
+             << "' 订阅Topic:" << topic;
+    return true;
+  }
+
+  if (!topic_subscriptions_.unsubscribe(topic, handle)) {
+    return false;
+  }
+  topic_routes_.clear();
+  qDebug() << "[StreamIpcCommunication] 客户端 '" << message.sender_id
+           << "' 取消订阅Topic:" << topic;
+  return true;
+}
+
+StreamIpcCommunication::ClientSlot *
+StreamIpcCommunication::FindSlot(IpcClientHandle handle) {
+  const quint32 slot = ipcHandleSlot(handle);
+  if (slot == 0 || slot >= client_slots_.size() ||
+      client_slots_[slot].handle != handle) {
+    return nullptr;
+  }
+  return &client_slots_[slot];
+}
+
+const StreamIpcCommunication::ClientSlot *
+StreamIpcCommunication::FindSlot(IpcClientHandle handle) const {
+  return const_cast<StreamIpcCommunication *>(this)->FindSlot(handle);
+}
+
+void StreamIpcCommunication::PostInbound(IpcInboundEvent event) {
+  // 连接事件和控制消息走控制通道，日志与状态上报走批量通道
+  if (event.kind == IpcInboundEvent::Kind::kMessage &&
+      outbound_config_.laneFor(event.message) == IpcLane::kBulk) {
+    inbound_bulk_queue_.push(std::move(event));
+  } else {
+    inbound_queue_.push(std::move(event));
+  }
+  if (!inbound_drain_scheduled_.exchange(true)) {
+    QMetaObject::invokeMethod(this, &StreamIpcCommunication::DrainInbound,
+                              Qt::QueuedConnection);
+  }
+}
+
+void StreamIpcCommunication::DrainInbound() {
+  inbound_drain_scheduled_.store(false);
+
+  // 每派发一个事件前都先看控制通道，批量消息积压时控制消息仍能立即插队
+  IpcInboundEvent event;
+  int processed = 0;
+  while (processed < kMaxInboundEventsPerDrain &&
+         (inbound_queue_.tryPop(&event) ||
+          inbound_bulk_queue_.tryPop(&event))) {
+    ++processed;
+    switch (event.kind) {
+    case IpcInboundEvent::Kind::kMessage:
+      emit messageReceived(event.message);
+      break;
+    case IpcInboundEvent::Kind::kClientConnected:
+      emit clientConnected(event.client_id);
+      break;
+    case IpcInboundEvent::Kind::kClientDisconnected:
+      emit clientDisconnected(event.client_id);
+      break;
+    case IpcInboundEvent::Kind::kError:
+      SetLastError(event.text);
+      break;
+    case IpcInboundEvent::Kind::kTopicSubscription:
+      emit topicSubscriptionChanged(event.text, event.subscribed);
+      break;
+    }
+  }
+
+  // 未处理完的事件留到下一轮事件循环，让出GUI线程
+  if (processed == kMaxInboundEventsPerDrain &&
+      !inbound_drain_scheduled_.exchange(true)) {
+    QMetaObject::invokeMethod(this, &StreamIpcCommunication::DrainInbound,
+                              Qt::QueuedConnection);
+  }
+}
+
+bool StreamIpcCommunication::PostOutbound(IpcOutboundCommand command) {
+  QReadLocker locker(&reactor_lock_);
+  if (!reactor_running_) {
+    locker.unlock();
+    SetLastError("发送消息失败: 服务器未启动");
+    return false;
+  }
+
+  outbound_queue_.push(std::move(command));
+  if (!outbound_drain_scheduled_.exchange(true)) {
+    WakeReactor();
+  }
+  return true;
+}
+
+// ================== IpcReactorProtocol 实现 ==================
+
+IpcReactorProtocol::IpcReactorProtocol(StreamIpcCommunication *owner,
+                                       const char *log_tag)
+    : owner_(owner), admission_(&owner->admission_config_),
+      log_tag_(log_tag) {}
+
+IpcReactorProtocol::~IpcReactorProtocol() = default;
+
+void IpcReactorProtocol::InsertConnection(
+    std::unique_ptr<ProtocolConnection> connection) {
+  const quint32 slot = ipcHandleSlot(connection->handle);
+  if (connections_.size() <= slot) {
+    connections_.resize(slot + 1);
+  }
+  connections_[slot] = std::move(connection);
+  ++connection_count_;
+  ++pending_handshakes_;
+  // clientConnected 在收到kHello后才发出，见CompleteHandshake
+}
+
+std::unique_ptr<IpcReactorProtocol::ProtocolConnection>
+IpcReactorProtocol::TakeConnection(ProtocolConnection *connection) {
+  const quint32 slot = ipcHandleSlot(connection->handle);
+  if (slot >= connections_.size() || connections_[slot].get() != connection)
+    return nullptr;
+
+  owner_->RemoveClient(connection->handle);
+  if (!connection->handshaken) {
+    --pending_handshakes_;
+  }
+  closed_dropped_messages_ += connection->outbound.droppedMessages();
+  closed_coalesced_messages_ += connection->outbound.coalescedMessages();
+  for (const RelayRoute &route : std::as_const(connection->relay_routes)) {
+    closed_relay_totals_.messages += route.messages;
+    closed_relay_totals_.bytes += route.bytes;
+    closed_relay_totals_.reencoded += route.reencoded;
+    closed_relay_totals_.dropped += route.dropped;
+  }
+  --connection_count_;
+  return std::move(connections_[slot]);
+}
+
+void IpcReactorProtocol::ClearConnections() {
+  connections_.clear();
+  connection_count_ = 0;
+  pending_handshakes_ = 0;
+}
+
+IpcReactorProtocol::ProtocolConnection *
+IpcReactorProtocol::FindConnection(IpcClientHandle handle) const {
+  const quint32 slot = ipcHandleSlot(handle);
+  if (handle == 0 || slot >= connections_.size() || !connections_[slot] ||
+      connections_[slot]->handle != handle) {
+    return nullptr;
+  }
+  return connections_[slot].get();
+}
+
+bool IpcReactorProtocol::DispatchFrames(ProtocolConnection *connection,
+                                        IpcReceiveBuffer *buffer) {
+  const QString client_id = connection->client_id;
+  const QByteArrayView pending = buffer->readable();
+  // 任何入站数据都视为心跳，有业务流量的插件无需另发心跳
+  if (connection->liveness) {
+    connection->liveness->touch();
+  }
+  qsizetype offset = 0;
+  bool violated = false;
+  while (offset < pending.size()) {
+    // 跳过帧间的门铃字节
+    if (static_cast<quint8>(pending.at(offset)) ==
+        SharedMemoryChannel::kDoorbellByte) {
+      ++offset;
+      continue;
+    }
+
+    // 紧凑心跳帧在完整解码之前分流，直接应答
+    if (IpcFrameCodec::isHeartbeatFrame(pending.sliced(offset))) {
+      IpcFrameCodec::Heartbeat heartbeat;
+      qsizetype consumed = 0;
+      const IpcFrameCodec::DecodeStatus status = IpcFrameCodec::decodeHeartbeat(
+          pending.sliced(offset), &heartbeat, &consumed);
+      if (status == IpcFrameCodec::DecodeStatus::kNeedMoreData) {
+        break;
+      }
+      offset += consumed;
+      if (status != IpcFrameCodec::DecodeStatus::kOk) {
+        continue;
+      }
+      if (!connection->handshaken) {
+        violated = true; // 握手前不接受心跳
+        break;
+      }
+      if (!heartbeat.ack) {
+        ReplyHeartbeat(connection, heartbeat);
+      }
+      continue;
+    }
+
+    IpcMessage message;
+    qsizetype consumed = 0;
+    const IpcFrameCodec::DecodeStatus status = IpcFrameCodec::decode(
+        pending.sliced(offset), &message, &consumed);
+    if (status == IpcFrameCodec::DecodeStatus::kNeedMoreData) {
+      break;
+    }
+    const QByteArrayView frame = pending.sliced(offset, consumed);
+    offset += consumed;
+    if (status != IpcFrameCodec::DecodeStatus::kOk) {
+      continue;
+    }
+
+    // 握手完成前只接受kHello：未认证的连接不能占用逻辑ID、订阅Topic或下发命令
+    if (!connection->handshaken && message.type != MessageType::kHello) {
+      violated = true;
+      break;
+    }
+
+    // 建立ID映射，成功后该连接的后续消息不再查表
+    if (!connection->id_mapped) {
+      connection->id_mapped =
+          owner_->establishIdMapping(connection->handle, message);
+    }
+
+    // 握手阶段协商该连接的编码和传输方式
+    if (message.type == MessageType::kHello) {
+      connection->negotiated_codec =
+          IpcFrameCodec::negotiate(message.body.value("codecs").toArray());
+      connection->compact_heartbeat =
+          message.body.value("heartbeat").toString() == QLatin1String("compact");
+      connection->sender_id = message.sender_id;
+      if (owner_->liveness_table_ && !message.sender_id.isEmpty()) {
+        connection->liveness = owner_->liveness_table_->acquire(message.sender_id);
+      }
+      NegotiateTransport(connection, message);
+      qDebug() << log_tag_ << "客户端" << message.sender_id << "协商编码:"
+               << IpcFrameCodec::codecName(connection->negotiated_codec);
+    }
+
+    // 处理订阅和取消订阅消息
+    if (message.type == MessageType::kCommand &&
+        (message.topic == "subscribe_topic" ||
+         message.topic == "unsubscribe_topic")) {
+      if (owner_->handleSubscriptionMessage(connection->handle, message)) {
+        IpcInboundEvent event;
+        event.kind = IpcInboundEvent::Kind::kTopicSubscription;
+        event.client_id = client_id;
+        event.text = message.body.value("topic").toString();
+        event.subscribed = (message.topic == "subscribe_topic");
+        owner_->PostInbound(std::move(event));
+      }
+    }
+
+    // 发给其他插件的消息直接转发，不经过主线程
+    if (RelayFrame(connection, message, frame)) {
+      continue;
+    }
+
+    // 未协商紧凑心跳的插件仍发送kHeartbeat消息，同样在本线程应答
+    if (message.type == MessageType::kHeartbeat && connection->handshaken) {
+      ++message_heartbeats_;
+      const IpcMessage ack = StreamIpcCommunication::HeartbeatAckFor(message);
+      EncodedFrames frames(ack);
+      WriteMessage(connection, &frames);
+      NoteHeartbeat(connection);
+      continue;
+    }
+
+    const bool is_hello = message.type == MessageType::kHello;
+    IpcInboundEvent event;
+    event.kind = IpcInboundEvent::Kind::kMessage;
+    event.client_id = client_id;
+    event.message = std::move(message);
+    owner_->PostInbound(std::move(event)); // 其余消息都投递到主线程
+
+    // 排在kHello之后通知连接，主线程先应答kHelloAck再下发配置
+    if (is_hello && !connection->handshaken) {
+      CompleteHandshake(connection);
+    }
+  }
+  buffer->consume(offset);
+  if (violated) {
+    admission_.recordHandshakeViolation();
+    return false;
+  }
+  return true;
+}
+
+void IpcReactorProtocol::ReplyHeartbeat(
+    ProtocolConnection *connection, const IpcFrameCodec::Heartbeat &heartbeat) {
+  ++compact_heartbeats_;
+  // 回显序号与时间戳，插件据此计算往返时延
+  IpcFrameCodec::Heartbeat ack = heartbeat;
+  ack.ack = true;
+  EnqueueFrame(connection, IpcFrameCodec::encodeHeartbeat(ack),
+               StreamIpcCommunication::CompactHeartbeatEnvelope());
+  NoteHeartbeat(connection);
+}
+
+void IpcReactorProtocol::NoteHeartbeat(ProtocolConnection *connection) {
+  // 每条连接只把首个心跳转交主线程，供启动流程按first_heartbeat判定就绪
+  if (connection->first_heartbeat_posted) {
+    return;
+  }
+  connection->first_heartbeat_posted = true;
+  IpcInboundEvent event;
+  event.kind = IpcInboundEvent::Kind::kMessage;
+  event.client_id = connection->client_id;
+  event.message =
+      StreamIpcCommunication::FirstHeartbeatNotice(connection->sender_id);
+  owner_->PostInbound(std::move(event));
+}
+
+void IpcReactorProtocol::CompleteHandshake(ProtocolConnection *connection) {
+  connection->handshaken = true;
+  --pending_handshakes_;
+
+  IpcInboundEvent event;
+  event.kind = IpcInboundEvent::Kind::kClientConnected;
+  event.client_id = connection->client_id;
+  owner_->PostInbound(std::move(event));
+}
+
+void IpcReactorProtocol::ReapHandshakes() {
+  const qint64 now = admission_.nowMs();
+  std::vector<IpcClientHandle> expired;
+  for (const auto &connection : connections_) {
+    if (connection && !connection->handshaken &&
+        admission_.handshakeExpired(connection->accepted_at_ms, now)) {
+      expired.push_back(connection->handle);
+    }
+  }
+  for (IpcClientHandle handle : expired) {
+    if (ProtocolConnection *connection = FindConnection(handle)) {
+      admission_.recordHandshakeTimeout();
+      DropConnection(connection, "握手超时");
+    }
+  }
+}
+
+const QByteArray &
+IpcReactorProtocol::EncodedFrames::frame(IpcCodecType codec) {
+  QByteArray &cached = codec == IpcCodecType::kCbor ? cbor : json;
+  if (cached.isEmpty()) {
+    cached = IpcFrameCodec::encode(message, codec);
+  }
+  return cached;
+}
+
+bool IpcReactorProtocol::WriteMessage(ProtocolConnection *connection,
+                                      EncodedFrames *frames) {
+  const IpcMessage &message = frames->message;
+  if (!IsWritable(connection)) {
+    PostError(connection->client_id,
+              QString("发送消息失败: 客户端 '%1' 连接状态异常")
+                  .arg(message.receiver_id));
+    return false;
+  }
+
+  QByteArray block;
+  if (message.type == MessageType::kHelloAck) {
+    // kHelloAck 总以JSON发出并携带协商结果，之后该连接改用协商的编码
+    IpcMessage ack = message;
+    ack.body["codec"] = IpcFrameCodec::codecName(connection->negotiated_codec);
+    ack.body["client_handle"] = static_cast<qint64>(connection->handle);
+    if (connection->compact_heartbeat) {
+      ack.body["heartbeat"] = QStringLiteral("compact");
+    }
+    PrepareHelloAck(connection, &ack);
+    block = IpcFrameCodec::encode(ack, IpcCodecType::kJson);
+    connection->codec = connection->negotiated_codec;
+  } else {
+    block = frames->frame(connection->codec);
+  }
+  return EnqueueFrame(connection, block, message);
+}
+
+bool IpcReactorProtocol::EnqueueFrame(ProtocolConnection *connection,
+                                      const QByteArray &block,
+                                      const IpcMessage &message) {
+  // 先进入连接的有界出站队列，传输层积压低于低水位时才交给传输层；
+  // 真正的写出在本轮事件处理结束时按连接合并进行
+  const bool was_congested = connection->outbound.isCongested();
+  const bool accepted =
+      connection->outbound.enqueue(block, message, InFlightBytes(connection));
+  if (!was_congested && connection->outbound.isCongested()) {
+    qWarning() << log_tag_ << "客户端" << connection->client_id
+               << "出站积压超过高水位，开始丢弃可丢弃消息";
+  }
+  PumpConnection(connection);
+  return accepted;
+}
+
+IpcReactorProtocol::RelayRoute *
+IpcReactorProtocol::ResolveRelayRoute(ProtocolConnection *source,
+                                      const QString &receiver_id) {
+  // 逻辑ID映射变化后，已缓存的目标句柄全部重新解析（计数保留）
+  const quint64 version =
+      owner_->logical_ids_version_.load(std::memory_order_acquire);
+  if (source->relay_routes_version != version) {
+    for (RelayRoute &route : source->relay_routes) {
+      route.resolved = false;
+    }
+    source->relay_routes_version = version;
+  }
+
+  auto it = source->relay_routes.find(receiver_id);
+  if (it == source->relay_routes.end()) {
+    if (source->relay_routes.size() >= kMaxRelayRoutesPerConnection) {
+      source->relay_routes.removeIf(
+          [](const auto &entry) { return entry.value().messages == 0; });
+    }
+    it = source->relay_routes.insert(receiver_id, RelayRoute());
+  }
+  if (!it->resolved) {
+    QMutexLocker locker(&owner_->directory_mutex_);
+    it->target = owner_->handle_by_logical_id_.value(receiver_id, 0);
+    it->resolved = true;
+  }
+  return it->target != 0 ? &it.value() : nullptr;
+}
+
+bool IpcReactorProtocol::RelayFrame(ProtocolConnection *source,
+                                    const IpcMessage &message,
+                                    QByteArrayView frame) {
+  // 未握手的连接不能向其他插件注入帧
+  if (!owner_->relay_enabled_ || !source->handshaken ||
+      message.receiver_id.isEmpty() || message.type == MessageType::kHello) {
+    return false;
+  }
+  RelayRoute *route = ResolveRelayRoute(source, message.receiver_id);
+  if (!route) {
+    return false;
+  }
+  ProtocolConnection *target = FindConnection(route->target);
+  if (!target || target == source || !target->handshaken ||
+      !IsWritable(target)) {
+    return false;
+  }
+
+  // 来帧与接收方当前编码一致时原样转发，否则按接收方编码重新编码
+  const IpcCodecType frame_codec =
+      static_cast<quint8>(frame.at(0)) == IpcFrameCodec::kFrameMagic
+          ? IpcCodecType::kCbor
+          : IpcCodecType::kJson;
+  QByteArray block;
+  if (frame_codec == target->codec) {
+    block = frame.toByteArray();
+  } else {
+    block = IpcFrameCodec::encode(message, target->codec);
+    ++route->reencoded;
+  }
+
+  ++route->messages;
+  route->bytes += block.size();
+  if (!EnqueueFrame(target, block, message)) {
+    ++route->dropped;
+  }
+  return true;
+}
+
+void IpcReactorProtocol::PostError(const QString &client_id,
+                                   const QString &text) {
+  IpcInboundEvent event;
+  event.kind = IpcInboundEvent::Kind::kError;
+  event.client_id = client_id;
+  event.text = text;
+  owner_->PostInbound(std::move(event));
+}
+
+QString
+IpcReactorProtocol::DisplayName(const ProtocolConnection *connection) const {
+  QMutexLocker locker(&owner_->directory_mutex_);
+  const StreamIpcCommunication::ClientSlot *slot =
+      owner_->FindSlot(connection->handle);
+  return slot && !slot->logical_id.isEmpty() ? slot->logical_id
+                                             : connection->client_id;
+}
+
+QJsonObject IpcReactorProtocol::RelayStatistics() const {
+  RelayRoute totals = closed_relay_totals_;
+  QJsonArray routes;
+  for (const auto &connection : connections_) {
+    if (!connection || connection->relay_routes.isEmpty())
+      continue;
+    const QString name = DisplayName(connection.get());
+    for (auto it = connection->relay_routes.constBegin();
+         it != connection->relay_routes.constEnd(); ++it) {
+      const RelayRoute &route = it.value();
+      if (route.messages == 0)
+        continue;
+      totals.messages += route.messages;
+      totals.bytes += route.bytes;
+      totals.reencoded += route.reencoded;
+      totals.dropped += route.dropped;
+      routes.append(QJsonObject{
+          {"from", name},
+          {"to", it.key()},
+          {"messages", static_cast<qint64>(route.messages)},
+          {"bytes", static_cast<qint64>(route.bytes)},
+          {"reencoded", static_cast<qint64>(route.reencoded)},
+          {"dropped", static_cast<qint64>(route.dropped)}});
+    }
+  }
+
+  QJsonObject relay;
+  relay["enabled"] = owner_->relay_enabled_;
+  relay["messages"] = static_cast<qint64>(totals.messages);
+  relay["bytes"] = static_cast<qint64>(totals.bytes);
+  relay["reencoded"] = static_cast<qint64>(totals.reencoded);
+  relay["dropped"] = static_cast<qint64>(totals.dropped);
+  relay["routes"] = routes;
+  return relay;
+}
+
+QJsonObject IpcReactorProtocol::HeartbeatStatistics() const {
+  return QJsonObject{{"compact", static_cast<qint64>(compact_heartbeats_)},
+                     {"message", static_cast<qint64>(message_heartbeats_)}};
+}
+
+void IpcReactorProtocol::NegotiateTransport(ProtocolConnection *,
+                                            const IpcMessage &) {}
+
+void IpcReactorProtocol::PrepareHelloAck(ProtocolConnection *, IpcMessage *) {}
+
+// ================== StreamIpcReactor 实现 ==================
+
+StreamIpcReactor::StreamIpcReactor(StreamIpcCommunication *owner)
+    : QObject(nullptr), IpcReactorProtocol(owner, "[StreamIpcCommunication]") {}
+
+StreamIpcReactor::~StreamIpcReactor() { shutdown(); }
+
+bool StreamIpcReactor::listen(QString *error) {
+  server_ = owner_->createServer();
+  connect(server_.get(), &IpcStreamServer::newConnection, this,
+          &StreamIpcReactor::newConnection);
+  connect(server_.get(), &IpcStreamServer::socketDisconnected, this,
+          &StreamIpcReactor::socketDisconnected);
+  connect(server_.get(), &IpcStreamServer::socketError, this,
+          &StreamIpcReactor::socketError);
+
+  if (!server_->listen(error)) {
+    server_.reset();
+    return false;
+  }
+  shutting_down_ = false;
+
+  if (const int interval = admission_.reapIntervalMs(); interval > 0) {
+    handshake_timer_ = new QTimer(this);
+    connect(handshake_timer_, &QTimer::timeout, this,
+            &StreamIpcReactor::reapHandshakes);
+    handshake_timer_->start(interval);
+  }
+  return true;
+}
+
+QString StreamIpcReactor::serverName() const {
+  return server_ ? server_->serverName() : QString();
+}
+
+void StreamIpcReactor::shutdown() {
+  shutting_down_ = true;
+  if (!server_)
+    return;
+
+  // 停止监听
+  server_->close();
+  if (handshake_timer_) {
+    handshake_timer_->stop();
+  }
+
+  // 断开所有客户端连接
+  for (auto &entry : connections_) {
+    Connection *connection = static_cast<Connection *>(entry.get());
+    QIODevice *socket = connection ? connection->socket.get() : nullptr;
+    if (!socket)
+      continue;
+    QObject::disconnect(socket, nullptr, this, nullptr);
+    if (server_->isConnected(socket)) {
+      server_->disconnectSocket(socket);
+    }
+    // 不等待，直接中断以避免阻塞
+    server_->abortSocket(socket);
+  }
+  socket_index_.clear();
+  ClearConnections();
+  dirty_connections_.clear();
+  server_.reset();
+}
+
+void StreamIpcReactor::drainOutbound() {
+  owner_->outbound_drain_scheduled_.store(false);
+
+  IpcOutboundCommand command;
+  while (owner_->outbound_queue_.tryPop(&command)) {
+    // 同一条消息对每种编码只序列化一次，所有接收者共享同一个隐式共享的帧
+    EncodedFrames frames(command.message);
+    switch (command.kind) {
+    case IpcOutboundCommand::Kind::kUnicast:
+    case IpcOutboundCommand::Kind::kMulticast:
+      for (IpcClientHandle handle : std::as_const(command.handles)) {
+        Connection *connection = FindConnection(handle);
+        if (!connection) {
+          PostError(QString(), QString("发送消息失败: 接收者 '%1' 已断开")
+                                   .arg(command.message.receiver_id));
+          continue;
+        }
+        WriteMessage(connection, &frames);
+      }
+      break;
+    case IpcOutboundCommand::Kind::kBroadcast:
+      // 广播只发给已握手的连接，主线程从未获知其余连接
+      for (auto &connection : connections_) {
+        if (connection && connection->handshaken) {
+          WriteMessage(connection.get(), &frames);
+        }
+      }
+      break;
+    case IpcOutboundCommand::Kind::kDisconnect:
+      for (IpcClientHandle handle : std::as_const(command.handles)) {
+        if (Connection *connection = FindConnection(handle)) {
+          server_->disconnectSocket(connection->socket.get());
+        }
+      }
+      break;
+    }
+  }
+
+  FlushPendingWrites();
+}
+
+void StreamIpcReactor::newConnection() {
+  while (QIODevice *client_socket = server_->nextPendingConnection()) {
+    // 准入控制：连接数上限与接受速率，拒绝的连接不登记、不通知主线程
+    const IpcAdmissionControl::Decision decision =
+        admission_.admit(connection_count_);
+    if (decision != IpcAdmissionControl::Decision::kAccept) {
+      qWarning() << "[StreamIpcCommunication] 拒绝连接:"
+                 << (decision == IpcAdmissionControl::Decision::kRejectCapacity
+                         ? "连接数已达上限"
+                         : "接受速率超限");
+      server_->abortSocket(client_socket);
+      client_socket->deleteLater();
+      continue;
+    }
+
+    auto connection = std::make_unique<Connection>(&owner_->outbound_config_);
+    connection->client_id = QUuid::createUuid().toString(
+        QUuid::WithoutBraces); // 为每个客户端生成唯一ID
+    connection->socket.reset(client_socket);
+    connection->accepted_at_ms = admission_.nowMs();
+
+    const QString client_id = connection->client_id;
+    connection->handle = owner_->RegisterClient(client_id);
+    if (connection->handle == 0) {
+      qWarning() << "[StreamIpcCommunication] 连接句柄已耗尽，拒绝连接";
+      server_->abortSocket(connection->socket.release());
+      client_socket->deleteLater();
+      continue;
+    }
+    qDebug() << "[StreamIpcCommunication] 新的IPC连接:" << client_id
+             << "句柄:" << connection->handle;
+
+    connect(client_socket, &QIODevice::readyRead, this,
+            &StreamIpcReactor::readyRead);
+    connect(client_socket, &QIODevice::bytesWritten, this,
+            &StreamIpcReactor::socketBytesWritten);
+
+    socket_index_.insert(client_socket, connection.get());
+    InsertConnection(std::move(connection));
+  }
+}
+
+void StreamIpcReactor::socketDisconnected(QIODevice *socket) {
+  if (shutting_down_)
+    return;
+  Connection *connection = FindConnection(socket);
+  if (!connection)
+    return;
+
+  const QString client_id = connection->client_id;
+  const bool handshaken = connection->handshaken;
+  qDebug() << "[StreamIpcCommunication] IPC连接断开:" << client_id;
+  ReleaseConnection(connection);
+
+  // 主线程从未获知未握手的连接，断开时也不通知
+  if (!handshaken)
+    return;
+  IpcInboundEvent event;
+  event.kind = IpcInboundEvent::Kind::kClientDisconnected;
+  event.client_id = client_id;
+  owner_->PostInbound(std::move(event));
+}
+
+void StreamIpcReactor::readyRead() {
+  if (shutting_down_)
+    return;
+  Connection *connection =
+      FindConnection(qobject_cast<QIODevice *>(sender()));
+  if (!connection)
+    return;
+
+  // 直接读入连接缓冲区，随后在同一块内存上逐帧解码，最后一次性前移读游标
+  if (connection->receive_buffer.readFrom(connection->socket.get()) > 0 &&
+      !DispatchFrames(connection, &connection->receive_buffer)) {
+    DropConnection(connection, "握手完成前收到kHello以外的帧");
+    FlushPendingWrites();
+    return;
+  }
+
+  // 握手前只允许少量数据，防止未认证的连接占用大块内存
+  if (!connection->handshaken &&
+      connection->receive_buffer.size() >
+          IpcAdmissionControl::kMaxHandshakeBytes) {
+    admission_.recordHandshakeOverflow();
+    DropConnection(connection, "握手前数据超出上限");
+    FlushPendingWrites();
+    return;
+  }
+
+  // 升级到共享内存的连接，socket上的门铃字节表示环中有新数据或腾出了空间
+  if (connection->shm && connection->socket) {
+    ServiceSharedMemory(connection);
+  }
+
+  // 转发给其他插件的帧和门铃字节在本轮读取结束时一并flush
+  FlushPendingWrites();
+}
+
+void StreamIpcReactor::reapHandshakes() {
+  if (shutting_down_ || pending_handshakes_ == 0)
+    return;
+  ReapHandshakes();
+}
+
+void StreamIpcReactor::DropConnection(ProtocolConnection *base,
+                                      const QString &reason) {
+  Connection *connection = static_cast<Connection *>(base);
+  const QString client_id = connection->client_id;
+  const bool handshaken = connection->handshaken;
+  QIODevice *socket = connection->socket.get();
+  qWarning() << "[StreamIpcCommunication] 断开客户端" << client_id << ":"
+             << reason;
+
+  ReleaseConnection(connection);
+  // ReleaseConnection已解除信号连接并deleteLater，socket在本轮事件循环内仍有效
+  server_->abortSocket(socket);
+
+  if (handshaken) {
+    IpcInboundEvent event;
+    event.kind = IpcInboundEvent::Kind::kClientDisconnected;
+    event.client_id = client_id;
+    owner_->PostInbound(std::move(event));
+  }
+}
+
+void StreamIpcReactor::socketError(QIODevice *socket,
+                                   const QString &error_message) {
+  if (shutting_down_)
+    return;
+  Connection *connection = FindConnection(socket);
+  if (!connection)
+    return;
+
+  const QString text = QString("Socket错误: %1").arg(error_message);
+  qWarning() << "[StreamIpcCommunication] 客户端 '" << connection->client_id
+             << "' 发生错误: " << text;
+  PostError(connection->client_id, text);
+}
+
+StreamIpcReactor::Connection *
+StreamIpcReactor::FindConnection(QIODevice *socket) const {
+  return socket ? socket_index_.value(socket, nullptr) : nullptr;
+}
+
+StreamIpcReactor::Connection *
+StreamIpcReactor::FindConnection(IpcClientHandle handle) const {
+  return static_cast<Connection *>(IpcReactorProtocol::FindConnection(handle));
+}
+
+void StreamIpcReactor::MarkDirty(Connection *connection) {
+  if (!connection->flush_pending) {
+    connection->flush_pending = true;
+    dirty_connections_.push_back(connection->handle);
+  }
+}
+
+void StreamIpcReactor::ReleaseConnection(Connection *connection) {
+  const std::unique_ptr<ProtocolConnection> released =
+      TakeConnection(connection);
+  if (!released)
+    return;
+
+  // 在socket自身的信号处理中，不能直接delete，交给事件循环释放
+  QIODevice *socket = connection->socket.release();
+  socket_index_.remove(socket);
+  QObject::disconnect(socket, nullptr, this, nullptr);
+  socket->deleteLater();
+}
+
+bool StreamIpcReactor::IsWritable(const ProtocolConnection *base) const {
+  const Connection *connection = static_cast<const Connection *>(base);
+  return connection->socket && server_->isConnected(connection->socket.get());
+}
+
+qint64 StreamIpcReactor::InFlightBytes(const ProtocolConnection *base) const {
+  const Connection *connection = static_cast<const Connection *>(base);
+  return connection->shm_active ? connection->shm->outbound().usedBytes() +
+                                      connection->shm_partial.size() -
+                                      connection->shm_partial_offset
+                                : connection->socket->bytesToWrite();
+}
+
+void StreamIpcReactor::NegotiateTransport(ProtocolConnection *base,
+                                          const IpcMessage &hello) {
+  Connection *connection = static_cast<Connection *>(base);
+  connection->wants_shm =
+      owner_->shm_config_.enabled &&
+      hello.body.value("transports").toArray().contains(QStringLiteral("shm"));
+}
+
+void StreamIpcReactor::PrepareHelloAck(ProtocolConnection *base,
+                                       IpcMessage *ack) {
+  // kHelloAck仍经socket发出，其中携带共享内存通道的描述
+  Connection *connection = static_cast<Connection *>(base);
+  if (connection->wants_shm && !connection->shm) {
+    UpgradeToSharedMemory(connection, ack);
+  }
+}
+
+void StreamIpcReactor::PumpConnection(ProtocolConnection *base) {
+  Connection *connection = static_cast<Connection *>(base);
+  if (connection->shm_active) {
+    PumpSharedMemory(connection);
+    return;
+  }
+
+  QIODevice *socket = connection->socket.get();
+  const qint64 bytes_written = connection->outbound.pump(socket);
+  if (bytes_written < 0) {
+    PostError(connection->client_id, QString("发送消息到 '%1' 失败: %2")
+                                         .arg(connection->client_id)
+                                         .arg(socket->errorString()));
+    return;
+  }
+  if (bytes_written > 0) {
+    MarkDirty(connection);
+  }
+
+  // 握手应答及之前排队的帧都交给socket后，后续数据改走共享内存环
+  if (connection->shm && connection->outbound.isEmpty()) {
+    connection->shm_active = true;
+    qDebug() << "[StreamIpcCommunication] 客户端" << connection->client_id
+             << "数据通道已切换到共享内存";
+  }
+}
+
+void StreamIpcReactor::UpgradeToSharedMemory(Connection *connection,
+                                             IpcMessage *ack) {
+  const QString key = QString("%1_shm_%2")
+                          .arg(server_->serverName(), connection->client_id);
+  QString error;
+  connection->shm = SharedMemoryChannel::create(
+      key, owner_->shm_config_.ring_bytes, &error);
+  if (!connection->shm) {
+    // 创建失败时该连接继续使用socket，插件据 transport 字段判断
+    qWarning() << "[StreamIpcCommunication] 创建共享内存通道失败，继续使用socket:"
+               << error;
+    ack->body["transport"] = "socket";
+    return;
+  }
+
+  ack->body["transport"] = "shm";
+  const QJsonObject description = connection->shm->describe();
+  for (auto it = description.constBegin(); it != description.constEnd(); ++it) {
+    ack->body[it.key()] = it.value();
+  }
+}
+
+void StreamIpcReactor::ServiceSharedMemory(Connection *connection) {
+  SharedMemoryRing &inbound = connection->shm->inbound();
+  // 每轮最多读出一个环的数据，分发后再读下一轮，接收缓冲不会无限增长
+  const qsizetype bytes_read =
+      inbound.readInto(&connection->shm_receive_buffer);
+  if (bytes_read < 0) {
+    DropConnection(connection, "共享内存环的写位置异常");
+    return;
+  }
+
+  // 插件因环满暂停写入时，读出数据后回送门铃
+  if (bytes_read > 0 && inbound.takeProducerWaiting()) {
+    RingDoorbell(connection);
+  }
+  if (!connection->shm_receive_buffer.isEmpty() &&
+      !DispatchFrames(connection, &connection->shm_receive_buffer)) {
+    DropConnection(connection, "握手完成前收到kHello以外的帧");
+    return;
+  }
+
+  // 插件仍在写入时交给事件循环安排下一轮，持续写入的插件不会独占I/O线程
+  if (inbound.prepareConsumerWait() && !connection->shm_read_scheduled) {
+    connection->shm_read_scheduled = true;
+    const IpcClientHandle handle = connection->handle;
+    QMetaObject::invokeMethod(
+        this,
+        [this, handle]() {
+          Connection *target = FindConnection(handle);
+          if (!target)
+            return;
+          target->shm_read_scheduled = false;
+          ServiceSharedMemory(target);
+          FlushPendingWrites();
+        },
+        Qt::QueuedConnection);
+  }
+
+  // 门铃也可能表示主控->插件方向腾出了空间
+  if (connection->shm_active) {
+    PumpSharedMemory(connection);
+  }
+}
+
+void StreamIpcReactor::PumpSharedMemory(Connection *connection) {
+  SharedMemoryRing &ring = connection->shm->outbound();
+  SharedMemoryFrameSink sink(&ring, &connection->shm_partial,
+                             &connection->shm_partial_offset);
+
+  // 写不下时先登记等待再复查一次，避免与插件的读出交错而丢失唤醒
+  bool armed = false;
+  for (;;) {
+    const qint64 before = sink.bytesWritten();
+    sink.flushPartial();
+    if (connection->outbound.pump(&sink) < 0) {
+      break;
+    }
+    if (connection->outbound.isEmpty() && connection->shm_partial.isEmpty()) {
+      break;
+    }
+    if (armed && sink.bytesWritten() == before) {
+      break;
+    }
+    ring.armProducerWait();
+    armed = true;
+  }
+
+  if (ring.isCorrupted()) {
+    ScheduleDrop(connection, "共享内存环的读位置异常");
+    return;
+  }
+  if (sink.bytesWritten() > 0 && ring.takeConsumerWaiting()) {
+    RingDoorbell(connection);
+  }
+}
+
+void StreamIpcReactor::ScheduleDrop(Connection *connection,
+                                    const QString &reason) {
+  // 写出可能发生在该连接或其他连接的帧分发过程中，回到事件循环后再断开
+  const IpcClientHandle handle = connection->handle;
+  QMetaObject::invokeMethod(
+      this,
+      [this, handle, reason]() {
+        if (Connection *target = FindConnection(handle)) {
+          DropConnection(target, reason);
+          FlushPendingWrites();
+        }
+      },
+      Qt::QueuedConnection);
+}
+
+void StreamIpcReactor::RingDoorbell(Connection *connection) {
+  static const QByteArray kDoorbell(1, static_cast<char>(
+                                           SharedMemoryChannel::kDoorbellByte));
+  if (connection->socket && server_->isConnected(connection->socket.get())) {
+    connection->socket->write(kDoorbell);
+    MarkDirty(connection);
+  }
+}
+
+void StreamIpcReactor::socketBytesWritten() {
+  if (shutting_down_)
+    return;
+  Connection *connection =
+      FindConnection(qobject_cast<QIODevice *>(sender()));
+  if (!connection || connection->outbound.isEmpty())
+    return;
+
+  // 发送缓冲回落后续写排队中的帧，交由事件循环异步写出
+  const bool was_congested = connection->outbound.isCongested();
+  PumpConnection(connection);
+  if (was_congested && !connection->outbound.isCongested()) {
+    qDebug() << "[StreamIpcCommunication] 客户端" << connection->client_id
+             << "出站积压已回落到低水位以下";
+  }
+}
+
+QJsonObject StreamIpcReactor::statistics() const {
+  quint64 dropped_total = closed_dropped_messages_;
+  quint64 coalesced_total = closed_coalesced_messages_;
+  qint64 queued_bytes_total = 0;
+  qint64 queued_messages_total = 0;
+  std::array<qint64, kIpcLaneCount> lane_messages_total{};
+  std::array<qint64, kIpcLaneCount> lane_bytes_total{};
+
+  QJsonObject clients;
+  for (const auto &entry : connections_) {
+    const Connection *connection = static_cast<const Connection *>(entry.get());
+    if (!connection)
+      continue;
+    const IpcOutboundQueue &queue = connection->outbound;
+    dropped_total += queue.droppedMessages();
+    coalesced_total += queue.coalescedMessages();
+    queued_bytes_total += queue.queuedBytes();
+    queued_messages_total += queue.queuedMessages();
+
+    QJsonObject client;
+    client["queued_messages"] = static_cast<qint64>(queue.queuedMessages());
+    client["queued_bytes"] = queue.queuedBytes();
+    client["socket_bytes_to_write"] =
+        connection->socket ? connection->socket->bytesToWrite() : 0;
+    client["peak_queued_bytes"] = queue.peakBytes();
+    client["dropped_messages"] = static_cast<qint64>(queue.droppedMessages());
+    client["coalesced_messages"] =
+        static_cast<qint64>(queue.coalescedMessages());
+    client["congested"] = queue.isCongested();
+
+    QJsonObject lanes;
+    for (int i = 0; i < kIpcLaneCount; ++i) {
+      const IpcLane lane = static_cast<IpcLane>(i);
+      lane_messages_total[i] += queue.queuedMessages(lane);
+      lane_bytes_total[i] += queue.queuedBytes(lane);
+      lanes[ipcLaneName(lane)] = QJsonObject{
+          {"queued_messages", static_cast<qint64>(queue.queuedMessages(lane))},
+          {"queued_bytes", queue.queuedBytes(lane)},
+          {"peak_queued_bytes", queue.peakBytes(lane)}};
+    }
+    client["lanes"] = lanes;
+    client["transport"] = connection->shm_active ? "shm" : "socket";
+    if (connection->shm) {
+      client["shm_ring_used_bytes"] =
+          static_cast<qint64>(connection->shm->outbound().usedBytes());
+    }
+
+    // 优先以逻辑ID展示，未握手的连接使用内部ID
+    client["handle"] = static_cast<qint64>(connection->handle);
+    clients[DisplayName(connection)] = client;
+  }
+
+  QJsonObject outbound;
+  outbound["high_water_bytes"] = owner_->outbound_config_.high_water_bytes;
+  outbound["low_water_bytes"] = owner_->outbound_config_.low_water_bytes;
+  outbound["bulk_budget_bytes"] = owner_->outbound_config_.bulk_budget_bytes;
+  outbound["queued_messages"] = queued_messages_total;
+  outbound["queued_bytes"] = queued_bytes_total;
+  outbound["dropped_messages"] = static_cast<qint64>(dropped_total);
+  outbound["coalesced_messages"] = static_cast<qint64>(coalesced_total);
+  QJsonObject lanes;
+  for (int i = 0; i < kIpcLaneCount; ++i) {
+    lanes[ipcLaneName(static_cast<IpcLane>(i))] = QJsonObject{
+        {"queued_messages", lane_messages_total[i]},
+        {"queued_bytes", lane_bytes_total[i]}};
+  }
+  outbound["lanes"] = lanes;
+  outbound["clients"] = clients;
+
+  QJsonObject admission = admission_.statistics();
+  admission["pending_handshakes"] = pending_handshakes_;
+
+  QJsonObject stats;
+  stats["connected_clients"] = connection_count_;
+  stats["outbound"] = outbound;
+  stats["relay"] = RelayStatistics();
+  stats["admission"] = admission;
+  stats["heartbeats"] = HeartbeatStatistics();
+  return stats;
+}
+
+void StreamIpcReactor::FlushPendingWrites() {
+  // 按句柄重新查找：drain过程中连接可能已被断开并释放。
+  // flush可能同步触发bytesWritten并再次登记，先换出当前列表
+  std::vector<IpcClientHandle> dirty;
+  dirty.swap(dirty_connections_);
+  for (IpcClientHandle handle : dirty) {
+    Connection *connection = FindConnection(handle);
+    if (!connection)
+      continue;
+    connection->flush_pending = false;
+    if (connection->socket) {
+      server_->flushSocket(connection->socket.get());
+    }
+  }
+}
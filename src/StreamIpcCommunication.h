@@ -0,0 +1,506 @@
+#ifndef MASTER_SRC_STREAMIPCCOMMUNICATION_H_
+#define MASTER_SRC_STREAMIPCCOMMUNICATION_H_
+
+#include "IIpcCommunication.h"
+#include "IpcAdmissionControl.h"
+#include "IpcFrameCodec.h"
+#include "IpcLivenessTable.h"
+#include "IpcOutboundQueue.h"
+#include "IpcReceiveBuffer.h"
+#include "IpcStreamServer.h"
+#include "SharedMemoryChannel.h"
+#include "TopicTrie.h"
+#include "LockFreeQueue.h"
+#include <QMap>
+#include <QHash>
+#include <QSet>
+#include <QThread>
+#include <QTimer>
+#include <QReadWriteLock>
+#include <memory>
+#include <QMutex>
+#include <map>
+#include <vector>
+#include <atomic>
+
+class StreamIpcReactor;
+
+/**
+ * @brief 连接句柄：低16位为槽位下标，高16位为槽位的复用代数，0表示无效
+ *
+ * 连接建立时分配，路由表以槽位下标直接索引；代数保证已断开连接的旧句柄
+ * 不会误投到复用同一槽位的新连接。字符串形式的ID只用于日志和对外接口。
+ */
+using IpcClientHandle = quint32;
+
+constexpr quint32 kIpcHandleSlotBits = 16;
+constexpr quint32 kIpcHandleSlotMask = (1u << kIpcHandleSlotBits) - 1;
+
+inline quint32 ipcHandleSlot(IpcClientHandle handle) {
+  return handle & kIpcHandleSlotMask;
+}
+
+inline IpcClientHandle makeIpcClientHandle(quint32 slot, quint16 generation) {
+  return (static_cast<quint32>(generation) << kIpcHandleSlotBits) | slot;
+}
+
+/**
+ * @brief I/O线程投递给主线程的事件
+ */
+struct IpcInboundEvent {
+  enum class Kind {
+    kMessage = 0,        // 收到消息
+    kClientConnected,    // 客户端连接
+    kClientDisconnected, // 客户端断开
+    kError,              // 发生错误
+    kTopicSubscription   // Topic订阅状态变化
+  };
+
+  Kind kind = Kind::kMessage;
+  QString client_id;     // 内部ID
+  IpcMessage message{};
+  QString text;          // 错误信息或Topic名称
+  bool subscribed = false;
+};
+
+/**
+ * @brief 主线程投递给I/O线程的发送命令
+ */
+struct IpcOutboundCommand {
+  enum class Kind {
+    kUnicast = 0,        // 发送给handles中的单个客户端
+    kMulticast,          // 发送给handles中的所有客户端
+    kBroadcast,          // 发送给所有已连接客户端
+    kDisconnect          // 断开handles中的客户端
+  };
+
+  Kind kind = Kind::kUnicast;
+  QList<IpcClientHandle> handles; // 目标连接句柄
+  IpcMessage message{};
+};
+
+/**
+ * @brief 基于字节流socket的IPC通信实现基类
+ *
+ * 该类实现了IIpcCommunication接口中与传输无关的全部语义：ID映射、Topic订阅、
+ * 编码协商、出站队列与统计。具体的服务端与socket由子类通过createServer()
+ * 提供（LocalSocketIpcCommunication、TcpSocketIpcCommunication）；
+ * EpollIpcCommunication则通过StartReactor()等替换整个I/O反应器。
+ *
+ * 线程模型：服务端、所有客户端socket以及帧的收发、解析都在独立的
+ * I/O线程（StreamIpcReactor）中完成。解析出的消息经无锁队列投递回本对象
+ * 所在线程后再发出信号；发送接口可在任意线程调用，消息经无锁队列交给
+ * I/O线程编码并写出。客户端目录（ID映射、订阅关系）由directory_mutex_保护，
+ * 供两侧线程查询。
+ *
+ * 插件之间的消息（receiver_id为另一个已连接插件的逻辑ID）在I/O线程直接转发：
+ * 接收方编码与来帧相同时原样转发帧字节，否则按接收方编码重新编码；
+ * 转发的消息不投递到主线程。由配置项 relay_enabled（默认开启）控制。
+ *
+ * 心跳在I/O线程直接应答：紧凑心跳帧与kHeartbeat消息都不投递到主线程；
+ * 设置了活跃度表时，连接上每次读到数据都记为该插件活跃。
+ */
+class StreamIpcCommunication : public IIpcCommunication {
+  Q_OBJECT
+
+public:
+  explicit StreamIpcCommunication(QObject* parent = nullptr);
+  ~StreamIpcCommunication() override;
+
+  bool start() override;
+  void stop() override;
+  ConnectionState getConnectionState() const override;
+  bool sendMessage(const IpcMessage& message) override;
+  bool sendMessage(const QString& client_id, const IpcMessage& message);
+  bool broadcastMessage(const IpcMessage& message) override;
+  bool publishToTopic(const QString& topic, const IpcMessage& message) override;
+  bool subscribeToTopic(const QString& topic) override;
+  bool unsubscribeFromTopic(const QString& topic) override;
+  QStringList getSubscribedTopics() const override;
+  int getConnectedClientCount() const override;
+  QStringList getConnectedClientIds() const override;
+  bool disconnectClient(const QString& client_id) override;
+  bool isClientOnline(const QString& client_id) const override;
+  QString getLastError() const override;
+  QString getClientIdBySenderId(const QString& sender_id) const override;
+  QJsonObject getStatistics() const override;
+  void setLivenessTable(std::shared_ptr<IpcLivenessTable> table) override;
+
+protected:
+  // 共享内存数据通道配置，默认关闭；SharedMemoryIpcCommunication在初始化时开启
+  SharedMemoryTransportConfig shm_config_;
+
+  /**
+   * @brief 读取传输无关的公共配置（出站队列水位、丢弃策略、插件间转发、连接准入）
+   * @param section 传输对应的配置段，如 ipc.local_socket
+   */
+  void initializeStream(const QJsonObject& section);
+
+  /**
+   * @brief 创建服务端，在I/O线程中调用
+   */
+  virtual std::unique_ptr<IpcStreamServer> createServer() const = 0;
+
+  /**
+   * @brief 子类初始化阶段设置连接状态与错误
+   */
+  void SetConnectionState(ConnectionState state);
+  void SetLastError(const QString& error);
+
+  /**
+   * @brief 启动I/O线程与反应器并开始监听
+   *
+   * 默认在独立QThread中运行StreamIpcReactor。子类可替换为其他反应器，
+   * 反应器通过友元访问客户端目录与跨线程队列，语义须与StreamIpcReactor一致。
+   * @param endpoint 监听成功后的服务端名称/地址
+   * @param error 失败时的错误信息
+   */
+  virtual bool StartReactor(QString* endpoint, QString* error);
+
+  /**
+   * @brief 关闭服务端、断开全部客户端并结束I/O线程（阻塞到完成）
+   */
+  virtual void StopReactor();
+
+  /**
+   * @brief 通知I/O线程处理outbound_queue_，在reactor_lock_读锁内调用
+   */
+  virtual void WakeReactor();
+
+  /**
+   * @brief 反应器侧统计（出站队列、转发等），在reactor_lock_读锁内调用
+   */
+  virtual QJsonObject ReactorStatistics() const;
+
+private:
+  friend class IpcReactorProtocol;
+  friend class StreamIpcReactor;
+  friend class EpollIpcReactor;
+
+  std::unique_ptr<QThread> io_thread_;
+  StreamIpcReactor* reactor_ = nullptr;  // 生存于io_thread_，线程结束时deleteLater
+  bool reactor_running_ = false;         // 反应器已启动，可以投递发送命令
+  mutable QReadWriteLock reactor_lock_;  // 保护reactor_running_，投递唤醒期间反应器不会被销毁
+
+  QString endpoint_;                        // 监听成功后的服务端名称/地址
+  IpcOutboundQueueConfig outbound_config_;  // 每连接出站队列的水位与丢弃策略
+  IpcAdmissionConfig admission_config_;     // 连接数上限、接受速率与握手超时
+  bool relay_enabled_ = true;               // 插件间消息在I/O线程直接转发
+  std::shared_ptr<IpcLivenessTable> liveness_table_; // start()前设置，此后只由I/O线程读取
+  ConnectionState connection_state_;
+  QString last_error_;
+  mutable QMutex error_mutex_;             // 保护last_error_
+
+  // ==================== 客户端目录（directory_mutex_保护） ====================
+  /**
+   * @brief 句柄槽位，handle为0表示空闲
+   */
+  struct ClientSlot {
+    IpcClientHandle handle = 0;
+    quint16 generation = 0;
+    QString internal_id;   // 内部UUID
+    QString logical_id;    // 握手后的逻辑ID
+  };
+
+  mutable QMutex directory_mutex_;
+  std::vector<ClientSlot> client_slots_ = std::vector<ClientSlot>(1); // 以槽位为下标，0号保留
+  std::vector<quint32> free_slots_;                          // 可复用的槽位
+  QHash<QString, IpcClientHandle> handle_by_internal_id_;    // 内部UUID -> 句柄
+  QHash<QString, IpcClientHandle> handle_by_logical_id_;     // 逻辑ID -> 句柄
+  TopicTrie topic_subscriptions_;                            // Topic订阅树，订阅者为句柄
+  QHash<QString, QList<IpcClientHandle>> topic_routes_;      // 发布路由缓存，订阅变化时清空
+  std::atomic<quint64> logical_ids_version_{0};              // 逻辑ID映射每次变化时递增，供转发路由缓存校验
+
+  //逻辑ID：是子进程生成的一个唯一ID，用于标识子进程
+  //内部ID：是Master生成的一个唯一ID，用于标识Master与子进程的连接的client的映射
+
+  // ==================== 跨线程队列 ====================
+  MpscQueue<IpcInboundEvent> inbound_queue_;      // I/O线程 -> 本线程（控制通道与连接事件）
+  MpscQueue<IpcInboundEvent> inbound_bulk_queue_; // I/O线程 -> 本线程（批量通道）
+  MpscQueue<IpcOutboundCommand> outbound_queue_;  // 任意线程 -> I/O线程
+  std::atomic_bool inbound_drain_scheduled_{false};
+  std::atomic_bool outbound_drain_scheduled_{false};
+
+  // 以下由I/O线程调用，维护客户端目录
+  IpcClientHandle RegisterClient(const QString& client_id);
+  void RemoveClient(IpcClientHandle handle);
+  bool establishIdMapping(IpcClientHandle handle, const IpcMessage& message);
+  bool handleSubscriptionMessage(IpcClientHandle handle, const IpcMessage& message);
+
+  // 以下要求调用方持有directory_mutex_
+  ClientSlot* FindSlot(IpcClientHandle handle);
+  const ClientSlot* FindSlot(IpcClientHandle handle) const;
+
+  bool PostToClient(IpcClientHandle handle, const IpcMessage& message);
+
+  /**
+   * @brief 传输层对kHeartbeat消息的应答（兼容未协商紧凑心跳的插件）
+   */
+  static IpcMessage HeartbeatAckFor(const IpcMessage& heartbeat);
+
+  /**
+   * @brief 紧凑心跳应答进入出站队列时使用的消息信封，只用于选择通道
+   */
+  static const IpcMessage& CompactHeartbeatEnvelope();
+
+  /**
+   * @brief 连接的首个心跳在应答后转交主线程的通知，body中acknowledged为true表示无需再应答
+   */
+  static IpcMessage FirstHeartbeatNotice(const QString& sender_id);
+
+  void PostInbound(IpcInboundEvent event);
+  void DrainInbound();
+  bool PostOutbound(IpcOutboundCommand command);
+};
+
+/**
+ * @brief I/O反应器共用的连接协议
+ *
+ * 握手、心跳应答、帧分发、出站入队与插件间转发在StreamIpcReactor和
+ * EpollIpcReactor中语义完全相同，集中在此实现。子类只负责各自的I/O：
+ * 接受连接、把读到的数据交给DispatchFrames，以及在PumpConnection中把
+ * 出站队列中的帧交给传输层。连接表与全部计数只在I/O线程访问。
+ */
+class IpcReactorProtocol {
+public:
+  IpcReactorProtocol(const IpcReactorProtocol&) = delete;
+  IpcReactorProtocol& operator=(const IpcReactorProtocol&) = delete;
+
+protected:
+  /**
+   * @brief 一条插件间转发路由及其计数
+   */
+  struct RelayRoute {
+    IpcClientHandle target = 0;   // 0表示接收者不是已连接的插件，交给主控处理
+    bool resolved = false;        // target已按当前逻辑ID映射解析
+    quint64 messages = 0;         // 转发的消息数
+    quint64 bytes = 0;            // 转发的字节数
+    quint64 reencoded = 0;        // 编码不同需要重新编码的消息数
+    quint64 dropped = 0;          // 因接收方拥塞被丢弃的消息数
+  };
+
+  /**
+   * @brief 连接上与传输无关的协议状态，子类在此之上附加socket、fd等I/O状态
+   */
+  struct ProtocolConnection {
+    explicit ProtocolConnection(const IpcOutboundQueueConfig* config) : outbound(config) {}
+    virtual ~ProtocolConnection() = default;
+
+    QString client_id;                        // 内部ID（日志与对外接口）
+    IpcClientHandle handle = 0;               // 连接句柄
+    bool id_mapped = false;                   // 已建立逻辑ID映射
+    bool handshaken = false;                  // 已收到kHello，主线程已获知该连接
+    qint64 accepted_at_ms = 0;                // 接受时间（admission_的单调时钟）
+    IpcReceiveBuffer receive_buffer;          // 接收缓冲区（原地切帧）
+    IpcCodecType codec = IpcCodecType::kJson; // 当前生效的发送编码
+    IpcCodecType negotiated_codec = IpcCodecType::kJson; // kHello协商结果
+    bool compact_heartbeat = false;           // 插件在kHello中声明支持紧凑心跳帧
+    std::shared_ptr<IpcLivenessTable::Entry> liveness; // 握手后取得的活跃度条目
+    QString sender_id;                        // kHello中的逻辑ID
+    bool first_heartbeat_posted = false;      // 首个心跳已通知主线程
+    IpcOutboundQueue outbound;                // 有界出站队列
+
+    // 插件间转发路由（以receiver_id为键），目标句柄在逻辑ID映射变化后重新解析
+    QHash<QString, RelayRoute> relay_routes;
+    quint64 relay_routes_version = 0;
+  };
+
+  /**
+   * @brief 一条待发送消息按编码缓存的帧，每种编码最多序列化一次
+   */
+  struct EncodedFrames {
+    explicit EncodedFrames(const IpcMessage& msg) : message(msg) {}
+    const QByteArray& frame(IpcCodecType codec);
+
+    const IpcMessage& message;
+    QByteArray json;
+    QByteArray cbor;
+  };
+
+  /**
+   * @param log_tag 日志前缀，如 "[StreamIpcCommunication]"
+   */
+  IpcReactorProtocol(StreamIpcCommunication* owner, const char* log_tag);
+  virtual ~IpcReactorProtocol();
+
+  StreamIpcCommunication* owner_;
+  IpcAdmissionControl admission_;
+  std::vector<std::unique_ptr<ProtocolConnection>> connections_; // 以句柄槽位为下标
+  int connection_count_ = 0;
+  int pending_handshakes_ = 0;             // 尚未收到kHello的连接数
+  quint64 closed_dropped_messages_ = 0;    // 已断开连接累计的丢弃数
+  quint64 closed_coalesced_messages_ = 0;  // 已断开连接累计的合并数
+  RelayRoute closed_relay_totals_;          // 已断开连接累计的转发计数
+  quint64 compact_heartbeats_ = 0;          // 在I/O线程应答的紧凑心跳帧
+  quint64 message_heartbeats_ = 0;          // 在I/O线程应答的kHeartbeat消息
+
+  /**
+   * @brief 登记已注册句柄的新连接，连接在收到kHello前计为未握手
+   */
+  void InsertConnection(std::unique_ptr<ProtocolConnection> connection);
+
+  /**
+   * @brief 从连接表取出连接并注销句柄，计数累计到已断开总数
+   * @return 连接已不在表中时返回nullptr
+   */
+  std::unique_ptr<ProtocolConnection> TakeConnection(ProtocolConnection* connection);
+
+  /**
+   * @brief 丢弃全部连接（不注销句柄、不通知主线程），用于关闭反应器
+   */
+  void ClearConnections();
+
+  ProtocolConnection* FindConnection(IpcClientHandle handle) const;
+
+  /**
+   * @brief 逐帧解码buffer中的数据：应答心跳、转发插件间消息，其余投递到主线程
+   * @return 握手完成前收到kHello以外的帧时返回false，调用方应断开该连接
+   */
+  bool DispatchFrames(ProtocolConnection* connection, IpcReceiveBuffer* buffer);
+
+  /**
+   * @brief 按连接的当前编码取帧并入队，kHelloAck在此附加协商结果
+   */
+  bool WriteMessage(ProtocolConnection* connection, EncodedFrames* frames);
+
+  /**
+   * @brief 帧进入连接的有界出站队列，随后由PumpConnection交给传输层
+   * @return 帧被丢弃时返回false
+   */
+  bool EnqueueFrame(ProtocolConnection* connection, const QByteArray& block,
+                    const IpcMessage& message);
+
+  /**
+   * @brief 断开超时未握手的连接
+   */
+  void ReapHandshakes();
+
+  void PostError(const QString& client_id, const QString& text);
+
+  /**
+   * @brief 统计中使用的连接名称：握手后为逻辑ID，之前为内部ID
+   */
+  QString DisplayName(const ProtocolConnection* connection) const;
+
+  QJsonObject RelayStatistics() const;
+  QJsonObject HeartbeatStatistics() const;
+
+  /**
+   * @brief 连接仍可写出（socket已连接、未处于关闭中）
+   */
+  virtual bool IsWritable(const ProtocolConnection* connection) const = 0;
+
+  /**
+   * @brief 已交给传输层、尚未真正写出的字节数，用于出站队列的水位判断
+   */
+  virtual qint64 InFlightBytes(const ProtocolConnection* connection) const = 0;
+
+  /**
+   * @brief 把出站队列中的帧交给传输层
+   */
+  virtual void PumpConnection(ProtocolConnection* connection) = 0;
+
+  /**
+   * @brief 因协议原因（握手超时等）主动断开连接
+   */
+  virtual void DropConnection(ProtocolConnection* connection, const QString& reason) = 0;
+
+  /**
+   * @brief 处理kHello中与传输相关的声明，默认忽略
+   */
+  virtual void NegotiateTransport(ProtocolConnection* connection, const IpcMessage& hello);
+
+  /**
+   * @brief 在kHelloAck中附加传输层的协商结果，默认不附加
+   */
+  virtual void PrepareHelloAck(ProtocolConnection* connection, IpcMessage* ack);
+
+private:
+  const char* log_tag_;
+
+  void CompleteHandshake(ProtocolConnection* connection);
+  void ReplyHeartbeat(ProtocolConnection* connection, const IpcFrameCodec::Heartbeat& heartbeat);
+  void NoteHeartbeat(ProtocolConnection* connection);
+  RelayRoute* ResolveRelayRoute(ProtocolConnection* source, const QString& receiver_id);
+  bool RelayFrame(ProtocolConnection* source, const IpcMessage& message,
+                  QByteArrayView frame);
+};
+
+/**
+ * @brief 流式IPC的I/O反应器，运行在独立线程
+ *
+ * 持有服务端和全部客户端socket，负责接受连接、读取数据并写出帧，
+ * 协议处理见IpcReactorProtocol。除listen/shutdown外不与其他线程共享任何状态。
+ */
+class StreamIpcReactor : public QObject, public IpcReactorProtocol {
+  Q_OBJECT
+
+public:
+  explicit StreamIpcReactor(StreamIpcCommunication* owner);
+  ~StreamIpcReactor() override;
+
+  bool listen(QString* error);
+  QString serverName() const;
+  void shutdown();
+  void drainOutbound();
+
+  /**
+   * @brief 汇总各连接出站队列的深度与丢弃计数（仅在I/O线程调用）
+   */
+  QJsonObject statistics() const;
+
+private slots:
+  void newConnection();
+  void socketDisconnected(QIODevice* socket);
+  void readyRead();
+  void socketError(QIODevice* socket, const QString& error_message);
+  void socketBytesWritten();
+  void reapHandshakes();
+
+private:
+  /**
+   * @brief 单个客户端连接的I/O状态（仅I/O线程访问）
+   */
+  struct Connection : ProtocolConnection {
+    explicit Connection(const IpcOutboundQueueConfig* config) : ProtocolConnection(config) {}
+
+    bool flush_pending = false;               // 已登记到dirty_connections_
+    std::unique_ptr<QIODevice> socket;
+
+    // 共享内存数据通道（握手时协商，socket此后主要承载门铃字节）
+    bool wants_shm = false;                   // 插件在kHello中声明支持shm
+    bool shm_active = false;                  // 出站数据已切换到共享内存环
+    std::unique_ptr<SharedMemoryChannel> shm;
+    IpcReceiveBuffer shm_receive_buffer{0};   // 从插件->主控环读出的数据
+    QByteArray shm_partial;                   // 环满时未写完的帧
+    qsizetype shm_partial_offset = 0;
+    bool shm_read_scheduled = false;          // 已安排下一轮读取共享内存环
+  };
+
+  std::unique_ptr<IpcStreamServer> server_;
+  QTimer* handshake_timer_ = nullptr;      // 定期回收超时未握手的连接
+  QHash<QIODevice*, Connection*> socket_index_;
+  std::vector<IpcClientHandle> dirty_connections_;  // 本轮drain中有待flush数据的连接
+  bool shutting_down_ = false;
+
+  Connection* FindConnection(QIODevice* socket) const;
+  Connection* FindConnection(IpcClientHandle handle) const;
+  void MarkDirty(Connection* connection);
+  void ReleaseConnection(Connection* connection);
+  void UpgradeToSharedMemory(Connection* connection, IpcMessage* ack);
+  void ServiceSharedMemory(Connection* connection);
+  void PumpSharedMemory(Connection* connection);
+  void RingDoorbell(Connection* connection);
+  void ScheduleDrop(Connection* connection, const QString& reason);
+  void FlushPendingWrites();
+
+  // IpcReactorProtocol
+  bool IsWritable(const ProtocolConnection* connection) const override;
+  qint64 InFlightBytes(const ProtocolConnection* connection) const override;
+  void PumpConnection(ProtocolConnection* connection) override;
+  void DropConnection(ProtocolConnection* connection, const QString& reason) override;
+  void NegotiateTransport(ProtocolConnection* connection, const IpcMessage& hello) override;
+  void PrepareHelloAck(ProtocolConnection* connection, IpcMessage* ack) override;
+};
+
+#endif // MASTER_SRC_STREAMIPCCOMMUNICATION_H_
@@ -0,0 +1,45 @@
+#include "TcpSocketIpcCommunication.h"
+#include <QDebug>
+
+TcpSocketIpcCommunication::TcpSocketIpcCommunication(QObject *parent)
+    : StreamIpcCommunication(parent) {}
+
+bool TcpSocketIpcCommunication::initialize(const QJsonObject &config) {
+  SetConnectionState(ConnectionState::kConnecting);
+
+  const QJsonObject tcp_socket = config["tcp_socket"].toObject();
+  options_ = TcpStreamServerOptions::fromJson(tcp_socket);
+  if (options_.port == 0) {
+    SetLastError("初始化失败: 配置中的 'port' 无效");
+    qWarning() << "[TcpSocketIpcCommunication] 初始化失败: 配置中的 'port' 无效";
+    SetConnectionState(ConnectionState::kError);
+    return false;
+  }
+
+  initializeStream(tcp_socket);
+
+  QStringList addresses;
+  for (const QHostAddress &address : std::as_const(options_.bind_addresses)) {
+    addresses.append(address.toString());
+  }
+  qDebug() << "[TcpSocketIpcCommunication] 初始化监听地址:" << addresses
+           << "端口:" << options_.port << "TCP_NODELAY:" << options_.no_delay
+           << "保活:" << options_.keepalive;
+  SetConnectionState(ConnectionState::kInitialized); // 已初始化但未启动
+  return true;
+}
+
+QJsonObject TcpSocketIpcCommunication::getEndpoint() const {
+  QJsonObject endpoint{{"transport", "tcp_socket"}, {"port", options_.port}};
+  // 监听所有网卡时主控无法确定客户端可达的地址，由客户端沿用当前主机
+  const QHostAddress address = options_.bind_addresses.value(0);
+  if (!address.isNull() && address != QHostAddress::Any &&
+      address != QHostAddress::AnyIPv4 && address != QHostAddress::AnyIPv6) {
+    endpoint["host"] = address.toString();
+  }
+  return endpoint;
+}
+
+std::unique_ptr<IpcStreamServer> TcpSocketIpcCommunication::createServer() const {
+  return std::make_unique<TcpStreamServer>(options_);
+}
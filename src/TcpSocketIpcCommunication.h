@@ -0,0 +1,36 @@
+#ifndef MASTER_SRC_TCPSOCKETIPCCOMMUNICATION_H_
+#define MASTER_SRC_TCPSOCKETIPCCOMMUNICATION_H_
+
+#include "StreamIpcCommunication.h"
+
+/**
+ * @brief 基于QTcpSocket的IPC通信实现，供部署在其他主机上的插件接入
+ *
+ * 帧格式、握手、ID映射、Topic与心跳语义与LocalSocketIpcCommunication完全一致，
+ * 仅传输换成TCP。
+ *
+ * 配置取自 ipc.tcp_socket：
+ * - bind_addresses: 绑定地址列表（默认 ["127.0.0.1"]，"any" 表示所有网卡）
+ * - port: 监听端口（默认27500）
+ * - no_delay: 是否启用TCP_NODELAY（默认true）
+ * - keepalive / keepalive_idle_seconds / keepalive_interval_seconds / keepalive_count: TCP保活
+ * - outbound_high_water_bytes / outbound_low_water_bytes / topic_policies: 出站队列
+ */
+class TcpSocketIpcCommunication : public StreamIpcCommunication {
+  Q_OBJECT
+
+public:
+  explicit TcpSocketIpcCommunication(QObject* parent = nullptr);
+  ~TcpSocketIpcCommunication() override = default;
+
+  bool initialize(const QJsonObject& config) override;
+  QJsonObject getEndpoint() const override;
+
+protected:
+  std::unique_ptr<IpcStreamServer> createServer() const override;
+
+private:
+  TcpStreamServerOptions options_;
+};
+
+#endif // MASTER_SRC_TCPSOCKETIPCCOMMUNICATION_H_
@@ -0,0 +1,85 @@
+#include "TimerWheel.h"
+#include <algorithm>
+
+TimerWheel::TimerWheel(int tick_ms, int slot_count, QObject* parent)
+    : QObject(parent),
+      tick_ms_(std::max(1, tick_ms)),
+      slots_(static_cast<size_t>(std::max(1, slot_count)))
+{
+    ticker_.setTimerType(Qt::PreciseTimer);
+    ticker_.setInterval(tick_ms_);
+    connect(&ticker_, &QTimer::timeout, this, &TimerWheel::onTick);
+    clock_.start();
+}
+
+TimerWheel::TimerId TimerWheel::schedule(qint64 delay_ms, std::function<void()> callback)
+{
+    if (index_.empty()) {
+        // 空闲期间不推进tick，重新启动时直接对齐当前时间，避免补跑空槽
+        current_tick_ = ElapsedTicks();
+    }
+
+    // 事件循环阻塞时current_tick_落后于实际时间，按实际时间计算避免提前到期
+    const quint64 ticks = std::max<qint64>(1, (delay_ms + tick_ms_ - 1) / tick_ms_);
+    const quint64 expire_tick = std::max(current_tick_, ElapsedTicks()) + ticks;
+    const size_t slot_index = static_cast<size_t>(expire_tick % slots_.size());
+
+    const TimerId id = next_id_++;
+    Slot& slot = slots_[slot_index];
+    slot.push_back(Entry{id, expire_tick, std::move(callback)});
+    index_.emplace(id, std::make_pair(slot_index, std::prev(slot.end())));
+
+    if (!ticker_.isActive()) {
+        ticker_.start();
+    }
+    return id;
+}
+
+bool TimerWheel::cancel(TimerId id)
+{
+    auto it = index_.find(id);
+    if (it == index_.end()) {
+        return false;
+    }
+    slots_[it->second.first].erase(it->second.second);
+    index_.erase(it);
+    if (index_.empty()) {
+        ticker_.stop();
+    }
+    return true;
+}
+
+void TimerWheel::onTick()
+{
+    // 事件循环繁忙时一次补齐所有错过的tick
+    const quint64 target_tick = ElapsedTicks();
+    std::vector<std::function<void()>> expired;
+    while (current_tick_ < target_tick && !index_.empty()) {
+        ++current_tick_;
+        Slot& slot = slots_[static_cast<size_t>(current_tick_ % slots_.size())];
+        for (auto it = slot.begin(); it != slot.end();) {
+            if (it->expire_tick <= current_tick_) {
+                expired.push_back(std::move(it->callback));
+                index_.erase(it->id);
+                it = slot.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    current_tick_ = std::max(current_tick_, target_tick);
+
+    if (index_.empty()) {
+        ticker_.stop();
+    }
+
+    // 回调可能再次添加或取消定时，统一在遍历结束后执行
+    for (auto& callback : expired) {
+        callback();
+    }
+}
+
+quint64 TimerWheel::ElapsedTicks() const
+{
+    return static_cast<quint64>(clock_.elapsed() / tick_ms_);
+}
@@ -0,0 +1,73 @@
+#ifndef MASTER_SRC_TIMERWHEEL_H_
+#define MASTER_SRC_TIMERWHEEL_H_
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 哈希时间轮
+ *
+ * 大量短期定时（请求超时等）共享一个QTimer：定时按到期tick散列到固定数量
+ * 的槽中，每个tick只检查一个槽，添加与取消都是O(1)。超过一圈的定时记录
+ * 到期tick，在经过所属槽时比较后跳过。没有待处理定时时QTimer停止。
+ *
+ * 非线程安全，只能在所属线程使用；回调在该线程的事件循环中执行。
+ */
+class TimerWheel : public QObject {
+    Q_OBJECT
+
+public:
+    using TimerId = quint64;
+
+    /**
+     * @brief 构造函数
+     * @param tick_ms 时间轮精度（毫秒）
+     * @param slot_count 槽数量，一圈覆盖 tick_ms * slot_count 毫秒
+     * @param parent 父对象
+     */
+    explicit TimerWheel(int tick_ms = 10, int slot_count = 512, QObject* parent = nullptr);
+
+    /**
+     * @brief 添加定时
+     * @param delay_ms 延迟（毫秒），向上取整到tick
+     * @param callback 到期回调
+     * @return 定时ID，用于取消
+     */
+    TimerId schedule(qint64 delay_ms, std::function<void()> callback);
+
+    /**
+     * @brief 取消定时
+     * @return 定时存在且尚未触发时返回true
+     */
+    bool cancel(TimerId id);
+
+    int pendingCount() const { return static_cast<int>(index_.size()); }
+
+private slots:
+    void onTick();
+
+private:
+    struct Entry {
+        TimerId id;
+        quint64 expire_tick;
+        std::function<void()> callback;
+    };
+    using Slot = std::list<Entry>;
+
+    const int tick_ms_;
+    std::vector<Slot> slots_;
+    std::unordered_map<TimerId, std::pair<size_t, Slot::iterator>> index_;
+    QTimer ticker_;
+    QElapsedTimer clock_;
+    quint64 current_tick_ = 0;   // 已处理到的tick
+    TimerId next_id_ = 1;
+
+    quint64 ElapsedTicks() const;
+};
+
+#endif // MASTER_SRC_TIMERWHEEL_H_
@@ -0,0 +1,155 @@
+#include "TopicTrie.h"
+
+namespace {
+
+const QString kSingleLevelWildcard = QStringLiteral("*");
+const QString kMultiLevelWildcard = QStringLiteral("#");
+
+}  // namespace
+
+TopicTrie::TopicTrie() : root_(std::make_unique<Node>()) {}
+
+TopicTrie::~TopicTrie() = default;
+
+bool TopicTrie::isValidPattern(const QString& pattern)
+{
+    if (pattern.isEmpty()) {
+        return false;
+    }
+    const QStringList segments = pattern.split(QLatin1Char('.'));
+    for (int i = 0; i < segments.size(); ++i) {
+        const QString& segment = segments.at(i);
+        if (segment.isEmpty()) {
+            return false;
+        }
+        if (segment == kMultiLevelWildcard) {
+            if (i != segments.size() - 1) {
+                return false;
+            }
+            continue;
+        }
+        if (segment != kSingleLevelWildcard &&
+            (segment.contains(QLatin1Char('*')) || segment.contains(QLatin1Char('#')))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TopicTrie::subscribe(const QString& pattern, Subscriber subscriber)
+{
+    if (subscriber == 0 || !isValidPattern(pattern)) {
+        return false;
+    }
+
+    QSet<QString>& subscriptions = subscriptions_by_subscriber_[subscriber];
+    if (subscriptions.contains(pattern)) {
+        return false;
+    }
+
+    Node* node = root_.get();
+    for (const QString& segment : pattern.split(QLatin1Char('.'))) {
+        std::unique_ptr<Node>& child = node->children[segment];
+        if (!child) {
+            child = std::make_unique<Node>();
+        }
+        node = child.get();
+    }
+    node->subscribers.insert(subscriber);
+
+    subscriptions.insert(pattern);
+    ++pattern_counts_[pattern];
+    return true;
+}
+
+bool TopicTrie::unsubscribe(const QString& pattern, Subscriber subscriber)
+{
+    auto it = subscriptions_by_subscriber_.find(subscriber);
+    if (it == subscriptions_by_subscriber_.end() || !it.value().remove(pattern)) {
+        return false;
+    }
+    if (it.value().isEmpty()) {
+        subscriptions_by_subscriber_.erase(it);
+    }
+
+    removeFromNode(root_.get(), pattern.split(QLatin1Char('.')), 0, subscriber);
+
+    auto count = pattern_counts_.find(pattern);
+    if (count != pattern_counts_.end() && --count.value() <= 0) {
+        pattern_counts_.erase(count);
+    }
+    return true;
+}
+
+int TopicTrie::removeSubscriber(Subscriber subscriber)
+{
+    const QSet<QString> subscriptions = subscriptions_by_subscriber_.take(subscriber);
+    for (const QString& pattern : subscriptions) {
+        removeFromNode(root_.get(), pattern.split(QLatin1Char('.')), 0, subscriber);
+        auto count = pattern_counts_.find(pattern);
+        if (count != pattern_counts_.end() && --count.value() <= 0) {
+            pattern_counts_.erase(count);
+        }
+    }
+    return static_cast<int>(subscriptions.size());
+}
+
+QList<TopicTrie::Subscriber> TopicTrie::match(const QString& topic) const
+{
+    if (topic.isEmpty() || subscriptions_by_subscriber_.isEmpty()) {
+        return QList<Subscriber>();
+    }
+    QSet<Subscriber> result;
+    collect(root_.get(), topic.split(QLatin1Char('.')), 0, &result);
+    return result.values();
+}
+
+void TopicTrie::clear()
+{
+    root_ = std::make_unique<Node>();
+    subscriptions_by_subscriber_.clear();
+    pattern_counts_.clear();
+}
+
+void TopicTrie::collect(const Node* node, const QStringList& segments, int index,
+                        QSet<Subscriber>* result) const
+{
+    // '#' 匹配剩余的零个或多个段
+    auto multi = node->children.find(kMultiLevelWildcard);
+    if (multi != node->children.end()) {
+        result->unite(multi->second->subscribers);
+    }
+
+    if (index == segments.size()) {
+        result->unite(node->subscribers);
+        return;
+    }
+
+    auto exact = node->children.find(segments.at(index));
+    if (exact != node->children.end()) {
+        collect(exact->second.get(), segments, index + 1, result);
+    }
+    auto single = node->children.find(kSingleLevelWildcard);
+    if (single != node->children.end()) {
+        collect(single->second.get(), segments, index + 1, result);
+    }
+}
+
+bool TopicTrie::removeFromNode(Node* node, const QStringList& segments, int index,
+                               Subscriber subscriber)
+{
+    if (index == segments.size()) {
+        node->subscribers.remove(subscriber);
+        return node->isEmpty();
+    }
+
+    auto it = node->children.find(segments.at(index));
+    if (it == node->children.end()) {
+        return false;
+    }
+    // 沿路径回溯时剪掉空节点，避免树随动态Topic无限增长
+    if (removeFromNode(it->second.get(), segments, index + 1, subscriber)) {
+        node->children.erase(it);
+    }
+    return node != root_.get() && node->isEmpty();
+}
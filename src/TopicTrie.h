@@ -0,0 +1,100 @@
+#ifndef MASTER_SRC_TOPICTRIE_H_
+#define MASTER_SRC_TOPICTRIE_H_
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include <unordered_map>
+
+/**
+ * @brief 分层Topic订阅树
+ *
+ * Topic以 '.' 分段，订阅模式支持两种通配段：
+ *   - '*' 匹配恰好一段，如 device.*.status 匹配 device.agv1.status；
+ *   - '#' 只能作为最后一段，匹配零个或多个段，如 device.# 匹配 device
+ *     和 device.agv1.status。
+ *
+ * 订阅者以整数句柄标识（见 IpcClientHandle），匹配结果可直接用于路由。
+ * 同时维护订阅者到订阅模式的反向索引：发布的代价与匹配到的订阅者数量
+ * 成正比，订阅者断开时只需遍历它自己的订阅。
+ *
+ * 非线程安全，由调用方加锁。
+ */
+class TopicTrie {
+public:
+    using Subscriber = quint32;
+
+    TopicTrie();
+    ~TopicTrie();
+
+    TopicTrie(const TopicTrie&) = delete;
+    TopicTrie& operator=(const TopicTrie&) = delete;
+
+    /**
+     * @brief 检查订阅模式是否合法（非空段、通配符独占一段、'#'只在末尾）
+     */
+    static bool isValidPattern(const QString& pattern);
+
+    /**
+     * @brief 添加订阅
+     * @param pattern 订阅模式，可含通配段
+     * @param subscriber 订阅者句柄，0无效
+     * @return 新增订阅返回true；模式非法或已订阅返回false
+     */
+    bool subscribe(const QString& pattern, Subscriber subscriber);
+
+    /**
+     * @brief 取消订阅
+     * @return 订阅存在并被移除时返回true
+     */
+    bool unsubscribe(const QString& pattern, Subscriber subscriber);
+
+    /**
+     * @brief 移除订阅者的全部订阅
+     * @return 被移除的订阅数量
+     */
+    int removeSubscriber(Subscriber subscriber);
+
+    /**
+     * @brief 查找订阅了指定Topic的全部订阅者（去重）
+     * @param topic 具体Topic名称（不含通配符）
+     */
+    QList<Subscriber> match(const QString& topic) const;
+
+    /**
+     * @brief 当前至少有一个订阅者的全部订阅模式
+     */
+    QStringList patterns() const { return pattern_counts_.keys(); }
+
+    /**
+     * @brief 订阅者当前的订阅模式
+     */
+    QStringList subscriptionsOf(Subscriber subscriber) const
+    {
+        return subscriptions_by_subscriber_.value(subscriber).values();
+    }
+
+    void clear();
+
+private:
+    struct Node {
+        std::unordered_map<QString, std::unique_ptr<Node>> children;
+        QSet<Subscriber> subscribers;
+
+        bool isEmpty() const { return children.empty() && subscribers.isEmpty(); }
+    };
+
+    void collect(const Node* node, const QStringList& segments, int index,
+                 QSet<Subscriber>* result) const;
+    bool removeFromNode(Node* node, const QStringList& segments, int index,
+                        Subscriber subscriber);
+
+    std::unique_ptr<Node> root_;
+    QHash<Subscriber, QSet<QString>> subscriptions_by_subscriber_;  // 订阅者 -> 订阅模式
+    QHash<QString, int> pattern_counts_;                            // 订阅模式 -> 订阅者数量
+};
+
+#endif  // MASTER_SRC_TOPICTRIE_H_
@@ -138,7 +138,26 @@ int main(int argc, char *argv[]) {
   }
   qDebug() << "QML界面加载成功";
 
-  // 连接应用程序退出信号到MainController的停止子进程槽函数
+  // 关闭窗口时先异步停止子进程，全部退出后再退出应用，期间界面保持响应。
+  // 只有关闭窗口发起的停止才退出应用，QML调用Stop/Restart不受影响
+  app.setQuitOnLastWindowClosed(false);
+  bool quit_after_shutdown = false;
+  QObject::connect(&app, &QApplication::lastWindowClosed, &mainController,
+                   [&mainController, &quit_after_shutdown]() {
+                     quit_after_shutdown = true;
+                     mainController.BeginShutdown();
+                   });
+  QObject::connect(
+      &mainController, &MainController::ShutdownFinished, &app,
+      [&quit_after_shutdown]() {
+        if (quit_after_shutdown) {
+          QCoreApplication::quit();
+        }
+      },
+      Qt::QueuedConnection);
+  qDebug() << "窗口关闭信号已连接到MainController::BeginShutdown";
+
+  // 其他途径退出时（如系统注销）由Stop兜底，已停止时直接返回
   QObject::connect(&app, &QApplication::aboutToQuit, &mainController,
                    [&mainController]() { mainController.Stop(); });
   qDebug() << "应用程序退出信号已连接到MainController::Stop";